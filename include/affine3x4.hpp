@@ -0,0 +1,166 @@
+#pragma once
+#include "aabb.hpp"
+#include "mat4.hpp"
+
+namespace vml
+{
+namespace detail
+{
+struct affine3x4_traits
+{
+  using type        = types::affine3x4_t<float>;
+  using ref         = type&;
+  using pref        = type const&;
+  using cref        = type const&;
+  using row_type    = types::vec4_t<float>;
+  using row_tag     = vec4;
+  using scalar_type = float;
+
+  static constexpr std::uint32_t element_count = 12;
+  static constexpr std::uint32_t row_count     = 3;
+  static constexpr std::uint32_t column_count  = 4;
+};
+} // namespace detail
+
+/**
+ * @remarks Affine transform (rotation, scale incl. non uniform, translation) in 48 bytes instead of
+ * the 64 of a mat4. Row i holds column i of the equivalent mat4: the i-th component of the x, y and
+ * z axes followed by the i-th component of the translation. The dropped 4th column is always
+ * 0, 0, 0, 1, so conversion to and from mat4 is lossless for affine matrices. Composition order is
+ * the same as mat4, mul(m1, m2) applies m1 first.
+ */
+struct affine3x4 : public multi_dim<detail::affine3x4_traits>
+{
+  using typename multi_dim<detail::affine3x4_traits>::type;
+  using typename multi_dim<detail::affine3x4_traits>::pref;
+  using typename multi_dim<detail::affine3x4_traits>::ref;
+  using typename multi_dim<detail::affine3x4_traits>::scalar_type;
+  using multi_dim<detail::affine3x4_traits>::mul;
+
+  static inline type identity();
+  //! @brief Convert an affine mat4, its last column must be 0, 0, 0, 1
+  static inline type   from_mat4(mat4::pref m);
+  static inline mat4_t to_mat4(pref m);
+  //! @brief Same as mat4::mul, m1 is applied first
+  static inline type mul(pref m1, pref m2);
+  static inline type inverse(pref m);
+  //! @brief Transform a point, translation is applied, w of the result is 0
+  static inline vec3a_t transform_point(pref m, vec3a::pref v);
+  //! @brief Transform a direction, translation is not applied, w of the result is 0
+  static inline vec3a_t transform_vector(pref m, vec3a::pref v);
+  //! @brief Special transform for AABB bound extends.
+  static inline vec3a_t transform_bounds_extends(pref m, vec3a::pref extends);
+  //! @brief Special transform for AABB min and max
+  static inline aabb_t  transform_aabb(pref m, aabb::pref v);
+  static inline vec3a_t translation(pref m);
+
+private:
+  //! dot(m.r[i], v) for each row in x, y, z, w is 0
+  static inline quad_t dot_rows(quad::pref r0, quad::pref r1, quad::pref r2, quad::pref v);
+};
+
+inline affine3x4::type affine3x4::identity()
+{
+  return {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0};
+}
+
+inline affine3x4::type affine3x4::from_mat4(mat4::pref m)
+{
+  quad_t r0 = m.r[0], r1 = m.r[1], r2 = m.r[2], r3 = m.r[3];
+  quad::transpose(r0, r1, r2, r3);
+  type ret;
+  ret.r[0] = r0;
+  ret.r[1] = r1;
+  ret.r[2] = r2;
+  return ret;
+}
+
+inline mat4_t affine3x4::to_mat4(pref m)
+{
+  mat4_t ret;
+  ret.r[0] = m.r[0];
+  ret.r[1] = m.r[1];
+  ret.r[2] = m.r[2];
+  ret.r[3] = quad::set(0.0f, 0.0f, 0.0f, 1.0f);
+  quad::transpose(ret.r[0], ret.r[1], ret.r[2], ret.r[3]);
+  return ret;
+}
+
+inline affine3x4::type affine3x4::mul(pref m1, pref m2)
+{
+  // Row i of the result is column i of m1 * m2, the mat4 product with both 4th columns fixed at
+  // 0, 0, 0, 1 reduces to 3 rows of 3 madds plus the translation
+  quad_t const w_axis = quad::set(0.0f, 0.0f, 0.0f, 1.0f);
+  type         ret;
+  for (std::uint32_t i = 0; i < 3; ++i)
+  {
+    quad_t v = quad::mul(quad::splat_w(m2.r[i]), w_axis);
+    v        = quad::madd(quad::splat_x(m2.r[i]), m1.r[0], v);
+    v        = quad::madd(quad::splat_y(m2.r[i]), m1.r[1], v);
+    ret.r[i] = quad::madd(quad::splat_z(m2.r[i]), m1.r[2], v);
+  }
+  return ret;
+}
+
+inline affine3x4::type affine3x4::inverse(pref m)
+{
+  // The rows hold the transposed 3x3 A' and translation t, the inverse rows hold inv(A') and
+  // -inv(A') * t. The columns of inv(A') are the cross products of the rows of A' divided by det(A')
+  quad_t      c0   = vec3a::cross(m.r[1], m.r[2]);
+  scalar_type rdet = 1.0f / vec3a::dot(m.r[0], c0);
+  c0               = quad::mul(c0, rdet);
+  quad_t c1        = quad::mul(vec3a::cross(m.r[2], m.r[0]), rdet);
+  quad_t c2        = quad::mul(vec3a::cross(m.r[0], m.r[1]), rdet);
+  quad_t t         = quad::mul(quad::splat_w(m.r[0]), c0);
+  t                = quad::madd(quad::splat_w(m.r[1]), c1, t);
+  t                = quad::madd(quad::splat_w(m.r[2]), c2, t);
+  t                = quad::negate(t);
+  quad::transpose(c0, c1, c2, t);
+  type ret;
+  ret.r[0] = c0;
+  ret.r[1] = c1;
+  ret.r[2] = c2;
+  return ret;
+}
+
+inline quad_t affine3x4::dot_rows(quad::pref r0, quad::pref r1, quad::pref r2, quad::pref v)
+{
+  quad_t x = quad::mul(r0, v);
+  quad_t y = quad::mul(r1, v);
+  quad_t z = quad::mul(r2, v);
+  quad_t w = quad::zero();
+  quad::transpose(x, y, z, w);
+  return quad::add(quad::add(x, y), quad::add(z, w));
+}
+
+inline vec3a_t affine3x4::transform_point(pref m, vec3a::pref v)
+{
+  return dot_rows(m.r[0], m.r[1], m.r[2], quad::set_w(v, 1.0f));
+}
+
+inline vec3a_t affine3x4::transform_vector(pref m, vec3a::pref v)
+{
+  return dot_rows(m.r[0], m.r[1], m.r[2], quad::set_w(v, 0.0f));
+}
+
+inline vec3a_t affine3x4::transform_bounds_extends(pref m, vec3a::pref extends)
+{
+  return dot_rows(quad::abs(m.r[0]), quad::abs(m.r[1]), quad::abs(m.r[2]), quad::set_w(extends, 0.0f));
+}
+
+inline aabb_t affine3x4::transform_aabb(pref m, aabb::pref v)
+{
+  quad_t center  = transform_point(m, quad::mul(quad::add(v.r[0], v.r[1]), 0.5f));
+  quad_t extends = transform_bounds_extends(m, quad::mul(quad::sub(v.r[1], v.r[0]), 0.5f));
+  aabb_t ret;
+  ret.r[0] = quad::sub(center, extends);
+  ret.r[1] = quad::add(center, extends);
+  return ret;
+}
+
+inline vec3a_t affine3x4::translation(pref m)
+{
+  return quad::set(m.e[0][3], m.e[1][3], m.e[2][3]);
+}
+
+} // namespace vml
@@ -54,6 +54,18 @@ struct bounding_volume_t
   vec4_t orig_half_extends;
 };
 
+//! Sphere and AABB sharing the sphere center, one half of a bounding_volume_t. Split layout:
+//! the world volumes (spherical_vol, half_extends) in a hot array read by culling and the
+//! original volumes (orig_*) in a cold array only read by update, so a cache line holds twice
+//! as many volumes during culling
+struct sphere_box_t
+{
+  sphere_t spherical_vol;
+  vec3a_t  half_extends;
+};
+
+static_assert(sizeof(sphere_box_t) * 2 == sizeof(bounding_volume_t), "Fix size");
+
 struct bounding_volume
 {
   using type = bounding_volume_t;
@@ -83,6 +95,22 @@ struct bounding_volume
   //! Given a transform, rotation and translation, update the bounding volume
   //! using the original extends and radius
   inline static void update(bounding_volume_t& _, transform_t const& tf);
+  //! Batched update, io_volumes[i] is updated with m[i]
+  inline static void update(std::span<bounding_volume_t> io_volumes, std::span<mat4_t const> m);
+  //! Batched update, io_volumes[i] is updated with tf[i]
+  inline static void update(std::span<bounding_volume_t> io_volumes, std::span<transform_t const> tf);
+  //! Batched update with the original volumes in their own array, o_world[i] is local[i] moved by m[i]
+  inline static void update(std::span<sphere_box_t> o_world, std::span<sphere_box_t const> local,
+                            std::span<mat4_t const> m);
+  //! Batched update with the original volumes in their own array, o_world[i] is local[i] moved by tf[i]
+  inline static void update(std::span<sphere_box_t> o_world, std::span<sphere_box_t const> local,
+                            std::span<transform_t const> tf);
+  //! Split volumes into the world (hot) and original (cold) halves
+  inline static void split(std::span<bounding_volume_t const> vols, std::span<sphere_box_t> o_world,
+                           std::span<sphere_box_t> o_local);
+  //! Inverse of split
+  inline static void join(std::span<sphere_box_t const> world, std::span<sphere_box_t const> local,
+                          std::span<bounding_volume_t> o_vols);
   //! Compute the bounding volume from a set of points
   inline static void update(bounding_volume_t& _, vec3a_t const* points, std::uint32_t count);
   //! Compute the bounding volume by appending another bounding volume to it
@@ -154,7 +182,7 @@ inline void bounding_volume::update(bounding_volume_t& _, float scale, quat::pre
 
   _.spherical_vol = sphere::scale_radius(
     sphere::set(vec3a::add(quat::transform(rot, sphere::center(_.orig_spherical_vol)), translation),
-                sphere::radius(_.spherical_vol)),
+                sphere::radius(_.orig_spherical_vol)),
     scale);
   _.half_extends = quat::transform_bounds_extends(rot, vec3a::mul(_.orig_half_extends, scale));
 }
@@ -164,6 +192,213 @@ inline void bounding_volume::update(bounding_volume_t& _, transform_t const& tf)
   update(_, transform::scale(tf), transform::rotation(tf), transform::translation(tf));
 }
 
+namespace detail
+{
+//! Move lane::element_count original volumes, given as sphere and half extends quads, by their
+//! matrices. Same math as bounding_volume::update(bv, mat4) per lane
+template <typename lane>
+inline void update_volumes(quad_t const* sphere, quad_t const* extends, mat4_t const* m, quad_t* o_sphere,
+                           quad_t* o_extends)
+{
+  using lane_type = typename lane::type;
+  using mat4xn    = vml::mat4xn<lane>;
+  using vec3xn    = vml::vec3xn<lane>;
+
+  lane_type s[4];
+  lane_type e[4];
+  lanes_from_quads<lane>(sphere, s);
+  lanes_from_quads<lane>(extends, e);
+  typename mat4xn::type mm = mat4xn::load(m);
+  typename vec3xn::type c  = mat4xn::transform_assume_ortho(mm, vec3xn::set(s[0], s[1], s[2]));
+
+  lane_type sq[3];
+  for (std::uint32_t r = 0; r < 3; ++r)
+    sq[r] = lane::madd(mm.e[r][0], mm.e[r][0],
+                       lane::madd(mm.e[r][1], mm.e[r][1],
+                                  lane::madd(mm.e[r][2], mm.e[r][2], lane::mul(mm.e[r][3], mm.e[r][3]))));
+  lane_type const ws[4] = {c.x, c.y, c.z, lane::mul(s[3], lane::sqrt(lane::max(lane::max(sq[0], sq[1]), sq[2])))};
+
+  lane_type we[4];
+  for (std::uint32_t i = 0; i < 3; ++i)
+    we[i] = lane::add(lane::add(lane::abs(lane::mul(e[0], mm.e[0][i])), lane::abs(lane::mul(e[1], mm.e[1][i]))),
+                      lane::abs(lane::mul(e[2], mm.e[2][i])));
+  we[3] = lane::zero();
+  lanes_to_quads<lane>(ws, o_sphere);
+  lanes_to_quads<lane>(we, o_extends);
+}
+
+//! Same as update_volumes for scale, rotation, translation transforms. The absolute rotation
+//! matrix is built per lane instead of the shuffles of quat::transform_bounds_extends
+template <typename lane>
+inline void update_volumes(quad_t const* sphere, quad_t const* extends, transform_t const* tf, quad_t* o_sphere,
+                           quad_t* o_extends)
+{
+  using lane_type = typename lane::type;
+  using quatxn    = vml::quatxn<lane>;
+  using vec3xn    = vml::vec3xn<lane>;
+
+  quat_t rot[lane::element_count];
+  quad_t ts[lane::element_count];
+  for (std::uint32_t k = 0; k < lane::element_count; ++k)
+  {
+    rot[k] = tf[k].rotation;
+    ts[k]  = tf[k].translation_and_scale;
+  }
+  lane_type s[4];
+  lane_type e[4];
+  lane_type t[4];
+  lanes_from_quads<lane>(sphere, s);
+  lanes_from_quads<lane>(extends, e);
+  lanes_from_quads<lane>(ts, t);
+  typename quatxn::type q = quatxn::load(rot);
+  typename vec3xn::type c = quatxn::transform(q, vec3xn::set(s[0], s[1], s[2]));
+
+  lane_type const ws[4] = {lane::add(c.x, t[0]), lane::add(c.y, t[1]), lane::add(c.z, t[2]), lane::mul(s[3], t[3])};
+
+  lane_type const one = lane::set(1.0f);
+  lane_type const x2  = lane::add(q.x, q.x);
+  lane_type const y2  = lane::add(q.y, q.y);
+  lane_type const z2  = lane::add(q.z, q.z);
+  lane_type const xx  = lane::mul(q.x, x2);
+  lane_type const yy  = lane::mul(q.y, y2);
+  lane_type const zz  = lane::mul(q.z, z2);
+  lane_type const xy  = lane::mul(q.x, y2);
+  lane_type const xz  = lane::mul(q.x, z2);
+  lane_type const yz  = lane::mul(q.y, z2);
+  lane_type const wx  = lane::mul(q.w, x2);
+  lane_type const wy  = lane::mul(q.w, y2);
+  lane_type const wz  = lane::mul(q.w, z2);
+  // Row j of the rotation matrix scales extends component j
+  lane_type const r[3][3] = {
+    {lane::sub(one, lane::add(yy, zz)), lane::add(xy, wz), lane::sub(xz, wy)},
+    {lane::sub(xy, wz), lane::sub(one, lane::add(xx, zz)), lane::add(yz, wx)},
+    {lane::add(xz, wy), lane::sub(yz, wx), lane::sub(one, lane::add(xx, yy))},
+  };
+  lane_type const se[3] = {lane::mul(e[0], t[3]), lane::mul(e[1], t[3]), lane::mul(e[2], t[3])};
+
+  lane_type we[4];
+  for (std::uint32_t i = 0; i < 3; ++i)
+    we[i] = lane::add(lane::add(lane::abs(lane::mul(se[0], r[0][i])), lane::abs(lane::mul(se[1], r[1][i]))),
+                      lane::abs(lane::mul(se[2], r[2][i])));
+  we[3] = lane::zero();
+  lanes_to_quads<lane>(ws, o_sphere);
+  lanes_to_quads<lane>(we, o_extends);
+}
+
+//! Run update_volumes over count volumes element_count at a time, the remainder through the
+//! single update. get_local(i) returns the original volume i as a sphere_box_t and
+//! set_world(i, sphere, extends) stores the moved one
+template <typename lane = stream_lane, typename xform_t, typename get_fn, typename set_fn>
+inline void update_volumes(std::size_t count, xform_t const* xf, get_fn&& get_local, set_fn&& set_world)
+{
+  std::size_t i = 0;
+  for (; i + lane::element_count <= count; i += lane::element_count)
+  {
+    quad_t sphere[lane::element_count];
+    quad_t extends[lane::element_count];
+    for (std::uint32_t k = 0; k < lane::element_count; ++k)
+    {
+      sphere_box_t const l = get_local(i + k);
+      sphere[k]            = l.spherical_vol;
+      extends[k]           = l.half_extends;
+    }
+    update_volumes<lane>(sphere, extends, xf + i, sphere, extends);
+    for (std::uint32_t k = 0; k < lane::element_count; ++k)
+      set_world(i + k, sphere[k], extends[k]);
+  }
+  for (; i < count; ++i)
+  {
+    sphere_box_t const l  = get_local(i);
+    bounding_volume_t  bv = bounding_volume::set(l.spherical_vol, l.half_extends);
+    bounding_volume::update(bv, xf[i]);
+    set_world(i, bv.spherical_vol, bv.half_extends);
+  }
+}
+} // namespace detail
+
+inline void bounding_volume::update(std::span<bounding_volume_t> io_volumes, std::span<mat4_t const> m)
+{
+  assert(m.size() == io_volumes.size());
+  detail::update_volumes(
+    io_volumes.size(), m.data(),
+    [io_volumes](std::size_t i)
+    {
+      return sphere_box_t{io_volumes[i].orig_spherical_vol, io_volumes[i].orig_half_extends};
+    },
+    [io_volumes](std::size_t i, quad::pref sphere, quad::pref extends)
+    {
+      io_volumes[i].spherical_vol = sphere;
+      io_volumes[i].half_extends  = extends;
+    });
+}
+
+inline void bounding_volume::update(std::span<bounding_volume_t> io_volumes, std::span<transform_t const> tf)
+{
+  assert(tf.size() == io_volumes.size());
+  detail::update_volumes(
+    io_volumes.size(), tf.data(),
+    [io_volumes](std::size_t i)
+    {
+      return sphere_box_t{io_volumes[i].orig_spherical_vol, io_volumes[i].orig_half_extends};
+    },
+    [io_volumes](std::size_t i, quad::pref sphere, quad::pref extends)
+    {
+      io_volumes[i].spherical_vol = sphere;
+      io_volumes[i].half_extends  = extends;
+    });
+}
+
+inline void bounding_volume::update(std::span<sphere_box_t> o_world, std::span<sphere_box_t const> local,
+                                    std::span<mat4_t const> m)
+{
+  assert(m.size() == local.size() && o_world.size() >= local.size());
+  detail::update_volumes(
+    local.size(), m.data(),
+    [local](std::size_t i)
+    {
+      return local[i];
+    },
+    [o_world](std::size_t i, quad::pref sphere, quad::pref extends)
+    {
+      o_world[i] = {sphere, extends};
+    });
+}
+
+inline void bounding_volume::update(std::span<sphere_box_t> o_world, std::span<sphere_box_t const> local,
+                                    std::span<transform_t const> tf)
+{
+  assert(tf.size() == local.size() && o_world.size() >= local.size());
+  detail::update_volumes(
+    local.size(), tf.data(),
+    [local](std::size_t i)
+    {
+      return local[i];
+    },
+    [o_world](std::size_t i, quad::pref sphere, quad::pref extends)
+    {
+      o_world[i] = {sphere, extends};
+    });
+}
+
+inline void bounding_volume::split(std::span<bounding_volume_t const> vols, std::span<sphere_box_t> o_world,
+                                   std::span<sphere_box_t> o_local)
+{
+  assert(o_world.size() >= vols.size() && o_local.size() >= vols.size());
+  for (std::size_t i = 0, end = vols.size(); i < end; ++i)
+  {
+    o_world[i] = {vols[i].spherical_vol, vols[i].half_extends};
+    o_local[i] = {vols[i].orig_spherical_vol, vols[i].orig_half_extends};
+  }
+}
+
+inline void bounding_volume::join(std::span<sphere_box_t const> world, std::span<sphere_box_t const> local,
+                                  std::span<bounding_volume_t> o_vols)
+{
+  assert(local.size() == world.size() && o_vols.size() >= world.size());
+  for (std::size_t i = 0, end = world.size(); i < end; ++i)
+    o_vols[i] = {world[i].spherical_vol, world[i].half_extends, local[i].spherical_vol, local[i].half_extends};
+}
+
 inline void bounding_volume::update(bounding_volume_t& _, vec3a_t const* points, std::uint32_t count)
 {
   aabb_t box = aabb::set(center(_), half_extends(_));
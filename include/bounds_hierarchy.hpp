@@ -0,0 +1,235 @@
+#pragma once
+
+#include "aabb.hpp"
+#include "bounding_volume.hpp"
+#include <limits>
+#include <vector>
+
+namespace vml
+{
+//! How bounds_hierarchy merges a bounds type, empty() is the identity of merge
+template <typename bounds_t>
+struct bounds_merge;
+
+template <>
+struct bounds_merge<aabb_t>
+{
+  static inline aabb_t empty()
+  {
+    return aabb::set_min_max(vec3a::set(std::numeric_limits<float>::max()),
+                             vec3a::set(std::numeric_limits<float>::lowest()));
+  }
+  static inline void merge(aabb_t& _, aabb_t const& other)
+  {
+    _ = aabb::append(_, other);
+  }
+};
+
+//! Volumes with radius 0 are empty, like bounds_info
+template <>
+struct bounds_merge<bounding_volume_t>
+{
+  static inline bounding_volume_t empty()
+  {
+    bounding_volume_t _;
+    bounding_volume::nullify(_);
+    return _;
+  }
+  static inline void merge(bounding_volume_t& _, bounding_volume_t const& other)
+  {
+    if (bounding_volume::radius(other) <= 0)
+      return;
+    if (bounding_volume::radius(_) <= 0)
+      _ = other;
+    else
+      bounding_volume::update(_, other);
+  }
+};
+
+/**
+ * @remarks Aggregate bounds for a hierarchy. Every node has its own bounds (empty for pure group
+ * nodes) and an aggregate: its own bounds merged with the aggregates of its children. Changing
+ * the bounds of a node only queues it, refit then recomputes the queued nodes and their ancestors,
+ * deepest first, so each affected aggregate is merged once per refit and untouched subtrees are
+ * not visited. Nodes are addressed by stable indices and a parent must be inserted before its
+ * children, so indices can be shared with a transform_hierarchy built in the same order.
+ */
+template <typename bounds_t>
+class bounds_hierarchy
+{
+public:
+  using bounds_type = bounds_t;
+  using index_type  = std::uint32_t;
+  using merge_type  = bounds_merge<bounds_t>;
+
+  static constexpr index_type k_null = 0xffffffff;
+
+  //! Add a node with empty bounds, parent is k_null for a root
+  inline index_type insert(index_type parent = k_null)
+  {
+    assert(parent == k_null || contains(parent));
+    index_type node;
+    if (!free_nodes.empty())
+    {
+      node = free_nodes.back();
+      free_nodes.pop_back();
+    }
+    else
+    {
+      node = static_cast<index_type>(parents.size());
+      parents.push_back(k_null);
+      first_child.push_back(k_null);
+      next_sibling.push_back(k_null);
+      depths.push_back(0);
+      queued.push_back(0);
+      own.push_back(merge_type::empty());
+      aggregate.push_back(merge_type::empty());
+    }
+    parents[node]      = parent;
+    first_child[node]  = k_null;
+    next_sibling[node] = k_null;
+    own[node]          = merge_type::empty();
+    aggregate[node]    = merge_type::empty();
+    if (parent != k_null)
+    {
+      depths[node]        = depths[parent] + 1;
+      next_sibling[node]  = first_child[parent];
+      first_child[parent] = node;
+    }
+    else
+      depths[node] = 0;
+    live++;
+    return node;
+  }
+
+  //! Remove a node, it must not have children. Its parent is recomputed and its index is reused
+  //! after the next refit.
+  inline void erase(index_type node)
+  {
+    assert(contains(node) && first_child[node] == k_null);
+    index_type const parent = parents[node];
+    if (parent != k_null)
+    {
+      index_type* link = &first_child[parent];
+      while (*link != node)
+        link = &next_sibling[*link];
+      *link = next_sibling[node];
+      queue(parent);
+    }
+    parents[node] = k_erased;
+    erased_nodes.push_back(node);
+    live--;
+  }
+
+  //! Set the own bounds of a node, its aggregate and its ancestors are updated by refit
+  inline void set_bounds(index_type node, bounds_t const& b)
+  {
+    assert(contains(node));
+    own[node] = b;
+    queue(node);
+  }
+
+  //! Own bounds of node
+  inline bounds_t const& local_bounds(index_type node) const
+  {
+    assert(contains(node));
+    return own[node];
+  }
+
+  //! Bounds of node and its whole subtree as of the last refit
+  inline bounds_t const& bounds(index_type node) const
+  {
+    assert(contains(node));
+    return aggregate[node];
+  }
+
+  inline index_type parent(index_type node) const
+  {
+    assert(contains(node));
+    return parents[node];
+  }
+
+  inline bool contains(index_type node) const noexcept
+  {
+    return node < parents.size() && parents[node] != k_erased;
+  }
+
+  inline std::uint32_t size() const noexcept
+  {
+    return live;
+  }
+
+  //! Number of nodes waiting for refit, including the ancestors that will be recomputed
+  inline std::uint32_t pending() const noexcept
+  {
+    std::uint32_t count = 0;
+    for (auto const& level : levels)
+      count += static_cast<std::uint32_t>(level.size());
+    return count;
+  }
+
+  inline void clear()
+  {
+    parents.clear();
+    first_child.clear();
+    next_sibling.clear();
+    depths.clear();
+    queued.clear();
+    own.clear();
+    aggregate.clear();
+    free_nodes.clear();
+    erased_nodes.clear();
+    levels.clear();
+    live = 0;
+  }
+
+  //! Recompute the aggregates of changed nodes and their ancestors
+  inline void refit()
+  {
+    for (std::size_t d = levels.size(); d-- > 0;)
+    {
+      for (index_type n : levels[d])
+      {
+        queued[n]  = 0;
+        bounds_t b = own[n];
+        for (index_type c = first_child[n]; c != k_null; c = next_sibling[c])
+          merge_type::merge(b, aggregate[c]);
+        aggregate[n] = b;
+      }
+      levels[d].clear();
+    }
+    // Erased nodes may have been queued, they are only reused once out of the queue
+    free_nodes.insert(free_nodes.end(), erased_nodes.begin(), erased_nodes.end());
+    erased_nodes.clear();
+  }
+
+private:
+  static constexpr index_type k_erased = 0xfffffffe;
+
+  //! Queue node and its ancestors up to the first one already queued
+  inline void queue(index_type node)
+  {
+    for (index_type n = node; n != k_null && !queued[n]; n = parents[n])
+    {
+      queued[n] = 1;
+      if (depths[n] >= levels.size())
+        levels.resize(depths[n] + 1);
+      levels[depths[n]].push_back(n);
+    }
+  }
+
+  std::vector<index_type>    parents;
+  std::vector<index_type>    first_child;
+  std::vector<index_type>    next_sibling;
+  std::vector<std::uint32_t> depths;
+  std::vector<std::uint8_t>  queued;
+  std::vector<bounds_t>      own;
+  std::vector<bounds_t>      aggregate;
+  std::vector<index_type>    free_nodes;
+  std::vector<index_type>    erased_nodes;
+  //! Queued nodes by depth
+  std::vector<std::vector<index_type>> levels;
+  std::uint32_t                        live = 0;
+};
+
+} // namespace vml
@@ -0,0 +1,1089 @@
+#pragma once
+
+#include "aabb.hpp"
+#include "bounding_volume.hpp"
+#include "frustum.hpp"
+#include "ray_packet.hpp"
+#include "vec3xn.hpp"
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace vml
+{
+namespace detail
+{
+//! Traversal stack, fixed storage for usual depths and heap storage past that
+template <typename value_t>
+class bvh_stack
+{
+public:
+  inline void push(value_t const& v)
+  {
+    if (count < k_local_size)
+      local[count] = v;
+    else
+      overflow.push_back(v);
+    count++;
+  }
+
+  inline value_t pop()
+  {
+    if (--count < k_local_size)
+      return local[count];
+    value_t v = overflow.back();
+    overflow.pop_back();
+    return v;
+  }
+
+  inline bool empty() const noexcept
+  {
+    return count == 0;
+  }
+
+private:
+  static constexpr std::uint32_t k_local_size = 128;
+
+  value_t              local[k_local_size];
+  std::vector<value_t> overflow;
+  std::uint32_t        count = 0;
+};
+
+//! Half the surface area of box, the SAH cost of hitting it
+inline float half_area(aabb_t const& box)
+{
+  vec3a_t const d = aabb::size(box);
+  float const   x = vec3a::x(d);
+  float const   y = vec3a::y(d);
+  float const   z = vec3a::z(d);
+  return x * y + y * z + z * x;
+}
+
+//! Box containing nothing, the identity of aabb::append
+inline aabb_t empty_box()
+{
+  return aabb::set_min_max(vec3a::set(std::numeric_limits<float>::max()),
+                           vec3a::set(std::numeric_limits<float>::lowest()));
+}
+
+inline bool aabb_overlap(aabb_t const& a, aabb_t const& b)
+{
+  return !vec3a::greater_any(a.r[0], b.r[1]) && !vec3a::greater_any(b.r[0], a.r[1]);
+}
+
+//! Overlap of box with b0 and b1 in bits 0 and 1, both pairs in one 8 wide compare when available
+inline std::uint32_t aabb_overlap2(aabb_t const& box, aabb_t const& b0, aabb_t const& b1)
+{
+  if constexpr (stream_lane::element_count == 8)
+  {
+    quad8::type const   lo       = quad8::set(box.r[0], box.r[0]);
+    quad8::type const   hi       = quad8::set(box.r[1], box.r[1]);
+    quad8::type const   other_lo = quad8::set(b0.r[0], b1.r[0]);
+    quad8::type const   other_hi = quad8::set(b0.r[1], b1.r[1]);
+    quad8::type const   apart    = quad8::bit_or(quad8::greaterv(lo, other_hi), quad8::greaterv(other_lo, hi));
+    std::uint32_t const m        = quad8::mask(apart);
+    return ((m & 0x07) ? 0 : 1) | ((m & 0x70) ? 0 : 2);
+  }
+  else
+    return (aabb_overlap(box, b0) ? 1 : 0) | (aabb_overlap(box, b1) ? 2 : 0);
+}
+
+//! Bits per axis of a Morton code stored in code_t: 10 for 30 bit codes, 21 for 63 bit codes
+template <typename code_t>
+inline constexpr std::uint32_t morton_axis_bits = sizeof(code_t) == 4 ? 10 : 21;
+
+//! Spread the low morton_axis_bits bits of v, leaving two zero bits after each of them
+template <typename code_t>
+inline code_t morton_spread(std::uint32_t v)
+{
+  if constexpr (sizeof(code_t) == 4)
+  {
+    code_t x = v & 0x3ff;
+    x        = (x | (x << 16)) & 0x030000ff;
+    x        = (x | (x << 8)) & 0x0300f00f;
+    x        = (x | (x << 4)) & 0x030c30c3;
+    x        = (x | (x << 2)) & 0x09249249;
+    return x;
+  }
+  else
+  {
+    code_t x = v & 0x1fffff;
+    x        = (x | (x << 32)) & 0x001f00000000ffffull;
+    x        = (x | (x << 16)) & 0x001f0000ff0000ffull;
+    x        = (x | (x << 8)) & 0x100f00f00f00f00full;
+    x        = (x | (x << 4)) & 0x10c30c30c30c30c3ull;
+    x        = (x | (x << 2)) & 0x1249249249249249ull;
+    return x;
+  }
+}
+
+//! Interleave quantized coordinates, x goes to the lowest bit
+template <typename code_t>
+inline code_t morton_code(std::uint32_t x, std::uint32_t y, std::uint32_t z)
+{
+  return morton_spread<code_t>(x) | (morton_spread<code_t>(y) << 1) | (morton_spread<code_t>(z) << 2);
+}
+
+/**
+ * @remarks Stable LSD radix sort of keys, with values moved along, on the low key_bits bits of the
+ * keys, 8 bits per pass. Each pass histograms then scatters the input in tasks of task_size
+ * elements through exec, passes where every key has the same digit are skipped.
+ */
+template <typename key_t, typename executor>
+inline void radix_sort(std::vector<key_t>& keys, std::vector<std::uint32_t>& values, std::uint32_t key_bits,
+                       std::uint32_t task_size, executor&& exec)
+{
+  constexpr std::uint32_t    k_radix = 256;
+  std::uint32_t const        count   = static_cast<std::uint32_t>(keys.size());
+  std::uint32_t const        tasks   = (count + task_size - 1) / task_size;
+  std::vector<key_t>         sorted_keys(count);
+  std::vector<std::uint32_t> sorted_values(count);
+  std::vector<std::uint32_t> offsets(tasks * k_radix);
+  for (std::uint32_t shift = 0; shift < key_bits; shift += 8)
+  {
+    exec(tasks,
+         [&](std::uint32_t t)
+         {
+           std::uint32_t* histogram = &offsets[t * k_radix];
+           std::fill_n(histogram, k_radix, 0u);
+           for (std::uint32_t i = t * task_size, end = std::min(count, i + task_size); i < end; ++i)
+             histogram[(keys[i] >> shift) & (k_radix - 1)]++;
+         });
+
+    // Offsets run by digit then by task, so equal digits keep the input order
+    std::uint32_t sum     = 0;
+    bool          trivial = false;
+    for (std::uint32_t d = 0; d < k_radix; ++d)
+    {
+      std::uint32_t const first = sum;
+      for (std::uint32_t t = 0; t < tasks; ++t)
+      {
+        std::uint32_t const c = offsets[t * k_radix + d];
+        offsets[t * k_radix + d] = sum;
+        sum += c;
+      }
+      trivial |= sum - first == count;
+    }
+    if (trivial)
+      continue;
+
+    exec(tasks,
+         [&](std::uint32_t t)
+         {
+           std::uint32_t* next = &offsets[t * k_radix];
+           for (std::uint32_t i = t * task_size, end = std::min(count, i + task_size); i < end; ++i)
+           {
+             std::uint32_t const pos = next[(keys[i] >> shift) & (k_radix - 1)]++;
+             sorted_keys[pos]        = keys[i];
+             sorted_values[pos]      = values[i];
+           }
+         });
+    keys.swap(sorted_keys);
+    values.swap(sorted_values);
+  }
+}
+
+//! Morton codes of center(i) for i in [begin, end), quantized width centers at a time in SoA
+template <typename lane, typename code_t, typename center_fn>
+inline void morton_codes(center_fn const& center, vec3a::pref lo, vec3a::pref scale, float limit, std::uint32_t begin,
+                         std::uint32_t end, code_t* o_codes)
+{
+  constexpr std::uint32_t   width         = lane::element_count;
+  typename lane::type const lane_lo[3]    = {lane::set(vec3a::x(lo)), lane::set(vec3a::y(lo)), lane::set(vec3a::z(lo))};
+  typename lane::type const lane_scale[3] = {lane::set(vec3a::x(scale)), lane::set(vec3a::y(scale)),
+                                             lane::set(vec3a::z(scale))};
+  typename lane::type const zero          = lane::zero();
+  typename lane::type const top           = lane::set(limit);
+  std::uint32_t             i             = begin;
+  for (; i + width <= end; i += width)
+  {
+    quad_t c[width];
+    for (std::uint32_t k = 0; k < width; ++k)
+      c[k] = center(i + k);
+    typename lane::type v[4];
+    lanes_from_quads<lane>(c, v);
+    alignas(32) float q[3][width];
+    for (std::uint32_t a = 0; a < 3; ++a)
+      lane::store(q[a], lane::min(lane::max(lane::mul(lane::sub(v[a], lane_lo[a]), lane_scale[a]), zero), top));
+    for (std::uint32_t k = 0; k < width; ++k)
+      o_codes[i + k] = morton_code<code_t>(static_cast<std::uint32_t>(q[0][k]), static_cast<std::uint32_t>(q[1][k]),
+                                           static_cast<std::uint32_t>(q[2][k]));
+  }
+  for (; i < end; ++i)
+  {
+    vec3a_t const d = vec3a::mul(vec3a::sub(center(i), lo), scale);
+    vec3a_t const q = vec3a::min(vec3a::max(d, vec3a::zero()), vec3a::set(limit));
+    o_codes[i]      = morton_code<code_t>(static_cast<std::uint32_t>(vec3a::x(q)),
+                                          static_cast<std::uint32_t>(vec3a::y(q)),
+                                          static_cast<std::uint32_t>(vec3a::z(q)));
+  }
+}
+
+/**
+ * @remarks Morton order of count points: center(i) is quantized over the bounds of all points to a
+ * 30 bit (code_t = std::uint32_t) or 63 bit (std::uint64_t) code in o_codes[i], then o_order holds
+ * the point indices sorted by code along with the sorted o_codes. Bounds, codes and the sort run
+ * as tasks of task_size points through exec. o_codes and o_order must hold count elements.
+ */
+template <typename lane, typename code_t, typename center_fn, typename executor>
+inline void morton_order(std::uint32_t count, center_fn const& center, std::uint32_t task_size, executor&& exec,
+                         std::vector<code_t>& o_codes, std::vector<std::uint32_t>& o_order)
+{
+  std::uint32_t const tasks = (count + task_size - 1) / task_size;
+  std::vector<aabb_t> task_bounds(tasks, empty_box());
+  exec(tasks,
+       [&](std::uint32_t t)
+       {
+         for (std::uint32_t i = t * task_size, end = std::min(count, i + task_size); i < end; ++i)
+           task_bounds[t] = aabb::append(task_bounds[t], center(i));
+       });
+  aabb_t bounds = empty_box();
+  for (aabb_t const& b : task_bounds)
+    bounds = aabb::append(bounds, b);
+
+  // Centers map to [0, limit] on each axis, flat axes map to 0
+  float const   limit  = static_cast<float>((1u << morton_axis_bits<code_t>) - 1);
+  vec3a_t const extent = aabb::size(bounds);
+  auto const    scale  = [limit](float e)
+  {
+    return e > 0.0f ? limit / e : 0.0f;
+  };
+  vec3a_t const mul = vec3a::set(scale(vec3a::x(extent)), scale(vec3a::y(extent)), scale(vec3a::z(extent)));
+  exec(tasks,
+       [&](std::uint32_t t)
+       {
+         std::uint32_t const begin = t * task_size;
+         std::uint32_t const end   = std::min(count, begin + task_size);
+         morton_codes<lane>(center, bounds.r[0], mul, limit, begin, end, o_codes.data());
+         std::iota(o_order.begin() + begin, o_order.begin() + end, begin);
+       });
+  radix_sort(o_codes, o_order, 3 * morton_axis_bits<code_t>, task_size, exec);
+}
+} // namespace detail
+
+/**
+ * @remarks Bounding volume hierarchy over boxes with lane::element_count (4 or 8) children per
+ * node. The bounds of the children of a node are kept in SoA, so visiting a node tests all of
+ * its children with a few lane operations. Built top down: a node is filled by splitting its most
+ * populated child range until it has element_count children, ranges of at most k_leaf_size boxes
+ * become leaves. build splits with binned SAH, build_linear at Morton code boundaries. Queries
+ * report boxes by their index in the span given to build.
+ */
+template <typename lane>
+class bvhn
+{
+public:
+  using lane_type  = typename lane::type;
+  using index_type = std::uint32_t;
+
+  enum : unsigned int
+  {
+    width = lane::element_count
+  };
+
+  //! Largest number of boxes in a leaf
+  static constexpr std::uint32_t k_leaf_size = 4;
+  //! Bins per axis when evaluating SAH splits
+  static constexpr std::uint32_t k_bin_count = 16;
+  //! Cost of visiting a node relative to testing a box, an SAH split must save more than this over a leaf
+  static constexpr float k_traversal_cost = 1.0f;
+  //! Builds of at least this many boxes build the subtrees of the root as separate tasks for
+  //! the executor passed to build, per box passes of build_linear use tasks of this many boxes
+  static constexpr std::uint32_t k_parallel_build_size = 16384;
+  //! Set in node::child for leaf children, the remaining bits are the first box of the leaf
+  static constexpr index_type k_leaf = 0x80000000;
+
+  struct node
+  {
+    //! Bounds of child k in lane k
+    lane_type min_x, min_y, min_z, max_x, max_y, max_z;
+    //! Node index of inner children, k_leaf | first box for leaves
+    index_type child[width];
+    //! Box count of leaf children
+    std::uint32_t leaf_count[width];
+    //! Children are packed, lanes from child_count on are unused
+    std::uint32_t child_count;
+  };
+
+  /**
+   * @remarks Build over boxes, any previous content is dropped. Inputs of k_parallel_build_size
+   * boxes or more build the subtrees under the root as up to width tasks of exec, see
+   * detail::serial_executor.
+   */
+  template <typename executor = detail::serial_executor>
+  inline void build(std::span<aabb_t const> i_boxes, executor&& exec = {})
+  {
+    clear();
+    std::uint32_t const count = static_cast<std::uint32_t>(i_boxes.size());
+    if (!count)
+      return;
+
+    order.resize(count);
+    std::iota(order.begin(), order.end(), 0u);
+    build_context ctx{i_boxes, std::vector<float>(count * 3), order};
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+      vec3a_t const c        = aabb::center(i_boxes[i]);
+      ctx.centers[i * 3 + 0] = vec3a::x(c);
+      ctx.centers[i * 3 + 1] = vec3a::y(c);
+      ctx.centers[i * 3 + 2] = vec3a::z(c);
+    }
+    emit(ctx, sah_split, exec);
+  }
+
+  //! Build over the boxes of bounding volumes
+  template <typename executor = detail::serial_executor>
+  inline void build(std::span<bounding_volume_t const> i_vols, executor&& exec = {})
+  {
+    build(std::span<aabb_t const>(to_boxes(i_vols)), std::forward<executor>(exec));
+  }
+
+  /**
+   * @remarks Linear build over boxes, any previous content is dropped. LBVH build, cheap enough to
+   * redo every frame. Box centers are quantized to 30 bit (code_t = std::uint32_t) or 63 bit
+   * (std::uint64_t) Morton codes and radix sorted, then a range is split where the highest bit that
+   * differs across its codes changes. Splits are binary searches and node bounds are merged bottom
+   * up, so emitting the tree is linear in the box count. Trees are slower to query than SAH builds,
+   * but queried the same way. Codes, sort and the final box copy run as tasks of
+   * k_parallel_build_size boxes, subtrees as in build.
+   */
+  template <typename code_t = std::uint32_t, typename executor = detail::serial_executor>
+  inline void build_linear(std::span<aabb_t const> i_boxes, executor&& exec = {})
+  {
+    static_assert(std::is_same_v<code_t, std::uint32_t> || std::is_same_v<code_t, std::uint64_t>,
+                  "Morton codes are 30 bit in std::uint32_t or 63 bit in std::uint64_t");
+    clear();
+    std::uint32_t const count = static_cast<std::uint32_t>(i_boxes.size());
+    if (!count)
+      return;
+
+    std::vector<code_t> codes(count);
+    order.resize(count);
+    detail::morton_order<lane>(
+      count,
+      [i_boxes](std::uint32_t i)
+      {
+        return aabb::center(i_boxes[i]);
+      },
+      k_parallel_build_size, exec, codes, order);
+
+    build_context ctx{i_boxes, {}, order};
+    emit(
+      ctx,
+      [&codes](build_context&, std::uint32_t begin, std::uint32_t end)
+      {
+        code_t const diff = codes[begin] ^ codes[end - 1];
+        if (!diff)
+          return begin + (end - begin) / 2;
+        code_t const bit = code_t(1) << (std::bit_width(diff) - 1);
+        auto const   mid = std::partition_point(codes.begin() + begin, codes.begin() + end,
+                                                [bit](code_t c)
+                                                {
+                                                  return !(c & bit);
+                                                });
+        return static_cast<std::uint32_t>(mid - codes.begin());
+      },
+      exec);
+  }
+
+  template <typename code_t = std::uint32_t, typename executor = detail::serial_executor>
+  inline void build_linear(std::span<bounding_volume_t const> i_vols, executor&& exec = {})
+  {
+    build_linear<code_t>(std::span<aabb_t const>(to_boxes(i_vols)), std::forward<executor>(exec));
+  }
+
+  //! Call visit(index) for every box overlapping box
+  template <typename visit_fn>
+  inline void query(aabb_t const& box, visit_fn&& visit) const
+  {
+    lane_type const bmin_x = lane::set(vec3a::x(box.r[0]));
+    lane_type const bmin_y = lane::set(vec3a::y(box.r[0]));
+    lane_type const bmin_z = lane::set(vec3a::z(box.r[0]));
+    lane_type const bmax_x = lane::set(vec3a::x(box.r[1]));
+    lane_type const bmax_y = lane::set(vec3a::y(box.r[1]));
+    lane_type const bmax_z = lane::set(vec3a::z(box.r[1]));
+    traverse(
+      [&](node const& n)
+      {
+        lane_type m = lane::bit_and(lane::lesser_equalv(n.min_x, bmax_x), lane::greater_equalv(n.max_x, bmin_x));
+        m           = lane::bit_and(m, lane::lesser_equalv(n.min_y, bmax_y));
+        m           = lane::bit_and(m, lane::greater_equalv(n.max_y, bmin_y));
+        m           = lane::bit_and(m, lane::lesser_equalv(n.min_z, bmax_z));
+        m           = lane::bit_and(m, lane::greater_equalv(n.max_z, bmin_z));
+        return lane::mask(m);
+      },
+      [&](std::uint32_t i)
+      {
+        if (!vec3a::greater_any(boxes[i].r[0], box.r[1]) && !vec3a::lesser_any(boxes[i].r[1], box.r[0]))
+          visit(order[i]);
+      });
+  }
+
+  //! Call visit(index) for every box overlapping sphere
+  template <typename visit_fn>
+  inline void query(sphere_t const& sphere, visit_fn&& visit) const
+  {
+    vec3a_t const   center = sphere::center(sphere);
+    float const     r2     = sphere::radius(sphere) * sphere::radius(sphere);
+    lane_type const cx     = lane::set(vec3a::x(center));
+    lane_type const cy     = lane::set(vec3a::y(center));
+    lane_type const cz     = lane::set(vec3a::z(center));
+    lane_type const lr2    = lane::set(r2);
+    traverse(
+      [&](node const& n)
+      {
+        // Distance from the center to the closest point of each child box
+        lane_type const dx = lane::sub(lane::min(lane::max(cx, n.min_x), n.max_x), cx);
+        lane_type const dy = lane::sub(lane::min(lane::max(cy, n.min_y), n.max_y), cy);
+        lane_type const dz = lane::sub(lane::min(lane::max(cz, n.min_z), n.max_z), cz);
+        lane_type const d2 = lane::madd(dx, dx, lane::madd(dy, dy, lane::mul(dz, dz)));
+        return lane::mask(lane::lesser_equalv(d2, lr2));
+      },
+      [&](std::uint32_t i)
+      {
+        vec3a_t const d = vec3a::sub(vec3a::min(vec3a::max(center, boxes[i].r[0]), boxes[i].r[1]), center);
+        if (vec3a::dot(d, d) <= r2)
+          visit(order[i]);
+      });
+  }
+
+  /**
+   * @remarks Call visit(index) for every box inside or intersecting the frustum. Like
+   * frustum_t::coherency, each visited node carries the mask of planes its parent straddles:
+   * planes a child is fully inside of are dropped for its subtree, and subtrees inside all planes
+   * are reported without further tests.
+   */
+  template <typename visit_fn>
+  inline void query(frustum_t const& i_frustum, visit_fn&& visit) const
+  {
+    if (nodes.empty())
+      return;
+    auto const planes = frustum::get_planes(i_frustum);
+    assert(planes.second <= 32);
+    float const* plane_data = reinterpret_cast<float const*>(planes.first);
+
+    struct entry
+    {
+      index_type    node;
+      std::uint32_t planes;
+    };
+    detail::bvh_stack<entry> stack;
+    stack.push({0, planes.second == 32 ? 0xffffffff : (1u << planes.second) - 1});
+    lane_type const zero = lane::zero();
+    while (!stack.empty())
+    {
+      entry const   e       = stack.pop();
+      node const&   n       = nodes[e.node];
+      std::uint32_t outside = 0;
+      std::uint32_t child_planes[width];
+      std::fill_n(child_planes, width, e.planes);
+      if (e.planes)
+      {
+        lane_type const cx = lane::mul(lane::add(n.min_x, n.max_x), 0.5f);
+        lane_type const cy = lane::mul(lane::add(n.min_y, n.max_y), 0.5f);
+        lane_type const cz = lane::mul(lane::add(n.min_z, n.max_z), 0.5f);
+        lane_type const ex = lane::mul(lane::sub(n.max_x, n.min_x), 0.5f);
+        lane_type const ey = lane::mul(lane::sub(n.max_y, n.min_y), 0.5f);
+        lane_type const ez = lane::mul(lane::sub(n.max_z, n.min_z), 0.5f);
+        for (std::uint32_t active = e.planes; active; active &= active - 1)
+        {
+          std::uint32_t const p     = std::countr_zero(active);
+          float const*        plane = plane_data + p * 4;
+          lane_type const     nx    = lane::set(plane[0]);
+          lane_type const     ny    = lane::set(plane[1]);
+          lane_type const     nz    = lane::set(plane[2]);
+          lane_type           m     = lane::madd(nx, cx, lane::set(plane[3]));
+          m                         = lane::madd(ny, cy, m);
+          m                         = lane::madd(nz, cz, m);
+          lane_type r               = lane::mul(lane::abs(nx), ex);
+          r                         = lane::madd(lane::abs(ny), ey, r);
+          r                         = lane::madd(lane::abs(nz), ez, r);
+          outside |= lane::mask(lane::lesserv(lane::add(m, r), zero));
+          for (std::uint32_t inside = lane::mask(lane::greater_equalv(lane::sub(m, r), zero)); inside;
+               inside &= inside - 1)
+            child_planes[std::countr_zero(inside)] &= ~(1u << p);
+        }
+      }
+
+      for (std::uint32_t hits = ~outside & ((1u << n.child_count) - 1); hits; hits &= hits - 1)
+      {
+        std::uint32_t const k = std::countr_zero(hits);
+        if (!(n.child[k] & k_leaf))
+        {
+          stack.push({n.child[k], child_planes[k]});
+          continue;
+        }
+        for (std::uint32_t i = n.child[k] & ~k_leaf, end = i + n.leaf_count[k]; i < end; ++i)
+        {
+          if (!box_outside(boxes[i], plane_data, child_planes[k]))
+            visit(order[i]);
+        }
+      }
+    }
+  }
+
+  /**
+   * @remarks Call visit(index, t) for every box hit by the ray from origin along direction
+   * within [0, t_max], t is where the ray enters the box (0 if origin is inside). Boxes are not
+   * reported in distance order. visit may return a float, the new t_max, to shorten the ray: the
+   * hit children of a node are then visited nearest first, and boxes and subtrees entered past
+   * t_max are skipped, which nearest hit searches use to stop early.
+   */
+  template <typename visit_fn>
+  inline void raycast(vec3a::pref origin, vec3a::pref direction, float t_max, visit_fn&& visit) const
+  {
+    raycast(ray::set(origin, direction), t_max, std::forward<visit_fn>(visit));
+  }
+
+  //! Same as raycast from origin along direction, t is in units of the ray direction length
+  template <typename visit_fn>
+  inline void raycast(ray_t const& r, float t_max, visit_fn&& visit) const
+  {
+    using rayxn                   = vml::rayxn<lane>;
+    typename rayxn::type const rl = rayxn::set(r);
+    if constexpr (!std::is_void_v<std::invoke_result_t<visit_fn&, index_type, float>>)
+      raycast_nearest(r, rl, t_max, visit);
+    else
+    {
+      // Nothing shortens the ray, children are taken in lane order
+      traverse(
+        [&](node const& n)
+        {
+          lane_type t;
+          return rayxn::intersect_boxes(rl, {n.min_x, n.min_y, n.min_z}, {n.max_x, n.max_y, n.max_z}, t_max, t);
+        },
+        [&](std::uint32_t i)
+        {
+          float const t = ray::intersect_box(r, boxes[i], t_max);
+          if (t >= 0.0f)
+            visit(order[i], t);
+        });
+    }
+  }
+
+  /**
+   * @remarks Trace a packet of rays, call visit(index, mask) for every box hit by at least one of
+   * the rays in active, mask holds the rays hitting it. Children are first culled against the
+   * bounding planes of the packet, then slab tested per ray, and rays missing a node are dropped
+   * for its subtree. visit may lower packet.t_max, as ray_packetn::intersect_triangles does, to
+   * stop rays past their nearest hit.
+   */
+  template <typename packet_lane, typename visit_fn>
+  inline void raycast(ray_packet_t<packet_lane>& packet, std::uint32_t active, visit_fn&& visit) const
+  {
+    using ray_packetn = vml::ray_packetn<packet_lane>;
+    if (nodes.empty() || !active)
+      return;
+    plane_t             planes[6];
+    std::uint32_t const plane_count = ray_packetn::bounding_planes(packet, planes);
+
+    struct entry
+    {
+      index_type    node;
+      std::uint32_t active;
+    };
+    detail::bvh_stack<entry> stack;
+    stack.push({0, active});
+    lane_type const zero = lane::zero();
+    while (!stack.empty())
+    {
+      entry const   e       = stack.pop();
+      node const&   n       = nodes[e.node];
+      std::uint32_t outside = 0;
+      if (plane_count)
+      {
+        lane_type const cx = lane::mul(lane::add(n.min_x, n.max_x), 0.5f);
+        lane_type const cy = lane::mul(lane::add(n.min_y, n.max_y), 0.5f);
+        lane_type const cz = lane::mul(lane::add(n.min_z, n.max_z), 0.5f);
+        lane_type const ex = lane::mul(lane::sub(n.max_x, n.min_x), 0.5f);
+        lane_type const ey = lane::mul(lane::sub(n.max_y, n.min_y), 0.5f);
+        lane_type const ez = lane::mul(lane::sub(n.max_z, n.min_z), 0.5f);
+        for (std::uint32_t p = 0; p < plane_count; ++p)
+        {
+          float const*    plane = reinterpret_cast<float const*>(&planes[p]);
+          lane_type const nx    = lane::set(plane[0]);
+          lane_type const ny    = lane::set(plane[1]);
+          lane_type const nz    = lane::set(plane[2]);
+          lane_type       m     = lane::madd(nx, cx, lane::set(plane[3]));
+          m                     = lane::madd(ny, cy, m);
+          m                     = lane::madd(nz, cz, m);
+          lane_type r           = lane::mul(lane::abs(nx), ex);
+          r                     = lane::madd(lane::abs(ny), ey, r);
+          r                     = lane::madd(lane::abs(nz), ez, r);
+          outside |= lane::mask(lane::lesserv(lane::add(m, r), zero));
+        }
+      }
+
+      for (std::uint32_t children = ~outside & ((1u << n.child_count) - 1); children; children &= children - 1)
+      {
+        std::uint32_t const k     = std::countr_zero(children);
+        aabb_t const        child = aabb::set_min_max(
+          vec3a::set(lane::get(n.min_x, k), lane::get(n.min_y, k), lane::get(n.min_z, k)),
+          vec3a::set(lane::get(n.max_x, k), lane::get(n.max_y, k), lane::get(n.max_z, k)));
+        typename packet_lane::type t;
+        std::uint32_t const        hits = ray_packetn::intersect_box(packet, child, e.active, t);
+        if (!hits)
+          continue;
+        if (!(n.child[k] & k_leaf))
+        {
+          stack.push({n.child[k], hits});
+          continue;
+        }
+        for (std::uint32_t i = n.child[k] & ~k_leaf, end = i + n.leaf_count[k]; i < end; ++i)
+        {
+          std::uint32_t const mask = ray_packetn::intersect_box(packet, boxes[i], hits, t);
+          if (mask)
+            visit(order[i], mask);
+        }
+      }
+    }
+  }
+
+  //! Number of boxes
+  inline std::uint32_t size() const noexcept
+  {
+    return static_cast<std::uint32_t>(order.size());
+  }
+
+  inline bool empty() const noexcept
+  {
+    return order.empty();
+  }
+
+  inline std::uint32_t node_count() const noexcept
+  {
+    return static_cast<std::uint32_t>(nodes.size());
+  }
+
+  //! Bounds of all boxes
+  inline aabb_t bounds() const
+  {
+    aabb_t b = detail::empty_box();
+    if (nodes.empty())
+      return b;
+    node const& root = nodes[0];
+    for (std::uint32_t k = 0; k < root.child_count; ++k)
+      b = aabb::append(b, child_bounds(root, k));
+    return b;
+  }
+
+  inline void clear()
+  {
+    nodes.clear();
+    boxes.clear();
+    order.clear();
+  }
+
+private:
+  struct range
+  {
+    std::uint32_t begin;
+    std::uint32_t end;
+  };
+
+  //! Shared by build tasks, which only write disjoint ranges of order
+  struct build_context
+  {
+    std::span<aabb_t const>  boxes;
+    std::vector<float>       centers;
+    std::vector<index_type>& order;
+  };
+
+  static inline std::uint32_t task_count(std::uint32_t count)
+  {
+    return (count + k_parallel_build_size - 1) / k_parallel_build_size;
+  }
+
+  static inline std::vector<aabb_t> to_boxes(std::span<bounding_volume_t const> i_vols)
+  {
+    std::vector<aabb_t> result(i_vols.size());
+    for (std::size_t i = 0; i < i_vols.size(); ++i)
+      result[i] = aabb::set(bounding_volume::center(i_vols[i]), bounding_volume::half_extends(i_vols[i]));
+    return result;
+  }
+
+  static inline aabb_t child_bounds(node const& n, std::uint32_t k)
+  {
+    return aabb::set_min_max(vec3a::set(lane::get(n.min_x, k), lane::get(n.min_y, k), lane::get(n.min_z, k)),
+                             vec3a::set(lane::get(n.max_x, k), lane::get(n.max_y, k), lane::get(n.max_z, k)));
+  }
+
+  //! True if box is outside one of the planes set in plane_mask
+  static inline bool box_outside(aabb_t const& box, float const* plane_data, std::uint32_t plane_mask)
+  {
+    vec3a_t const c = aabb::center(box);
+    vec3a_t const e = aabb::half_size(box);
+    for (; plane_mask; plane_mask &= plane_mask - 1)
+    {
+      float const* plane = plane_data + std::countr_zero(plane_mask) * 4;
+      float const  m     = plane[0] * vec3a::x(c) + plane[1] * vec3a::y(c) + plane[2] * vec3a::z(c) + plane[3];
+      float const  r =
+        vml::abs(plane[0]) * vec3a::x(e) + vml::abs(plane[1]) * vec3a::y(e) + vml::abs(plane[2]) * vec3a::z(e);
+      if (m + r < 0.0f)
+        return true;
+    }
+    return false;
+  }
+
+  //! raycast with a visitor returning the new t_max, hit children nearest first and subtrees past t_max skipped
+  template <typename visit_fn>
+  inline void raycast_nearest(ray_t const& r, typename rayxn<lane>::type const& rl, float t_max, visit_fn& visit) const
+  {
+    using rayxn = vml::rayxn<lane>;
+    if (nodes.empty())
+      return;
+
+    struct entry
+    {
+      index_type node;
+      float      t;
+    };
+    detail::bvh_stack<entry> stack;
+    stack.push({0, 0.0f});
+    while (!stack.empty())
+    {
+      entry const e = stack.pop();
+      // Entered past a hit found since it was pushed
+      if (e.t > t_max)
+        continue;
+      node const&         n = nodes[e.node];
+      lane_type           t;
+      std::uint32_t const hits =
+        rayxn::intersect_boxes(rl, {n.min_x, n.min_y, n.min_z}, {n.max_x, n.max_y, n.max_z}, t_max, t) &
+        ((1u << n.child_count) - 1);
+      alignas(32) float enter[width];
+      lane::store(enter, t);
+
+      // Insertion sort of the hit children by entry distance
+      std::uint32_t near[width];
+      std::uint32_t count = 0;
+      for (std::uint32_t m = hits; m; m &= m - 1)
+      {
+        std::uint32_t const k = std::countr_zero(m);
+        std::uint32_t       i = count++;
+        for (; i > 0 && enter[near[i - 1]] > enter[k]; --i)
+          near[i] = near[i - 1];
+        near[i] = k;
+      }
+
+      // Leaves are tested now, inner children pushed farthest first so the nearest is popped next
+      for (std::uint32_t i = 0; i < count; ++i)
+      {
+        std::uint32_t const k = near[i];
+        if (!(n.child[k] & k_leaf) || enter[k] > t_max)
+          continue;
+        for (std::uint32_t b = n.child[k] & ~k_leaf, end = b + n.leaf_count[k]; b < end; ++b)
+        {
+          float const bt = ray::intersect_box(r, boxes[b], t_max);
+          if (bt < 0.0f)
+            continue;
+          t_max = std::min(t_max, static_cast<float>(visit(order[b], bt)));
+        }
+      }
+      for (std::uint32_t i = count; i-- > 0;)
+      {
+        std::uint32_t const k = near[i];
+        if (!(n.child[k] & k_leaf) && enter[k] <= t_max)
+          stack.push({n.child[k], enter[k]});
+      }
+    }
+  }
+
+  template <typename node_fn, typename box_fn>
+  inline void traverse(node_fn&& test_node, box_fn&& test_box) const
+  {
+    if (nodes.empty())
+      return;
+    detail::bvh_stack<index_type> stack;
+    stack.push(0);
+    while (!stack.empty())
+    {
+      node const& n = nodes[stack.pop()];
+      for (std::uint32_t hits = test_node(n) & ((1u << n.child_count) - 1); hits; hits &= hits - 1)
+      {
+        std::uint32_t const k = std::countr_zero(hits);
+        if (!(n.child[k] & k_leaf))
+          stack.push(n.child[k]);
+        else
+        {
+          for (std::uint32_t i = n.child[k] & ~k_leaf, end = i + n.leaf_count[k]; i < end; ++i)
+            test_box(i);
+        }
+      }
+    }
+  }
+
+  static inline aabb_t range_bounds(build_context const& ctx, std::uint32_t begin, std::uint32_t end)
+  {
+    aabb_t b = detail::empty_box();
+    for (std::uint32_t i = begin; i < end; ++i)
+      b = aabb::append(b, ctx.boxes[ctx.order[i]]);
+    return b;
+  }
+
+  /**
+   * @remarks Binned SAH split of order[begin, end), returns the first index of the right half.
+   * When no split beats keeping the range as a leaf, as with boxes that all overlap, the range is
+   * split at the median center on the widest axis instead, which keeps the tree balanced.
+   */
+  static inline std::uint32_t sah_split(build_context& ctx, std::uint32_t begin, std::uint32_t end)
+  {
+    float lo[3] = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                   std::numeric_limits<float>::max()};
+    float hi[3] = {std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(),
+                   std::numeric_limits<float>::lowest()};
+    aabb_t bounds = detail::empty_box();
+    for (std::uint32_t i = begin; i < end; ++i)
+    {
+      bounds         = aabb::append(bounds, ctx.boxes[ctx.order[i]]);
+      float const* c = &ctx.centers[ctx.order[i] * 3];
+      for (std::uint32_t a = 0; a < 3; ++a)
+      {
+        lo[a] = std::min(lo[a], c[a]);
+        hi[a] = std::max(hi[a], c[a]);
+      }
+    }
+
+    float         best_cost = std::numeric_limits<float>::max();
+    std::uint32_t best_axis = 3;
+    std::uint32_t best_bin  = 0;
+    for (std::uint32_t a = 0; a < 3; ++a)
+    {
+      if (!(hi[a] > lo[a]))
+        continue;
+      float const   scale = k_bin_count / (hi[a] - lo[a]);
+      aabb_t        bin_bounds[k_bin_count];
+      std::uint32_t bin_counts[k_bin_count] = {};
+      std::fill_n(bin_bounds, k_bin_count, detail::empty_box());
+      for (std::uint32_t i = begin; i < end; ++i)
+      {
+        std::uint32_t const b = bin(ctx.centers[ctx.order[i] * 3 + a], lo[a], scale);
+        bin_counts[b]++;
+        bin_bounds[b] = aabb::append(bin_bounds[b], ctx.boxes[ctx.order[i]]);
+      }
+
+      // Cost of splitting before bin b is area(left) * count(left) + area(right) * count(right)
+      float         right_area[k_bin_count];
+      std::uint32_t right_count[k_bin_count];
+      aabb_t        acc   = detail::empty_box();
+      std::uint32_t count = 0;
+      for (std::uint32_t b = k_bin_count - 1; b > 0; --b)
+      {
+        count += bin_counts[b];
+        acc            = aabb::append(acc, bin_bounds[b]);
+        right_area[b]  = count ? detail::half_area(acc) : 0.0f;
+        right_count[b] = count;
+      }
+      acc   = detail::empty_box();
+      count = 0;
+      for (std::uint32_t b = 1; b < k_bin_count; ++b)
+      {
+        count += bin_counts[b - 1];
+        acc = aabb::append(acc, bin_bounds[b - 1]);
+        if (!count || !right_count[b])
+          continue;
+        float const cost = detail::half_area(acc) * count + right_area[b] * right_count[b];
+        if (cost < best_cost)
+        {
+          best_cost = cost;
+          best_axis = a;
+          best_bin  = b;
+        }
+      }
+    }
+
+    // Costs are in units of area(range), a leaf tests every box of the range
+    float const area = detail::half_area(bounds);
+    if (best_axis == 3 || best_cost + k_traversal_cost * area >= area * (end - begin))
+      return median_split(ctx, begin, end, lo, hi);
+
+    float const lo_a  = lo[best_axis];
+    float const scale = k_bin_count / (hi[best_axis] - lo_a);
+    auto const  left  = [&](index_type i)
+    {
+      return bin(ctx.centers[i * 3 + best_axis], lo_a, scale) < best_bin;
+    };
+    auto const mid = std::partition(ctx.order.begin() + begin, ctx.order.begin() + end, left);
+    return static_cast<std::uint32_t>(mid - ctx.order.begin());
+  }
+
+  //! Split order[begin, end) in halves at the median center on the axis where centers spread most
+  static inline std::uint32_t median_split(build_context& ctx, std::uint32_t begin, std::uint32_t end,
+                                           float const (&lo)[3], float const (&hi)[3])
+  {
+    std::uint32_t axis = 0;
+    for (std::uint32_t a = 1; a < 3; ++a)
+    {
+      if (hi[a] - lo[a] > hi[axis] - lo[axis])
+        axis = a;
+    }
+    std::uint32_t const mid = begin + (end - begin) / 2;
+    std::nth_element(ctx.order.begin() + begin, ctx.order.begin() + mid, ctx.order.begin() + end,
+                     [&](index_type a, index_type b)
+                     {
+                       return ctx.centers[a * 3 + axis] < ctx.centers[b * 3 + axis];
+                     });
+    return mid;
+  }
+
+  static inline std::uint32_t bin(float c, float lo, float scale)
+  {
+    return std::min(k_bin_count - 1, static_cast<std::uint32_t>((c - lo) * scale));
+  }
+
+  //! Split order[begin, end) into up to width ranges, returns the range count
+  template <typename split_fn>
+  static inline std::uint32_t partition(build_context& ctx, std::uint32_t begin, std::uint32_t end,
+                                        split_fn const& split, range (&ranges)[width])
+  {
+    ranges[0]       = {begin, end};
+    std::uint32_t n = 1;
+    while (n < width)
+    {
+      std::uint32_t largest = width;
+      std::uint32_t size    = k_leaf_size;
+      for (std::uint32_t k = 0; k < n; ++k)
+      {
+        if (ranges[k].end - ranges[k].begin > size)
+        {
+          largest = k;
+          size    = ranges[k].end - ranges[k].begin;
+        }
+      }
+      if (largest == width)
+        break;
+      std::uint32_t const mid = split(ctx, ranges[largest].begin, ranges[largest].end);
+      ranges[n++]             = {mid, ranges[largest].end};
+      ranges[largest].end     = mid;
+    }
+    return n;
+  }
+
+  //! Node over ranges with child bounds and leaf children filled in, inner children are left to the caller
+  static inline node make_node(range const (&ranges)[width], aabb_t const (&bounds)[width], std::uint32_t n)
+  {
+    alignas(32) float lanes[6][width];
+    node              result;
+    for (std::uint32_t k = 0; k < width; ++k)
+    {
+      aabb_t const b = k < n ? bounds[k] : detail::empty_box();
+      lanes[0][k]    = vec3a::x(b.r[0]);
+      lanes[1][k]    = vec3a::y(b.r[0]);
+      lanes[2][k]    = vec3a::z(b.r[0]);
+      lanes[3][k]    = vec3a::x(b.r[1]);
+      lanes[4][k]    = vec3a::y(b.r[1]);
+      lanes[5][k]    = vec3a::z(b.r[1]);
+      std::uint32_t const count = k < n ? ranges[k].end - ranges[k].begin : 0;
+      result.child[k]           = k < n && count <= k_leaf_size ? k_leaf | ranges[k].begin : 0;
+      result.leaf_count[k]      = count <= k_leaf_size ? count : 0;
+    }
+    result.min_x       = lane::set(lanes[0]);
+    result.min_y       = lane::set(lanes[1]);
+    result.min_z       = lane::set(lanes[2]);
+    result.max_x       = lane::set(lanes[3]);
+    result.max_y       = lane::set(lanes[4]);
+    result.max_z       = lane::set(lanes[5]);
+    result.child_count = n;
+    return result;
+  }
+
+  //! Build the subtree over order[begin, end) into o_nodes, its bounds are returned in o_bounds
+  template <typename split_fn>
+  static inline index_type build_node(build_context& ctx, std::uint32_t begin, std::uint32_t end,
+                                      split_fn const& split, std::vector<node>& o_nodes, aabb_t& o_bounds)
+  {
+    range               ranges[width];
+    std::uint32_t const n    = partition(ctx, begin, end, split, ranges);
+    index_type const    self = static_cast<index_type>(o_nodes.size());
+    o_nodes.emplace_back();
+    // Bounds of inner children come back from their subtrees, only leaves read their boxes
+    aabb_t     bounds[width];
+    index_type inner[width];
+    o_bounds = detail::empty_box();
+    for (std::uint32_t k = 0; k < n; ++k)
+    {
+      if (ranges[k].end - ranges[k].begin <= k_leaf_size)
+        bounds[k] = range_bounds(ctx, ranges[k].begin, ranges[k].end);
+      else
+        inner[k] = build_node(ctx, ranges[k].begin, ranges[k].end, split, o_nodes, bounds[k]);
+      o_bounds = aabb::append(o_bounds, bounds[k]);
+    }
+    node result = make_node(ranges, bounds, n);
+    for (std::uint32_t k = 0; k < n; ++k)
+    {
+      if (!(result.child[k] & k_leaf))
+        result.child[k] = inner[k];
+    }
+    o_nodes[self] = result;
+    return self;
+  }
+
+  //! Build the tree over ctx.order with split, then copy the boxes in leaf order
+  template <typename split_fn, typename executor>
+  inline void emit(build_context& ctx, split_fn const& split, executor& exec)
+  {
+    std::uint32_t const count = static_cast<std::uint32_t>(ctx.order.size());
+    aabb_t              bounds[width];
+    if (count < k_parallel_build_size)
+      build_node(ctx, 0, count, split, nodes, bounds[0]);
+    else
+    {
+      range               ranges[width];
+      std::uint32_t const n = partition(ctx, 0, count, split, ranges);
+      std::vector<node>   subtrees[width];
+      exec(n,
+           [&](std::uint32_t t)
+           {
+             if (ranges[t].end - ranges[t].begin <= k_leaf_size)
+               bounds[t] = range_bounds(ctx, ranges[t].begin, ranges[t].end);
+             else
+               build_node(ctx, ranges[t].begin, ranges[t].end, split, subtrees[t], bounds[t]);
+           });
+
+      // Subtrees are built with local node indices, rebase them after the root
+      nodes.push_back(make_node(ranges, bounds, n));
+      for (std::uint32_t t = 0; t < n; ++t)
+      {
+        if (nodes[0].child[t] & k_leaf)
+          continue;
+        index_type const offset = static_cast<index_type>(nodes.size());
+        nodes[0].child[t]       = offset;
+        for (node& sub : subtrees[t])
+        {
+          for (std::uint32_t k = 0; k < sub.child_count; ++k)
+          {
+            if (!(sub.child[k] & k_leaf))
+              sub.child[k] += offset;
+          }
+          nodes.push_back(sub);
+        }
+      }
+    }
+
+    boxes.resize(count);
+    exec(task_count(count),
+         [&](std::uint32_t t)
+         {
+           for (std::uint32_t i = t * k_parallel_build_size, end = std::min(count, i + k_parallel_build_size);
+                i < end; ++i)
+             boxes[i] = ctx.boxes[ctx.order[i]];
+         });
+  }
+
+  std::vector<node> nodes;
+  //! Boxes in leaf order
+  std::vector<aabb_t> boxes;
+  //! Index in the build input of boxes[i]
+  std::vector<index_type> order;
+};
+
+using bvh4 = bvhn<quad>;
+using bvh8 = bvhn<quad8>;
+//! Widest node type enabled by the build flags
+using bvh = bvhn<detail::stream_lane>;
+
+} // namespace vml
@@ -14,6 +14,7 @@ namespace types = vml::fallback_types;
 
 using real_t         = float;
 using quad_t         = types::quad_t<float>;
+using quad8_t        = types::quad8_t<float>;
 using vec2_t         = types::vec2_t<float>;
 using vec3_t         = types::vec3_t<float>;
 using vec3a_t        = types::vec3a_t<float>;
@@ -25,6 +26,7 @@ using polar_coord_t  = types::polar_coord_t<float>;
 using euler_angles_t = types::euler_angles_t<float>;
 using mat4_t         = types::mat4_t<float>;
 using mat3_t         = types::mat3_t<float>;
+using affine3x4_t    = types::affine3x4_t<float>;
 using rect_t         = types::rect_t<float>;
 using aabb_t         = types::aabb_t<float>;
 using ivec2_t        = types::vec2_t<int>;
@@ -32,4 +34,37 @@ using ivec3_t        = types::vec3_t<int>;
 using ivec4_t        = types::vec4_t<int>;
 using irect_t        = types::rect_t<int>;
 using sphere_t       = types::sphere_t<float>;
+
+//! Structure of arrays vec3, lane i of x, y and z holds the i-th vector
+template <typename lane_t>
+struct vec3xn_t
+{
+  lane_t x;
+  lane_t y;
+  lane_t z;
+};
+
+//! Structure of arrays quat, lane i of x, y, z and w holds the i-th quaternion
+template <typename lane_t>
+struct quatxn_t
+{
+  lane_t x;
+  lane_t y;
+  lane_t z;
+  lane_t w;
+};
+
+//! Structure of arrays mat4, lane i of e[r][c] holds element [r][c] of the i-th matrix
+template <typename lane_t>
+struct mat4xn_t
+{
+  lane_t e[4][4];
+};
+
+using vec3x4_t = vec3xn_t<quad_t>;
+using vec3x8_t = vec3xn_t<quad8_t>;
+using quatx4_t = quatxn_t<quad_t>;
+using quatx8_t = quatxn_t<quad8_t>;
+using mat4x4_t = mat4xn_t<quad_t>;
+using mat4x8_t = mat4xn_t<quad8_t>;
 } // namespace vml
\ No newline at end of file
@@ -9,6 +9,8 @@ namespace vml::fallback_types
 
 template <typename scalar_t = float>
 using quad_t = std::array<scalar_t, 4>;
+template <typename scalar_t = float>
+using quad8_t = std::array<scalar_t, 8>;
 template <typename scalar_t>
 using vec2_t = std::array<scalar_t, 2>;
 template <typename scalar_t>
@@ -85,6 +87,7 @@ struct mat4_t
 
   mat4_t(){};
   template <typename... ScalarType>
+    requires(std::is_convertible_v<ScalarType, scalar_t> && ...)
   mat4_t(ScalarType... args) : m{static_cast<scalar_t>(args)...}
   {}
 
@@ -107,6 +110,7 @@ struct mat3_t
   };
   mat3_t(){};
   template <typename... ScalarType>
+    requires(std::is_convertible_v<ScalarType, scalar_t> && ...)
   mat3_t(ScalarType... args) : m{static_cast<scalar_t>(args)...}
   {}
 
@@ -116,6 +120,30 @@ struct mat3_t
   }
 };
 
+//! Affine transform stored as the first 3 columns of a mat4, one column per row
+template <typename scalar_t>
+struct affine3x4_t
+{
+  //! @note This is possibly non isoc++, but knowing it will work for all
+  //! compilers is why I am putting it here
+  union
+  {
+    vec4_t<scalar_t>         r[3];
+    std::array<scalar_t, 12> m;
+    scalar_t                 e[3][4];
+  };
+  affine3x4_t(){};
+  template <typename... ScalarType>
+    requires(std::is_convertible_v<ScalarType, scalar_t> && ...)
+  affine3x4_t(ScalarType... args) : m{static_cast<scalar_t>(args)...}
+  {}
+
+  inline constexpr auto operator<=>(affine3x4_t const& other) const noexcept
+  {
+    return m <=> other.m;
+  }
+};
+
 bool constexpr is_pref_cref = false;
 
 } // namespace vml::fallback_types
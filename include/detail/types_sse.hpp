@@ -21,9 +21,24 @@ struct quad_type<float>
 };
 // template <> struct quad_type<std::int32_t> { using type = __m128i; };
 
+template <typename scalar_t>
+struct quad8_type
+{
+  using type = std::array<scalar_t, 8>;
+};
+#if VML_USE_AVX
+template <>
+struct quad8_type<float>
+{
+  using type = __m256;
+};
+#endif
+
 template <typename scalar_t>
 using quad_t = typename quad_type<scalar_t>::type;
 template <typename scalar_t>
+using quad8_t = typename quad8_type<scalar_t>::type;
+template <typename scalar_t>
 using vec2_t = std::array<scalar_t, 2>;
 template <typename scalar_t>
 using vec3_t = std::array<scalar_t, 3>;
@@ -98,6 +113,7 @@ struct mat4_t
 
   mat4_t(){};
   template <typename... ScalarType>
+    requires(std::is_convertible_v<ScalarType, scalar_t> && ...)
   mat4_t(ScalarType... args) : m{static_cast<scalar_t>(args)...}
   {}
 
@@ -120,6 +136,7 @@ struct mat3_t
   };
   mat3_t(){};
   template <typename... ScalarType>
+    requires(std::is_convertible_v<ScalarType, scalar_t> && ...)
   mat3_t(ScalarType... args) : m{static_cast<scalar_t>(args)...}
   {}
 
@@ -129,6 +146,30 @@ struct mat3_t
   }
 };
 
+//! Affine transform stored as the first 3 columns of a mat4, one column per row
+template <typename scalar_t>
+struct affine3x4_t
+{
+  //! @note This is possibly non isoc++, but knowing it will work for all
+  //! compilers is why I am putting it here
+  union
+  {
+    vec4_t<scalar_t>         r[3];
+    std::array<scalar_t, 12> m;
+    scalar_t                 e[3][4];
+  };
+  affine3x4_t(){};
+  template <typename... ScalarType>
+    requires(std::is_convertible_v<ScalarType, scalar_t> && ...)
+  affine3x4_t(ScalarType... args) : m{static_cast<scalar_t>(args)...}
+  {}
+
+  inline constexpr auto operator<=>(affine3x4_t const& other) const noexcept
+  {
+    return m <=> other.m;
+  }
+};
+
 bool constexpr is_pref_cref = false;
 
 } // namespace vml::sse_types
@@ -18,10 +18,20 @@
 #define VML_API
 #endif
 
+//! 8-wide (__m256) code paths are available, when the compiler targets AVX. VML_USE_SSE_LEVEL 4 alone means SSE4.1.
+#if VML_USE_SSE_AVX && defined(__AVX__)
+#define VML_USE_AVX 1
+#else
+#define VML_USE_AVX 0
+#endif
+
 #if VML_USE_SSE_AVX
 #include <emmintrin.h>
 #include <smmintrin.h>
 #include <xmmintrin.h>
+#if VML_USE_AVX || VML_USE_FMA
+#include <immintrin.h>
+#endif
 
 #ifdef _MSC_VER
 #define vml_cast_i_to_v(v) _mm_castsi128_ps(v)
@@ -146,4 +156,23 @@ inline void deallocate(pointer_arg* mem, std::size_t size)
   return free(mem);
 #endif
 }
+
+namespace detail
+{
+/**
+ * @remarks Default executor of the overloads that split their work into tasks. An executor is
+ * called as exec(task_count, task) and must call task(t) once for every t in [0, task_count),
+ * possibly concurrently, and return once all calls are done. This one calls them in order on the
+ * calling thread.
+ */
+struct serial_executor
+{
+  template <typename task_fn>
+  inline void operator()(std::uint32_t task_count, task_fn const& task) const
+  {
+    for (std::uint32_t t = 0; t < task_count; ++t)
+      task(t);
+  }
+};
+} // namespace detail
 } // namespace vml
\ No newline at end of file
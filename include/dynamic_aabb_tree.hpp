@@ -0,0 +1,375 @@
+#pragma once
+
+#include "bvh.hpp"
+
+namespace vml
+{
+/**
+ * @remarks Incremental binary AABB tree for broadphase over moving boxes. Leaves store a fat
+ * box: the box grown by margin, and by the predicted displacement when moved. move only touches
+ * the tree when the box leaves its fat box, so small motions cost a containment test. Leaves are
+ * inserted next to the sibling with the lowest SAH cost and the path back to the root is
+ * rebalanced with AVL style rotations, keeping insert, erase and move at O(log n). Proxies are
+ * the leaf node indices, they stay valid until erased. Nodes live in a pool of cache line sized
+ * entries with a free list.
+ */
+class dynamic_aabb_tree
+{
+public:
+  using index_type = std::uint32_t;
+
+  static constexpr index_type k_null = 0xffffffff;
+
+  //! margin is added on every side of inserted and moved boxes, displacements passed to move
+  //! extend the fat box by displacement_scale times the displacement
+  dynamic_aabb_tree(float i_margin = 0.1f, float i_displacement_scale = 4.0f)
+      : margin(i_margin), displacement_scale(i_displacement_scale)
+  {}
+
+  //! Add a box, returns its proxy
+  inline index_type insert(aabb_t const& box)
+  {
+    index_type const leaf = allocate();
+    nodes[leaf].box       = grow(box, vec3a::zero());
+    nodes[leaf].height    = 0;
+    insert_leaf(leaf);
+    live++;
+    return leaf;
+  }
+
+  inline void erase(index_type proxy)
+  {
+    assert(contains(proxy) && is_leaf(proxy));
+    remove_leaf(proxy);
+    release(proxy);
+    live--;
+  }
+
+  /**
+   * @remarks Update the box of proxy, displacement is its predicted motion for the next frames.
+   * Returns true if the proxy was reinserted: the box left its fat box, or the fat box grew too
+   * large around it (more than 4 margins larger than needed).
+   */
+  inline bool move(index_type proxy, aabb_t const& box, vec3a::pref displacement)
+  {
+    assert(contains(proxy) && is_leaf(proxy));
+    aabb_t const& fat = nodes[proxy].box;
+    if (!vec3a::lesser_any(box.r[0], fat.r[0]) && !vec3a::greater_any(box.r[1], fat.r[1]))
+    {
+      aabb_t const  needed = grow(box, displacement);
+      vec3a_t const slack  = vec3a::set(4.0f * margin);
+      if (!vec3a::lesser_any(fat.r[0], vec3a::sub(needed.r[0], slack)) &&
+          !vec3a::greater_any(fat.r[1], vec3a::add(needed.r[1], slack)))
+        return false;
+    }
+    remove_leaf(proxy);
+    nodes[proxy].box = grow(box, displacement);
+    insert_leaf(proxy);
+    return true;
+  }
+
+  //! Fat box of proxy, what queries test against
+  inline aabb_t const& fat_bounds(index_type proxy) const
+  {
+    assert(contains(proxy) && is_leaf(proxy));
+    return nodes[proxy].box;
+  }
+
+  inline bool contains(index_type proxy) const noexcept
+  {
+    return proxy < nodes.size() && nodes[proxy].height >= 0;
+  }
+
+  //! Number of proxies
+  inline std::uint32_t size() const noexcept
+  {
+    return live;
+  }
+
+  //! Longest path from the root to a leaf, 0 for a single leaf
+  inline std::uint32_t height() const noexcept
+  {
+    return root == k_null ? 0 : static_cast<std::uint32_t>(nodes[root].height);
+  }
+
+  //! Bounds of all fat boxes
+  inline aabb_t bounds() const
+  {
+    return root == k_null ? detail::empty_box() : nodes[root].box;
+  }
+
+  inline void clear()
+  {
+    nodes.clear();
+    root      = k_null;
+    free_list = k_null;
+    live      = 0;
+  }
+
+  //! Call visit(proxy) for every fat box overlapping box
+  template <typename visit_fn>
+  inline void query(aabb_t const& box, visit_fn&& visit) const
+  {
+    if (root == k_null || !detail::aabb_overlap(box, nodes[root].box))
+      return;
+    detail::bvh_stack<index_type> stack;
+    stack.push(root);
+    while (!stack.empty())
+    {
+      index_type const i = stack.pop();
+      node const&      n = nodes[i];
+      if (n.height == 0)
+      {
+        visit(i);
+        continue;
+      }
+      std::uint32_t const hits = detail::aabb_overlap2(box, nodes[n.child[0]].box, nodes[n.child[1]].box);
+      if (hits & 1)
+        stack.push(n.child[0]);
+      if (hits & 2)
+        stack.push(n.child[1]);
+    }
+  }
+
+  /**
+   * @remarks Call visit(a, b), a < b, once for every pair of proxies with overlapping fat boxes.
+   * The tree is walked against itself: a node pairs with itself through its two children, and
+   * a pair of overlapping nodes descends into the larger one, testing both of its children in one
+   * call.
+   */
+  template <typename visit_fn>
+  inline void query_pairs(visit_fn&& visit) const
+  {
+    if (root == k_null || nodes[root].height == 0)
+      return;
+    struct pair
+    {
+      index_type a;
+      index_type b;
+    };
+    detail::bvh_stack<pair> stack;
+    stack.push({root, root});
+    while (!stack.empty())
+    {
+      pair const  p = stack.pop();
+      node const& a = nodes[p.a];
+      if (p.a == p.b)
+      {
+        if (a.height > 1)
+        {
+          if (nodes[a.child[0]].height > 0)
+            stack.push({a.child[0], a.child[0]});
+          if (nodes[a.child[1]].height > 0)
+            stack.push({a.child[1], a.child[1]});
+        }
+        if (detail::aabb_overlap(nodes[a.child[0]].box, nodes[a.child[1]].box))
+          stack.push({a.child[0], a.child[1]});
+        continue;
+      }
+
+      node const& b = nodes[p.b];
+      if (a.height == 0 && b.height == 0)
+      {
+        visit(std::min(p.a, p.b), std::max(p.a, p.b));
+        continue;
+      }
+      bool const          larger_a = a.height > 0 && detail::half_area(a.box) > detail::half_area(b.box);
+      bool const          split_a  = b.height == 0 || larger_a;
+      index_type const    other    = split_a ? p.b : p.a;
+      node const&         split    = split_a ? a : b;
+      aabb_t const&       box      = nodes[other].box;
+      std::uint32_t const hits     = detail::aabb_overlap2(box, nodes[split.child[0]].box, nodes[split.child[1]].box);
+      if (hits & 1)
+        stack.push({split.child[0], other});
+      if (hits & 2)
+        stack.push({split.child[1], other});
+    }
+  }
+
+private:
+  //! One cache line per node
+  struct alignas(64) node
+  {
+    //! Fat box for leaves, union of the children otherwise
+    aabb_t     box;
+    //! Next free node while in the free list
+    index_type parent;
+    //! k_null for leaves
+    index_type child[2];
+    //! 0 for leaves, -1 for free nodes
+    std::int32_t height;
+  };
+
+  inline bool is_leaf(index_type n) const noexcept
+  {
+    return nodes[n].height == 0;
+  }
+
+  //! box grown by margin, and extended along displacement * displacement_scale
+  inline aabb_t grow(aabb_t const& box, vec3a::pref displacement) const
+  {
+    vec3a_t const m = vec3a::set(margin);
+    vec3a_t const d = vec3a::mul(displacement, displacement_scale);
+    return aabb::set_min_max(vec3a::sub(vec3a::add(box.r[0], vec3a::min(d, vec3a::zero())), m),
+                             vec3a::add(vec3a::add(box.r[1], vec3a::max(d, vec3a::zero())), m));
+  }
+
+  inline index_type allocate()
+  {
+    index_type n;
+    if (free_list != k_null)
+    {
+      n         = free_list;
+      free_list = nodes[n].parent;
+    }
+    else
+    {
+      n = static_cast<index_type>(nodes.size());
+      nodes.emplace_back();
+    }
+    nodes[n].parent   = k_null;
+    nodes[n].child[0] = k_null;
+    nodes[n].child[1] = k_null;
+    nodes[n].height   = 0;
+    return n;
+  }
+
+  inline void release(index_type n)
+  {
+    nodes[n].parent = free_list;
+    nodes[n].height = -1;
+    free_list       = n;
+  }
+
+  inline void insert_leaf(index_type leaf)
+  {
+    if (root == k_null)
+    {
+      root               = leaf;
+      nodes[leaf].parent = k_null;
+      return;
+    }
+
+    // Descend towards the child with the lowest cost of holding the leaf, stop where creating a
+    // new parent for the current node is cheaper
+    aabb_t const box     = nodes[leaf].box;
+    index_type   sibling = root;
+    while (!is_leaf(sibling))
+    {
+      node const& n        = nodes[sibling];
+      float const area     = detail::half_area(n.box);
+      float const combined = detail::half_area(aabb::append(n.box, box));
+      float const cost     = 2.0f * combined;
+      // Cost pushed down to the children by enlarging this node
+      float const inherited = 2.0f * (combined - area);
+      float       child_cost[2];
+      for (std::uint32_t k = 0; k < 2; ++k)
+      {
+        node const& c = nodes[n.child[k]];
+        float const a = detail::half_area(aabb::append(c.box, box));
+        child_cost[k] = (c.height == 0 ? a : a - detail::half_area(c.box)) + inherited;
+      }
+      if (cost < child_cost[0] && cost < child_cost[1])
+        break;
+      sibling = n.child[child_cost[0] < child_cost[1] ? 0 : 1];
+    }
+
+    index_type const old_parent = nodes[sibling].parent;
+    index_type const parent     = allocate();
+    nodes[parent].parent        = old_parent;
+    nodes[parent].box           = aabb::append(box, nodes[sibling].box);
+    nodes[parent].height        = nodes[sibling].height + 1;
+    nodes[parent].child[0]      = sibling;
+    nodes[parent].child[1]      = leaf;
+    nodes[sibling].parent       = parent;
+    nodes[leaf].parent          = parent;
+    if (old_parent == k_null)
+      root = parent;
+    else
+      nodes[old_parent].child[nodes[old_parent].child[0] == sibling ? 0 : 1] = parent;
+    refit(parent);
+  }
+
+  inline void remove_leaf(index_type leaf)
+  {
+    if (leaf == root)
+    {
+      root = k_null;
+      return;
+    }
+    index_type const parent      = nodes[leaf].parent;
+    index_type const grandparent = nodes[parent].parent;
+    index_type const sibling     = nodes[parent].child[nodes[parent].child[0] == leaf ? 1 : 0];
+    nodes[sibling].parent        = grandparent;
+    release(parent);
+    if (grandparent == k_null)
+    {
+      root = sibling;
+      return;
+    }
+    nodes[grandparent].child[nodes[grandparent].child[0] == parent ? 0 : 1] = sibling;
+    refit(grandparent);
+  }
+
+  //! Rebalance n and its ancestors, recomputing their boxes and heights
+  inline void refit(index_type n)
+  {
+    for (; n != k_null; n = nodes[n].parent)
+    {
+      n               = balance(n);
+      node&       cur = nodes[n];
+      node const& c0  = nodes[cur.child[0]];
+      node const& c1  = nodes[cur.child[1]];
+      cur.height      = 1 + std::max(c0.height, c1.height);
+      cur.box         = aabb::append(c0.box, c1.box);
+    }
+  }
+
+  //! If the children of a differ in height by more than one, rotate the taller one up, returns
+  //! the node now at the position of a
+  inline index_type balance(index_type a)
+  {
+    node& na = nodes[a];
+    if (na.height < 2)
+      return a;
+    std::int32_t const diff = nodes[na.child[1]].height - nodes[na.child[0]].height;
+    if (diff >= -1 && diff <= 1)
+      return a;
+
+    // up takes the place of a, a becomes its first child and keeps the lower grandchild
+    std::uint32_t const side  = diff > 1 ? 1 : 0;
+    index_type const    up    = na.child[side];
+    index_type const    other = na.child[1 - side];
+    node&               nu    = nodes[up];
+    index_type const    f     = nu.child[0];
+    index_type const    g     = nu.child[1];
+    index_type const    keep  = nodes[f].height > nodes[g].height ? f : g;
+    index_type const    give  = keep == f ? g : f;
+
+    nu.child[0] = a;
+    nu.parent   = na.parent;
+    na.parent   = up;
+    if (nu.parent == k_null)
+      root = up;
+    else
+      nodes[nu.parent].child[nodes[nu.parent].child[0] == a ? 0 : 1] = up;
+
+    nu.child[1]        = keep;
+    na.child[side]     = give;
+    nodes[give].parent = a;
+    na.box             = aabb::append(nodes[other].box, nodes[give].box);
+    nu.box             = aabb::append(na.box, nodes[keep].box);
+    na.height          = 1 + std::max(nodes[other].height, nodes[give].height);
+    nu.height          = 1 + std::max(na.height, nodes[keep].height);
+    return up;
+  }
+
+  std::vector<node> nodes;
+  index_type        root      = k_null;
+  index_type        free_list = k_null;
+  std::uint32_t     live      = 0;
+  float             margin;
+  float             displacement_scale;
+};
+
+} // namespace vml
@@ -0,0 +1,385 @@
+#pragma once
+
+#include "ivec3.hpp"
+#include "ray_packet.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace vml
+{
+//! Uniform grid of dims cells of cell_size, cell (0, 0, 0) has its low corner at origin
+struct voxel_grid_t
+{
+  vec3a_t origin;
+  float   cell_size;
+  ivec3_t dims;
+};
+
+/**
+ * @remarks Amanatides–Woo walk of a ray through the cells of a voxel_grid_t, in order along the
+ * ray. The ray is clipped to the grid and to [0, t_max] first, then every next() steps to the
+ * neighbour across the nearest cell face, with t kept in units of the ray direction length.
+ * Typical use:
+ *   for (grid_traversal it(grid, r, t_max); it.valid(); it.next())
+ *     test(it.cell(), it.enter(), it.exit());
+ */
+class grid_traversal
+{
+public:
+  inline grid_traversal(voxel_grid_t const& i_grid, ray_t const& r, float t_max) : grid(i_grid)
+  {
+    float const inv_size = 1.0f / grid.cell_size;
+    float       t0       = 0.0f;
+    float       t1       = t_max;
+    for (std::uint32_t a = 0; a < 3; ++a)
+    {
+      // Ray in grid space, where cells are unit cubes from 0 to dims
+      float const o = (quad::get(r.origin, a) - quad::get(grid.origin, a)) * inv_size;
+      float const d = quad::get(r.direction, a) * inv_size;
+      float const n = static_cast<float>(grid.dims[a]);
+      origin[a]     = o;
+      direction[a]  = d;
+      if (d == 0.0f)
+      {
+        if (o < 0.0f || o >= n)
+          t1 = -1.0f;
+        continue;
+      }
+      float const near = (d > 0.0f ? 0.0f : n) - o;
+      float const far  = (d > 0.0f ? n : 0.0f) - o;
+      t0               = std::max(t0, near / d);
+      t1               = std::min(t1, far / d);
+    }
+    end = t1;
+    if (t0 > t1 || grid.dims[0] <= 0 || grid.dims[1] <= 0 || grid.dims[2] <= 0)
+    {
+      live = false;
+      return;
+    }
+    for (std::uint32_t a = 0; a < 3; ++a)
+    {
+      step[a]    = direction[a] > 0.0f ? 1 : (direction[a] < 0.0f ? -1 : 0);
+      delta[a]   = step[a] ? std::abs(1.0f / direction[a]) : std::numeric_limits<float>::infinity();
+      current[a] = std::clamp(static_cast<int>(std::floor(origin[a] + direction[a] * t0)), 0, grid.dims[a] - 1);
+    }
+    locate(t0);
+  }
+
+  inline grid_traversal(voxel_grid_t const& i_grid, vec3a::pref origin, vec3a::pref direction, float t_max)
+      : grid_traversal(i_grid, ray::set(origin, direction), t_max)
+  {}
+
+  //! False once the ray left the grid or passed t_max
+  inline bool valid() const noexcept
+  {
+    return live;
+  }
+
+  inline ivec3_t const& cell() const noexcept
+  {
+    return current;
+  }
+
+  //! Distance where the ray enters the current cell, or the start of the clipped ray
+  inline float enter() const noexcept
+  {
+    return t_enter;
+  }
+
+  //! Distance where the ray leaves the current cell, or the end of the clipped ray
+  inline float exit() const noexcept
+  {
+    return std::min({t_next[0], t_next[1], t_next[2], end});
+  }
+
+  //! Step to the next cell along the ray
+  inline void next()
+  {
+    std::uint32_t const a =
+      t_next[0] <= t_next[1] ? (t_next[0] <= t_next[2] ? 0 : 2) : (t_next[1] <= t_next[2] ? 1 : 2);
+    t_enter = t_next[a];
+    t_next[a] += delta[a];
+    current[a] += step[a];
+    live = t_enter < end && current[a] >= 0 && current[a] < grid.dims[a];
+  }
+
+  /**
+   * @remarks Step past the aligned block of 2^level cells per axis containing the current cell, to
+   * the first cell after it along the ray. skip(0) is next(), larger levels jump over empty space
+   * found in coarser occupancy levels.
+   */
+  inline void skip(std::uint32_t level)
+  {
+    if (!level)
+    {
+      next();
+      return;
+    }
+    // Leave through the nearest far face of the block, the other axes stay within the block and the grid
+    int           lo[3];
+    int           hi[3];
+    float         leave = std::numeric_limits<float>::infinity();
+    std::uint32_t axis  = 0;
+    for (std::uint32_t a = 0; a < 3; ++a)
+    {
+      lo[a] = (current[a] >> level) << level;
+      hi[a] = lo[a] + (1 << level) - 1;
+      if (!step[a])
+        continue;
+      float const t = (static_cast<float>(step[a] > 0 ? hi[a] + 1 : lo[a]) - origin[a]) / direction[a];
+      if (t < leave)
+      {
+        leave = t;
+        axis  = a;
+      }
+    }
+    leave = std::max(leave, t_enter);
+    for (std::uint32_t a = 0; a < 3; ++a)
+    {
+      if (a == axis)
+        current[a] = step[a] > 0 ? hi[a] + 1 : lo[a] - 1;
+      else
+        current[a] = std::clamp(static_cast<int>(std::floor(origin[a] + direction[a] * leave)), lo[a],
+                                std::min(hi[a], grid.dims[a] - 1));
+    }
+    live = leave < end && current[axis] >= 0 && current[axis] < grid.dims[axis];
+    if (live)
+      locate(leave);
+  }
+
+private:
+  template <typename>
+  friend class grid_traversaln;
+
+  //! Set the crossing distances of the current cell, entered at t
+  inline void locate(float t)
+  {
+    t_enter = t;
+    for (std::uint32_t a = 0; a < 3; ++a)
+      t_next[a] = step[a] ? (static_cast<float>(current[a] + (step[a] > 0)) - origin[a]) / direction[a]
+                          : std::numeric_limits<float>::infinity();
+  }
+
+  voxel_grid_t grid;
+  float        origin[3]    = {};
+  float        direction[3] = {};
+  //! Distance to the next face crossing on each axis
+  float t_next[3] = {};
+  //! Distance between face crossings on each axis
+  float   delta[3] = {};
+  int     step[3]  = {};
+  ivec3_t current  = {0, 0, 0};
+  float   t_enter  = 0.0f;
+  float   end      = 0.0f;
+  bool    live     = true;
+};
+
+/**
+ * @remarks element_count rays of quad (4) or quad8 (8) walked through a grid in lockstep, each
+ * next() steps every active ray to its next cell with a few compares and selects. Lane k follows
+ * ray k as grid_traversal would. Rays drop out of active() as they leave the grid, callers stop
+ * the others, for instance on a hit, with stop.
+ */
+template <typename lane>
+class grid_traversaln
+{
+public:
+  using lane_type = typename lane::type;
+
+  enum : unsigned int
+  {
+    element_count = lane::element_count
+  };
+
+  inline grid_traversaln(voxel_grid_t const& i_grid, ray_t const* rays, float t_max)
+  {
+    alignas(32) float state[14][element_count];
+    for (std::uint32_t k = 0; k < element_count; ++k)
+    {
+      grid_traversal const w(i_grid, rays[k], t_max);
+      for (std::uint32_t a = 0; a < 3; ++a)
+      {
+        state[a][k]     = static_cast<float>(w.current[a]);
+        state[3 + a][k] = w.t_next[a];
+        state[6 + a][k] = w.delta[a];
+        state[9 + a][k] = static_cast<float>(w.step[a]);
+      }
+      state[12][k] = w.t_enter;
+      state[13][k] = w.end;
+      live_mask |= w.live ? 1u << k : 0u;
+    }
+    for (std::uint32_t a = 0; a < 3; ++a)
+    {
+      current[a] = lane::set(state[a]);
+      t_next[a]  = lane::set(state[3 + a]);
+      delta[a]   = lane::set(state[6 + a]);
+      step[a]    = lane::set(state[9 + a]);
+      dims[a]    = lane::set(static_cast<float>(i_grid.dims[a]));
+    }
+    t_enter = lane::set(state[12]);
+    end     = lane::set(state[13]);
+    live    = ray_packetn<lane>::lanes(live_mask);
+  }
+
+  //! Mask of the rays still walking, bit k for ray k
+  inline std::uint32_t active() const noexcept
+  {
+    return live_mask;
+  }
+
+  inline ivec3_t cell(std::uint32_t k) const
+  {
+    return {static_cast<int>(lane::get(current[0], k)), static_cast<int>(lane::get(current[1], k)),
+            static_cast<int>(lane::get(current[2], k))};
+  }
+
+  //! Distances where the rays enter their current cell
+  inline lane_type enter() const
+  {
+    return t_enter;
+  }
+
+  //! Distances where the rays leave their current cell
+  inline lane_type exit() const
+  {
+    return lane::min(lane::min(t_next[0], t_next[1]), lane::min(t_next[2], end));
+  }
+
+  //! Step every active ray to its next cell
+  inline void next()
+  {
+    lane_type const zero = lane::zero();
+    // One axis per ray, the one with the nearest crossing, ties go to x then y as in grid_traversal
+    lane_type const x =
+      lane::bit_and(lane::lesser_equalv(t_next[0], t_next[1]), lane::lesser_equalv(t_next[0], t_next[2]));
+    lane_type const axes[3] = {x, lane::select(lane::lesser_equalv(t_next[1], t_next[2]), zero, x),
+                               lane::lesserv(t_next[2], lane::min(t_next[0], t_next[1]))};
+    t_enter                 = lane::min(lane::min(t_next[0], t_next[1]), t_next[2]);
+    lane_type in            = lane::bit_and(live, lane::lesserv(t_enter, end));
+    for (std::uint32_t a = 0; a < 3; ++a)
+    {
+      lane_type const m = lane::bit_and(axes[a], live);
+      current[a]        = lane::select(current[a], lane::add(current[a], step[a]), m);
+      t_next[a]         = lane::select(t_next[a], lane::add(t_next[a], delta[a]), m);
+      in                = lane::bit_and(in, lane::greater_equalv(current[a], zero));
+      in                = lane::bit_and(in, lane::lesserv(current[a], dims[a]));
+    }
+    live      = in;
+    live_mask = lane::mask(live);
+  }
+
+  //! Stop the rays in mask
+  inline void stop(std::uint32_t mask)
+  {
+    live_mask &= ~mask;
+    live = ray_packetn<lane>::lanes(live_mask);
+  }
+
+private:
+  lane_type     current[3];
+  lane_type     t_next[3];
+  lane_type     delta[3];
+  lane_type     step[3];
+  lane_type     dims[3];
+  lane_type     t_enter;
+  lane_type     end;
+  lane_type     live;
+  std::uint32_t live_mask = 0;
+};
+
+using grid_traversal4 = grid_traversaln<quad>;
+using grid_traversal8 = grid_traversaln<quad8>;
+
+/**
+ * @remarks Occupancy of a voxel_grid_t and its mip chain, level l cell c is occupied if any of
+ * the level 0 cells in the block of 2^l cells per axis at c * 2^l is. raymarch walks a ray with
+ * grid_traversal and jumps over the largest empty block around each empty cell, so long empty
+ * stretches cost a few steps instead of one per cell.
+ */
+class occupancy_mip
+{
+public:
+  /**
+   * @remarks Build from one byte per cell of a dims grid, non zero if occupied, x fastest then y
+   * then z. Levels are added until one cell covers the grid.
+   */
+  inline void build(ivec3_t const& i_dims, std::span<std::uint8_t const> i_occupied)
+  {
+    levels.clear();
+    level_dims.clear();
+    levels.emplace_back(i_occupied.begin(), i_occupied.end());
+    level_dims.push_back(i_dims);
+    while (level_dims.back()[0] > 1 || level_dims.back()[1] > 1 || level_dims.back()[2] > 1)
+    {
+      ivec3_t const                    fine   = level_dims.back();
+      ivec3_t const                    coarse = {(fine[0] + 1) / 2, (fine[1] + 1) / 2, (fine[2] + 1) / 2};
+      std::vector<std::uint8_t>        next(static_cast<std::size_t>(coarse[0]) * coarse[1] * coarse[2], 0);
+      std::vector<std::uint8_t> const& src = levels.back();
+      for (int z = 0; z < fine[2]; ++z)
+      {
+        for (int y = 0; y < fine[1]; ++y)
+        {
+          for (int x = 0; x < fine[0]; ++x)
+          {
+            if (src[(static_cast<std::size_t>(z) * fine[1] + y) * fine[0] + x])
+              next[(static_cast<std::size_t>(z / 2) * coarse[1] + y / 2) * coarse[0] + x / 2] = 1;
+          }
+        }
+      }
+      levels.push_back(std::move(next));
+      level_dims.push_back(coarse);
+    }
+  }
+
+  //! Number of levels, level 0 is the grid itself
+  inline std::uint32_t level_count() const noexcept
+  {
+    return static_cast<std::uint32_t>(levels.size());
+  }
+
+  //! Occupancy of cell c of level, which must be within that level
+  inline bool occupied(std::uint32_t level, ivec3_t const& c) const
+  {
+    ivec3_t const& d = level_dims[level];
+    return levels[level][(static_cast<std::size_t>(c[2]) * d[1] + c[1]) * d[0] + c[0]] != 0;
+  }
+
+  /**
+   * @remarks Call visit(cell, enter, exit) for the occupied cells hit by r within [0, t_max] in
+   * order along the ray, grid must have the dims given to build. visit returns true to stop, and
+   * raymarch returns true if it did.
+   */
+  template <typename visit_fn>
+  inline bool raymarch(voxel_grid_t const& grid, ray_t const& r, float t_max, visit_fn&& visit) const
+  {
+    if (levels.empty())
+      return false;
+    for (grid_traversal it(grid, r, t_max); it.valid();)
+    {
+      ivec3_t const& c = it.cell();
+      if (occupied(0, c))
+      {
+        if (visit(c, it.enter(), it.exit()))
+          return true;
+        it.next();
+        continue;
+      }
+      // Largest empty block around the cell
+      std::uint32_t level = 0;
+      while (level + 1 < levels.size() &&
+             !occupied(level + 1, {c[0] >> (level + 1), c[1] >> (level + 1), c[2] >> (level + 1)}))
+        level++;
+      it.skip(level);
+    }
+    return false;
+  }
+
+private:
+  std::vector<std::vector<std::uint8_t>> levels;
+  std::vector<ivec3_t>                   level_dims;
+};
+
+} // namespace vml
@@ -1,5 +1,5 @@
 
-#include <intersect.hpp>
+#include "intersect_cull.hpp"
 
 namespace vml
 {
@@ -83,5 +83,33 @@ VML_API result_t bounding_sphere_frustum(sphere::pref i_sphere, frustum_t const&
   }
   return result_t::k_inside;
 }
+
+VML_API void bounding_volumes_frustum(std::span<bounding_volume_t const> i_vols, frustum_t const& i_frustum,
+                                      std::span<std::uint32_t> o_results)
+{
+  detail::cull_results(i_vols.data(), static_cast<std::uint32_t>(i_vols.size()), i_frustum, o_results.data(),
+                       static_cast<std::uint32_t>(o_results.size()));
+}
+
+VML_API void bounding_volumes_frustum_visibility(std::span<bounding_volume_t const> i_vols, frustum_t const& i_frustum,
+                                                 std::span<std::uint32_t> o_visible)
+{
+  detail::cull_visibility(i_vols.data(), static_cast<std::uint32_t>(i_vols.size()), i_frustum, o_visible.data(),
+                          static_cast<std::uint32_t>(o_visible.size()));
+}
+
+VML_API void bounding_volumes_frustum(std::span<sphere_box_t const> i_vols, frustum_t const& i_frustum,
+                                      std::span<std::uint32_t> o_results)
+{
+  detail::cull_results(i_vols.data(), static_cast<std::uint32_t>(i_vols.size()), i_frustum, o_results.data(),
+                       static_cast<std::uint32_t>(o_results.size()));
+}
+
+VML_API void bounding_volumes_frustum_visibility(std::span<sphere_box_t const> i_vols, frustum_t const& i_frustum,
+                                                 std::span<std::uint32_t> o_visible)
+{
+  detail::cull_visibility(i_vols.data(), static_cast<std::uint32_t>(i_vols.size()), i_frustum, o_visible.data(),
+                          static_cast<std::uint32_t>(o_visible.size()));
+}
 } // namespace intersect
 } // namespace vml
\ No newline at end of file
@@ -0,0 +1,188 @@
+#pragma once
+// Frustum culling core shared by impl/intersect.hpp and the vml_kernels instruction set variants. It
+// takes raw pointers and uses no std:: templates: a vml_kernels variant renames the vml namespace but
+// not std, and std:: instantiations emitted per instruction set would be merged by the linker.
+#include <intersect.hpp>
+#include <quad8.hpp>
+
+namespace vml
+{
+namespace intersect
+{
+namespace detail
+{
+#if VML_USE_AVX
+constexpr std::uint32_t k_cull_lanes = 8;
+#else
+constexpr std::uint32_t k_cull_lanes = 4;
+#endif
+
+//! Spread the low 8 bits of x to the even bits of a 16 bit value
+inline std::uint32_t spread_bits(std::uint32_t x)
+{
+  x = (x | (x << 4)) & 0x0f0f;
+  x = (x | (x << 2)) & 0x3333;
+  x = (x | (x << 1)) & 0x5555;
+  return x;
+}
+
+//! Calls emit(first, outside, intersecting) for every k_cull_lanes volumes with a bit per lane in each mask.
+//! Lanes past the end of i_vols repeat the last volume and must be masked off by emit. volume_t is
+//! bounding_volume_t or sphere_box_t, only spherical_vol and half_extends are read.
+template <typename volume_t, typename emit_fn>
+inline void cull_volumes(volume_t const* i_vols, std::uint32_t i_count, frustum_t const& i_frustum, emit_fn&& emit)
+{
+  plane_t const*      planes      = i_frustum.get_all();
+  std::uint32_t const plane_count = i_frustum.count();
+
+  auto at = [i_vols, last = i_count - 1](std::uint32_t i) -> volume_t const&
+  {
+    return i_vols[i < last ? i : last];
+  };
+
+  for (std::uint32_t i = 0; i < i_count; i += k_cull_lanes)
+  {
+#if VML_USE_AVX
+    // Transpose 8 volumes so that each register holds one component for all of them
+    auto transpose = [&](quad_t volume_t::*field, quad8_t& x, quad8_t& y, quad8_t& z)
+    {
+      quad8_t r0 = quad8::set(at(i + 0).*field, at(i + 4).*field);
+      quad8_t r1 = quad8::set(at(i + 1).*field, at(i + 5).*field);
+      quad8_t r2 = quad8::set(at(i + 2).*field, at(i + 6).*field);
+      quad8_t r3 = quad8::set(at(i + 3).*field, at(i + 7).*field);
+      quad8_t t0 = _mm256_unpacklo_ps(r0, r1);
+      quad8_t t1 = _mm256_unpackhi_ps(r0, r1);
+      quad8_t t2 = _mm256_unpacklo_ps(r2, r3);
+      quad8_t t3 = _mm256_unpackhi_ps(r2, r3);
+      x          = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+      y          = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+      z          = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    };
+
+    quad8_t cx, cy, cz, ex, ey, ez;
+    transpose(&volume_t::spherical_vol, cx, cy, cz);
+    transpose(&volume_t::half_extends, ex, ey, ez);
+
+    quad8_t const zero         = quad8::zero();
+    quad8_t       outside      = zero;
+    quad8_t       intersecting = zero;
+    for (std::uint32_t p = 0; p < plane_count; ++p)
+    {
+      float const* plane = reinterpret_cast<float const*>(planes + p);
+      quad8_t      nx    = quad8::set(plane[0]);
+      quad8_t      ny    = quad8::set(plane[1]);
+      quad8_t      nz    = quad8::set(plane[2]);
+      quad8_t      m     = quad8::madd(nx, cx, quad8::set(plane[3]));
+      m                  = quad8::madd(ny, cy, m);
+      m                  = quad8::madd(nz, cz, m);
+      quad8_t n          = quad8::mul(quad8::abs(nx), ex);
+      n                  = quad8::madd(quad8::abs(ny), ey, n);
+      n                  = quad8::madd(quad8::abs(nz), ez, n);
+      outside            = quad8::bit_or(outside, quad8::lesserv(quad8::add(m, n), zero));
+      intersecting       = quad8::bit_or(intersecting, quad8::lesserv(quad8::sub(m, n), zero));
+    }
+    emit(i, quad8::mask(outside), quad8::mask(intersecting));
+#elif VML_USE_SSE_AVX
+    // Transpose 4 volumes so that each register holds one component for all of them
+    quad_t cx = at(i + 0).spherical_vol;
+    quad_t cy = at(i + 1).spherical_vol;
+    quad_t cz = at(i + 2).spherical_vol;
+    quad_t cw = at(i + 3).spherical_vol;
+    _MM_TRANSPOSE4_PS(cx, cy, cz, cw);
+    quad_t ex = at(i + 0).half_extends;
+    quad_t ey = at(i + 1).half_extends;
+    quad_t ez = at(i + 2).half_extends;
+    quad_t ew = at(i + 3).half_extends;
+    _MM_TRANSPOSE4_PS(ex, ey, ez, ew);
+
+    quad_t const clear_sign   = vml_cast_i_to_v(_mm_set1_epi32(0x7fffffff));
+    quad_t const zero         = _mm_setzero_ps();
+    quad_t       outside      = zero;
+    quad_t       intersecting = zero;
+    for (std::uint32_t p = 0; p < plane_count; ++p)
+    {
+      float const* plane = reinterpret_cast<float const*>(planes + p);
+      quad_t       nx    = _mm_load_ps1(plane + 0);
+      quad_t       ny    = _mm_load_ps1(plane + 1);
+      quad_t       nz    = _mm_load_ps1(plane + 2);
+      quad_t       m     = quad::madd(nx, cx, _mm_load_ps1(plane + 3));
+      m                  = quad::madd(ny, cy, m);
+      m                  = quad::madd(nz, cz, m);
+      quad_t n           = _mm_mul_ps(_mm_and_ps(nx, clear_sign), ex);
+      n                  = quad::madd(_mm_and_ps(ny, clear_sign), ey, n);
+      n                  = quad::madd(_mm_and_ps(nz, clear_sign), ez, n);
+      outside            = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(m, n), zero));
+      intersecting       = _mm_or_ps(intersecting, _mm_cmplt_ps(_mm_sub_ps(m, n), zero));
+    }
+    emit(i, static_cast<std::uint32_t>(_mm_movemask_ps(outside)),
+         static_cast<std::uint32_t>(_mm_movemask_ps(intersecting)));
+#else
+    std::uint32_t outside      = 0;
+    std::uint32_t intersecting = 0;
+    for (std::uint32_t j = 0; j < k_cull_lanes; ++j)
+    {
+      volume_t const& vol = at(i + j);
+      for (std::uint32_t p = 0; p < plane_count; ++p)
+      {
+        float const* plane = reinterpret_cast<float const*>(planes + p);
+        float        m     = plane[3];
+        float        n     = 0.0f;
+        for (std::uint32_t k = 0; k < 3; ++k)
+        {
+          m += plane[k] * vol.spherical_vol[k];
+          n += vml::abs(plane[k]) * vol.half_extends[k];
+        }
+        outside |= static_cast<std::uint32_t>(m + n < 0.0f) << j;
+        intersecting |= static_cast<std::uint32_t>(m - n < 0.0f) << j;
+      }
+    }
+    emit(i, outside, intersecting);
+#endif
+  }
+}
+
+//! Mask of the lanes in [first, first + k_cull_lanes) below count
+inline std::uint32_t valid_lanes(std::uint32_t count, std::uint32_t first)
+{
+  std::uint32_t const left = count - first;
+  return (1u << (left < k_cull_lanes ? left : k_cull_lanes)) - 1;
+}
+
+//! bounding_volumes_frustum for either volume layout, o_results holds i_result_count words
+template <typename volume_t>
+inline void cull_results(volume_t const* i_vols, std::uint32_t i_count, frustum_t const& i_frustum,
+                         std::uint32_t* o_results, [[maybe_unused]] std::uint32_t i_result_count)
+{
+  assert(i_result_count >= (i_count + 15) / 16);
+  for (std::uint32_t w = 0; w < (i_count + 15) / 16; ++w)
+    o_results[w] = 0;
+
+  cull_volumes(i_vols, i_count, i_frustum,
+               [i_count, o_results](std::uint32_t first, std::uint32_t outside, std::uint32_t intersecting)
+               {
+                 std::uint32_t valid  = valid_lanes(i_count, first);
+                 std::uint32_t inside = ~outside & valid;
+                 std::uint32_t codes  = spread_bits(inside & ~intersecting) | (spread_bits(inside & intersecting) << 1);
+                 o_results[first >> 4] |= codes << ((first & 15) << 1);
+               });
+}
+
+//! bounding_volumes_frustum_visibility for either volume layout, o_visible holds i_visible_count words
+template <typename volume_t>
+inline void cull_visibility(volume_t const* i_vols, std::uint32_t i_count, frustum_t const& i_frustum,
+                            std::uint32_t* o_visible, [[maybe_unused]] std::uint32_t i_visible_count)
+{
+  assert(i_visible_count >= (i_count + 31) / 32);
+  for (std::uint32_t w = 0; w < (i_count + 31) / 32; ++w)
+    o_visible[w] = 0;
+
+  cull_volumes(i_vols, i_count, i_frustum,
+               [i_count, o_visible](std::uint32_t first, std::uint32_t outside, std::uint32_t)
+               {
+                 std::uint32_t valid = valid_lanes(i_count, first);
+                 o_visible[first >> 5] |= (~outside & valid) << (first & 31);
+               });
+}
+} // namespace detail
+} // namespace intersect
+} // namespace vml
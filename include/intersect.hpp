@@ -2,6 +2,7 @@
 #include "bounding_volume.hpp"
 #include "frustum.hpp"
 #include "sphere.hpp"
+#include <span>
 
 namespace vml::intersect
 {
@@ -29,6 +30,33 @@ VML_API result_t bounding_volume_frustum(bounding_volume_t const& i_vol, frustum
 /** @remarks Intersect sphere with frustum_t */
 VML_API result_t bounding_sphere_frustum(sphere::pref i_sphere, frustum_t const& i_frustum);
 
+/**
+ * @remarks Test an array of bounding volumes against a frustum_t, 4 (SSE) or 8 (AVX) volumes per plane.
+ *          The result_t of volume i is packed as 2 bits at bit 2 * (i % 16) of o_results[i / 16], so
+ *          o_results must hold at least (count + 15) / 16 words. Every plane is tested, so results
+ *          match bounding_volume_frustum_coherent with a fresh coherency.
+ */
+VML_API void bounding_volumes_frustum(std::span<bounding_volume_t const> i_vols, frustum_t const& i_frustum,
+                                      std::span<std::uint32_t> o_results);
+
+/**
+ * @remarks Test an array of bounding volumes against a frustum_t, setting bit i % 32 of o_visible[i / 32]
+ *          if volume i is inside or intersecting. o_visible must hold at least (count + 31) / 32 words.
+ */
+VML_API void bounding_volumes_frustum_visibility(std::span<bounding_volume_t const> i_vols, frustum_t const& i_frustum,
+                                                 std::span<std::uint32_t> o_visible);
+
+/**
+ * @remarks Same as bounding_volumes_frustum for the hot half of split volumes (see sphere_box_t),
+ *          reading 32 bytes per volume instead of 64.
+ */
+VML_API void bounding_volumes_frustum(std::span<sphere_box_t const> i_vols, frustum_t const& i_frustum,
+                                      std::span<std::uint32_t> o_results);
+
+/** @remarks Same as bounding_volumes_frustum_visibility for the hot half of split volumes */
+VML_API void bounding_volumes_frustum_visibility(std::span<sphere_box_t const> i_vols, frustum_t const& i_frustum,
+                                                 std::span<std::uint32_t> o_visible);
+
 inline result_t bounding_volumes(bounding_volume_t const& vol1, bounding_volume_t const& vol2)
 {
 
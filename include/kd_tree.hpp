@@ -0,0 +1,501 @@
+#pragma once
+
+#include "bvh.hpp"
+
+namespace vml
+{
+/**
+ * @remarks kd-tree over points for nearest neighbour and radius queries on large point clouds.
+ * The tree is implicit: median splits keep it balanced, so node j of level l holds the points
+ * [(j * n) >> l, ((j + 1) * n) >> l) of the build order and only the split value and axis of each
+ * inner node are stored, breadth first. The 2^depth leaves hold 8 to 16 points each in SoA
+ * blocks, so distances to a leaf take k_leaf_size / element_count lane evaluations. Each level of
+ * the build is split into tasks for the executor passed to build. Queries report points by their
+ * index in the span given to build.
+ */
+template <typename lane>
+class kd_treen
+{
+public:
+  using lane_type  = typename lane::type;
+  using index_type = std::uint32_t;
+
+  enum : unsigned int
+  {
+    width = lane::element_count
+  };
+
+  //! Largest number of points in a leaf, leaves hold at least half as many once the tree splits
+  static constexpr std::uint32_t k_leaf_size = 16;
+  //! Builds and batched queries run their per point passes as tasks of this many points
+  static constexpr std::uint32_t k_parallel_task_size = 16384;
+
+  //! Points of a leaf in SoA, slots past the leaf point count are unused
+  struct alignas(64) leaf
+  {
+    float      x[k_leaf_size];
+    float      y[k_leaf_size];
+    float      z[k_leaf_size];
+    index_type index[k_leaf_size];
+  };
+
+  /**
+   * @remarks Build over points, the w component is ignored, any previous content is dropped. Each
+   * level splits its nodes as tasks of exec covering about k_parallel_task_size points, see
+   * detail::serial_executor.
+   */
+  template <typename executor = detail::serial_executor>
+  inline void build(std::span<vec3a_t const> i_points, executor&& exec = {})
+  {
+    clear();
+    count = static_cast<std::uint32_t>(i_points.size());
+    if (!count)
+      return;
+    while (count > (std::uint64_t(k_leaf_size) << depth))
+      depth++;
+
+    std::uint32_t const tasks = task_count(count);
+    std::vector<point>  points(count);
+    std::vector<aabb_t> task_bounds(tasks, detail::empty_box());
+    exec(tasks,
+         [&](std::uint32_t t)
+         {
+           for (std::uint32_t i = t * k_parallel_task_size, end = std::min(count, i + k_parallel_task_size); i < end;
+                ++i)
+           {
+             points[i]      = {{vec3a::x(i_points[i]), vec3a::y(i_points[i]), vec3a::z(i_points[i])}, i};
+             task_bounds[t] = aabb::append(task_bounds[t], i_points[i]);
+           }
+         });
+    for (aabb_t const& b : task_bounds)
+      point_bounds = aabb::append(point_bounds, b);
+
+    split_values.resize(inner_count());
+    split_axes.resize(inner_count());
+    for (std::uint32_t level = 0; level < depth; ++level)
+    {
+      std::uint32_t const level_nodes = 1u << level;
+      std::uint32_t const level_tasks = std::min(level_nodes, tasks);
+      exec(level_tasks,
+           [&](std::uint32_t t)
+           {
+             for (std::uint32_t j = slice(t, level_nodes, level_tasks), end = slice(t + 1, level_nodes, level_tasks);
+                  j < end; ++j)
+               split(points, level, j);
+           });
+    }
+
+    std::uint32_t const leaf_count = 1u << depth;
+    std::uint32_t const leaf_tasks = std::min(leaf_count, tasks);
+    leaves.resize(leaf_count);
+    exec(leaf_tasks,
+         [&](std::uint32_t t)
+         {
+           for (std::uint32_t j = slice(t, leaf_count, leaf_tasks), end = slice(t + 1, leaf_count, leaf_tasks);
+                j < end; ++j)
+           {
+             leaf&               l     = leaves[j];
+             std::uint32_t const begin = range_begin(depth, j);
+             std::uint32_t const n     = range_begin(depth, j + 1) - begin;
+             for (std::uint32_t s = 0; s < k_leaf_size; ++s)
+             {
+               point const p = s < n ? points[begin + s] : point{{0.0f, 0.0f, 0.0f}, 0};
+               l.x[s]        = p.c[0];
+               l.y[s]        = p.c[1];
+               l.z[s]        = p.c[2];
+               l.index[s]    = p.index;
+             }
+           }
+         });
+  }
+
+  //! Fill o_indices with the points closest to point, nearest first, returns how many were found
+  inline std::uint32_t nearest(vec3a::pref point, std::span<index_type> o_indices) const
+  {
+    vec3a_t const query[1] = {point};
+    std::uint32_t found    = 0;
+    nearest(query, static_cast<std::uint32_t>(o_indices.size()), o_indices, std::span<std::uint32_t>(&found, 1));
+    return found;
+  }
+
+  /**
+   * @remarks k nearest points of each of i_points: o_indices[i * k, i * k + o_counts[i]) receives
+   * those of i_points[i], nearest first. Queries are sorted by the leaf they fall in, and the
+   * queries of a leaf are answered together: their heaps are seeded from that leaf, then the tree
+   * is walked once for all of them, skipping nodes farther from the bounds of the queries than the
+   * worst distance any of them keeps. Queries run as tasks of k_parallel_task_size points.
+   */
+  template <typename executor = detail::serial_executor>
+  inline void nearest(std::span<vec3a_t const> i_points, std::uint32_t k, std::span<index_type> o_indices,
+                      std::span<std::uint32_t> o_counts, executor&& exec = {}) const
+  {
+    assert(o_indices.size() >= i_points.size() * k && o_counts.size() >= i_points.size());
+    std::uint32_t const query_count = static_cast<std::uint32_t>(i_points.size());
+    if (!count || !k)
+    {
+      std::fill_n(o_counts.begin(), query_count, 0u);
+      return;
+    }
+
+    std::uint32_t const        tasks = task_count(query_count);
+    std::vector<std::uint32_t> homes(query_count);
+    std::vector<std::uint32_t> queries(query_count);
+    exec(tasks,
+         [&](std::uint32_t t)
+         {
+           for (std::uint32_t i = t * k_parallel_task_size, end = std::min(query_count, i + k_parallel_task_size);
+                i < end; ++i)
+           {
+             homes[i]   = leaf_of(i_points[i]);
+             queries[i] = i;
+           }
+         });
+    detail::radix_sort(homes, queries, depth, k_parallel_task_size, exec);
+
+    std::uint32_t const heap_size = std::min(k, count);
+    exec(tasks,
+         [&](std::uint32_t t)
+         {
+           std::vector<std::pair<float, index_type>> storage;
+           std::vector<knn_heap>                     heaps;
+           std::uint32_t const                       end = std::min(query_count, (t + 1) * k_parallel_task_size);
+           for (std::uint32_t begin = t * k_parallel_task_size, next; begin < end; begin = next)
+           {
+             for (next = begin + 1; next < end && homes[next] == homes[begin]; ++next)
+               ;
+             std::uint32_t const group = next - begin;
+             storage.resize(group * heap_size);
+             heaps.resize(group);
+             for (std::uint32_t q = 0; q < group; ++q)
+               heaps[q] = {storage.data() + q * heap_size, 0, heap_size};
+             search(i_points, queries.data() + begin, heaps.data(), group, homes[begin]);
+             for (std::uint32_t q = 0; q < group; ++q)
+             {
+               std::uint32_t const query = queries[begin + q];
+               knn_heap const&     heap  = heaps[q];
+               std::sort_heap(heap.data, heap.data + heap.size);
+               for (std::uint32_t i = 0; i < heap.size; ++i)
+                 o_indices[query * k + i] = heap.data[i].second;
+               o_counts[query] = heap.size;
+             }
+           }
+         });
+  }
+
+  //! Call visit(index) for every point within the sphere
+  template <typename visit_fn>
+  inline void query(sphere_t const& i_sphere, visit_fn&& visit) const
+  {
+    if (!count)
+      return;
+    float const   radius = sphere::radius(i_sphere);
+    float const   r2     = radius * radius;
+    vec3a_t const center = sphere::center(i_sphere);
+    float const   c[3]   = {vec3a::x(center), vec3a::y(center), vec3a::z(center)};
+    walk(
+      c, c,
+      [&](region const& r)
+      {
+        return gap(r, c, c) <= r2;
+      },
+      [&](std::uint32_t l, region const&)
+      {
+        leaf const&     lf    = leaves[l];
+        lane_type const limit = lane::set(r2);
+        for (std::uint32_t s = 0; s < k_leaf_size; s += width)
+        {
+          std::uint32_t hits = lane::mask(lane::lesser_equalv(leaf_sqdistance(lf, s, center), limit)) & valid(l, s);
+          for (; hits; hits &= hits - 1)
+            visit(lf.index[s + std::countr_zero(hits)]);
+        }
+      });
+  }
+
+  //! Number of points
+  inline std::uint32_t size() const noexcept
+  {
+    return count;
+  }
+
+  inline bool empty() const noexcept
+  {
+    return count == 0;
+  }
+
+  //! Number of levels above the leaves
+  inline std::uint32_t height() const noexcept
+  {
+    return depth;
+  }
+
+  //! Bounds of all points
+  inline aabb_t bounds() const
+  {
+    return point_bounds;
+  }
+
+  inline void clear()
+  {
+    split_values.clear();
+    split_axes.clear();
+    leaves.clear();
+    point_bounds = detail::empty_box();
+    count        = 0;
+    depth        = 0;
+  }
+
+private:
+  //! Build record, sorted in place by the splits
+  struct point
+  {
+    float      c[3];
+    index_type index;
+  };
+
+  //! Bounds of a node, narrowed by the splits above it
+  struct region
+  {
+    float      lo[3];
+    float      hi[3];
+    index_type node;
+  };
+
+  //! Max heap on squared distance of the best size <= k points so far
+  struct knn_heap
+  {
+    std::pair<float, index_type>* data;
+    std::uint32_t                 size;
+    std::uint32_t                 k;
+
+    inline float worst() const noexcept
+    {
+      return size < k ? std::numeric_limits<float>::infinity() : data[0].first;
+    }
+
+    inline void push(float d2, index_type index)
+    {
+      if (size < k)
+      {
+        data[size++] = {d2, index};
+        std::push_heap(data, data + size);
+      }
+      else if (d2 < data[0].first)
+      {
+        std::pop_heap(data, data + size);
+        data[size - 1] = {d2, index};
+        std::push_heap(data, data + size);
+      }
+    }
+  };
+
+  static inline std::uint32_t task_count(std::uint32_t n)
+  {
+    return (n + k_parallel_task_size - 1) / k_parallel_task_size;
+  }
+
+  //! First of n items handled by task t out of tasks
+  static inline std::uint32_t slice(std::uint32_t t, std::uint32_t n, std::uint32_t tasks)
+  {
+    return static_cast<std::uint32_t>(std::uint64_t(t) * n / tasks);
+  }
+
+  inline std::uint32_t inner_count() const noexcept
+  {
+    return (1u << depth) - 1;
+  }
+
+  //! First point of node j at level, the node ends where node j + 1 starts
+  inline std::uint32_t range_begin(std::uint32_t level, std::uint32_t j) const noexcept
+  {
+    return static_cast<std::uint32_t>((std::uint64_t(j) * count) >> level);
+  }
+
+  //! Split node j of level at the median of its axis of largest extent
+  inline void split(std::vector<point>& points, std::uint32_t level, std::uint32_t j)
+  {
+    std::uint32_t const begin = range_begin(level, j);
+    std::uint32_t const end   = range_begin(level, j + 1);
+    std::uint32_t const mid   = range_begin(level + 1, 2 * j + 1);
+    float               lo[3] = {points[begin].c[0], points[begin].c[1], points[begin].c[2]};
+    float               hi[3] = {lo[0], lo[1], lo[2]};
+    for (std::uint32_t i = begin + 1; i < end; ++i)
+    {
+      for (std::uint32_t a = 0; a < 3; ++a)
+      {
+        lo[a] = std::min(lo[a], points[i].c[a]);
+        hi[a] = std::max(hi[a], points[i].c[a]);
+      }
+    }
+    float const         x    = hi[0] - lo[0];
+    float const         y    = hi[1] - lo[1];
+    float const         z    = hi[2] - lo[2];
+    std::uint32_t const axis = x >= y && x >= z ? 0 : (y >= z ? 1 : 2);
+    std::nth_element(points.begin() + begin, points.begin() + mid, points.begin() + end,
+                     [axis](point const& a, point const& b)
+                     {
+                       return a.c[axis] < b.c[axis];
+                     });
+    std::uint32_t const node = (1u << level) - 1 + j;
+    split_values[node]       = points[mid].c[axis];
+    split_axes[node]         = static_cast<std::uint8_t>(axis);
+  }
+
+  //! Leaf reached by descending to the side of every split holding p
+  inline std::uint32_t leaf_of(vec3a::pref p) const
+  {
+    std::uint32_t node = 0;
+    while (node < inner_count())
+      node = 2 * node + 1 + (vec3a::get(p, split_axes[node]) >= split_values[node] ? 1 : 0);
+    return node - inner_count();
+  }
+
+  //! Lanes of slots s + [0, width) of a leaf holding points of the leaf
+  inline std::uint32_t valid(std::uint32_t l, std::uint32_t s) const noexcept
+  {
+    std::uint32_t const n = range_begin(depth, l + 1) - range_begin(depth, l);
+    return n > s ? (1u << std::min<std::uint32_t>(width, n - s)) - 1 : 0;
+  }
+
+  //! Squared distances from p to slots s + [0, width) of a leaf
+  static inline lane_type leaf_sqdistance(leaf const& lf, std::uint32_t s, vec3a::pref p)
+  {
+    lane_type const dx = lane::sub(lane::set(lf.x + s), lane::set(vec3a::x(p)));
+    lane_type const dy = lane::sub(lane::set(lf.y + s), lane::set(vec3a::y(p)));
+    lane_type const dz = lane::sub(lane::set(lf.z + s), lane::set(vec3a::z(p)));
+    return lane::madd(dx, dx, lane::madd(dy, dy, lane::mul(dz, dz)));
+  }
+
+  //! Squared distance between a region and the box [lo, hi]
+  static inline float gap(region const& r, float const* lo, float const* hi)
+  {
+    float d2 = 0.0f;
+    for (std::uint32_t a = 0; a < 3; ++a)
+    {
+      float const d = std::max({r.lo[a] - hi[a], lo[a] - r.hi[a], 0.0f});
+      d2 += d * d;
+    }
+    return d2;
+  }
+
+  //! Offer the points of leaf l to heap
+  inline void leaf_nearest(std::uint32_t l, vec3a::pref p, knn_heap& heap) const
+  {
+    leaf const& lf = leaves[l];
+    for (std::uint32_t s = 0; s < k_leaf_size; s += width)
+    {
+      lane_type const d2   = leaf_sqdistance(lf, s, p);
+      std::uint32_t   hits = lane::mask(lane::lesserv(d2, lane::set(heap.worst()))) & valid(l, s);
+      if (!hits)
+        continue;
+      alignas(32) float d[width];
+      lane::store(d, d2);
+      for (; hits; hits &= hits - 1)
+      {
+        std::uint32_t const k = std::countr_zero(hits);
+        heap.push(d[k], lf.index[s + k]);
+      }
+    }
+  }
+
+  /**
+   * @remarks Visit nodes whose region passes keep, checked when the node is reached so bounds
+   * tightened meanwhile apply, calling visit_leaf(leaf, region) on leaves. The side of a split
+   * facing the center of [lo, hi] is visited first.
+   */
+  template <typename keep_fn, typename leaf_fn>
+  inline void walk(float const* lo, float const* hi, keep_fn&& keep, leaf_fn&& visit_leaf) const
+  {
+    detail::bvh_stack<region> stack;
+    vec3a_t const             blo = point_bounds.r[0];
+    vec3a_t const             bhi = point_bounds.r[1];
+    stack.push({{vec3a::x(blo), vec3a::y(blo), vec3a::z(blo)}, {vec3a::x(bhi), vec3a::y(bhi), vec3a::z(bhi)}, 0});
+    while (!stack.empty())
+    {
+      region const r = stack.pop();
+      if (!keep(r))
+        continue;
+      if (r.node >= inner_count())
+      {
+        visit_leaf(r.node - inner_count(), r);
+        continue;
+      }
+      std::uint32_t const axis  = split_axes[r.node];
+      float const         value = split_values[r.node];
+      region              lower = r;
+      region              upper = r;
+      lower.hi[axis]            = value;
+      upper.lo[axis]            = value;
+      lower.node                = 2 * r.node + 1;
+      upper.node                = 2 * r.node + 2;
+      if (lo[axis] + hi[axis] >= 2.0f * value)
+      {
+        stack.push(lower);
+        stack.push(upper);
+      }
+      else
+      {
+        stack.push(upper);
+        stack.push(lower);
+      }
+    }
+  }
+
+  //! Answer the queries of a leaf together
+  inline void search(std::span<vec3a_t const> i_points, std::uint32_t const* queries, knn_heap* heaps,
+                     std::uint32_t group, std::uint32_t home) const
+  {
+    float lo[3] = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                   std::numeric_limits<float>::max()};
+    float hi[3] = {std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(),
+                   std::numeric_limits<float>::lowest()};
+    float reach = 0.0f;
+    for (std::uint32_t q = 0; q < group; ++q)
+    {
+      vec3a_t const p = i_points[queries[q]];
+      for (std::uint32_t a = 0; a < 3; ++a)
+      {
+        lo[a] = std::min(lo[a], vec3a::get(p, a));
+        hi[a] = std::max(hi[a], vec3a::get(p, a));
+      }
+      leaf_nearest(home, p, heaps[q]);
+      reach = std::max(reach, heaps[q].worst());
+    }
+
+    walk(
+      lo, hi,
+      [&](region const& r)
+      {
+        return gap(r, lo, hi) < reach;
+      },
+      [&](std::uint32_t l, region const& r)
+      {
+        if (l == home)
+          return;
+        reach = 0.0f;
+        for (std::uint32_t q = 0; q < group; ++q)
+        {
+          vec3a_t const p    = i_points[queries[q]];
+          float const   c[3] = {vec3a::x(p), vec3a::y(p), vec3a::z(p)};
+          if (gap(r, c, c) < heaps[q].worst())
+            leaf_nearest(l, p, heaps[q]);
+          reach = std::max(reach, heaps[q].worst());
+        }
+      });
+  }
+
+  //! Split value and axis of inner nodes, breadth first, children of node i are 2i + 1 and 2i + 2
+  std::vector<float>        split_values;
+  std::vector<std::uint8_t> split_axes;
+  //! Leaf j follows inner node 2^depth - 1 + j
+  std::vector<leaf> leaves;
+  aabb_t            point_bounds = detail::empty_box();
+  std::uint32_t     count        = 0;
+  std::uint32_t     depth        = 0;
+};
+
+using kd_tree4 = kd_treen<quad>;
+using kd_tree8 = kd_treen<quad8>;
+//! Widest lane type enabled by the build flags
+using kd_tree = kd_treen<detail::stream_lane>;
+
+} // namespace vml
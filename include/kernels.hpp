@@ -0,0 +1,57 @@
+#pragma once
+#include "intersect.hpp"
+#include "mat4.hpp"
+#include <span>
+
+//! Batch kernels compiled once per instruction set in the vml_kernels library. The best
+//! variant supported by the running cpu is picked on first use, so a single binary gets
+//! AVX2/AVX-512 throughput where available and still runs on SSE2 only machines.
+//! Requires VML_USE_SSE_AVX, the arguments are passed as is to the selected variant.
+namespace vml::kernels
+{
+
+enum class isa_level : std::uint32_t
+{
+  k_sse2,
+  k_sse41,
+  k_avx2_fma,
+  k_avx512
+};
+
+/** @remarks Level in use, the best one supported by the cpu unless overridden by select_level */
+VML_API isa_level selected_level();
+
+/** @remarks Best level supported by the cpu, detected once through cpuid */
+VML_API isa_level supported_level();
+
+/** @remarks Use i_level for subsequent calls. Returns false if the cpu does not support it. */
+VML_API bool select_level(isa_level i_level);
+
+/** @remarks Printable name of a level */
+VML_API char const* level_name(isa_level i_level);
+
+/** @remarks Dispatched intersect::bounding_volumes_frustum */
+VML_API void bounding_volumes_frustum(std::span<bounding_volume_t const> i_vols, frustum_t const& i_frustum,
+                                      std::span<std::uint32_t> o_results);
+
+/** @remarks Dispatched intersect::bounding_volumes_frustum_visibility */
+VML_API void bounding_volumes_frustum_visibility(std::span<bounding_volume_t const> i_vols, frustum_t const& i_frustum,
+                                                 std::span<std::uint32_t> o_visible);
+
+/** @remarks Dispatched intersect::bounding_volumes_frustum over split volumes */
+VML_API void bounding_volumes_frustum(std::span<sphere_box_t const> i_vols, frustum_t const& i_frustum,
+                                      std::span<std::uint32_t> o_results);
+
+/** @remarks Dispatched intersect::bounding_volumes_frustum_visibility over split volumes */
+VML_API void bounding_volumes_frustum_visibility(std::span<sphere_box_t const> i_vols, frustum_t const& i_frustum,
+                                                 std::span<std::uint32_t> o_visible);
+
+/** @remarks Dispatched mat4::transform_assume_ortho */
+VML_API void transform_assume_ortho(mat4_t const& i_m, vec3_t const* i_stream, std::uint32_t i_stride,
+                                    std::uint32_t i_count, vec3_t* o_stream, std::uint32_t i_output_stride);
+
+/** @remarks Dispatched mat4::transform_and_project */
+VML_API void transform_and_project(mat4_t const& i_m, vec3_t const* i_stream, std::uint32_t i_stride,
+                                   std::uint32_t i_count, vec3_t* o_stream, std::uint32_t i_output_stride);
+
+} // namespace vml::kernels
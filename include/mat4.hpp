@@ -1,6 +1,8 @@
 #pragma once
 #include "aabb.hpp"
 #include "mat_base.hpp"
+#include "mat4xn.hpp"
+#include <span>
 namespace vml
 {
 namespace detail
@@ -19,6 +21,150 @@ struct mat4_traits
   static constexpr std::uint32_t row_count     = 4;
   static constexpr std::uint32_t column_count  = 4;
 };
+
+//! Widest lane available for batched kernels, 8 values per block with VML_USE_AVX
+#if VML_USE_AVX
+using stream_lane = quad8;
+#else
+using stream_lane = quad;
+#endif
+
+#if VML_USE_SSE_AVX
+//! Streams with points at least this many bytes apart get software prefetch, denser ones are
+//! left to the hardware prefetcher
+constexpr std::uint32_t k_stream_prefetch_stride = 64;
+//! Points ahead of the current block to prefetch
+constexpr std::uint32_t k_stream_prefetch_distance = 16;
+
+//! Load 4 vec3 stride bytes apart as x, y, z lanes. Strided loads read 4 bytes past each vec3,
+//! so the last vec3 of a buffer must not be loaded this way.
+inline void stream_load_vec3x4(std::uint8_t const* p, std::uint32_t stride, quad_t& x, quad_t& y, quad_t& z)
+{
+  float const* f = reinterpret_cast<float const*>(p);
+  if (stride == sizeof(vec3_t))
+  {
+    // x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+    quad_t a = _mm_loadu_ps(f);
+    quad_t b = _mm_loadu_ps(f + 4);
+    quad_t c = _mm_loadu_ps(f + 8);
+
+    x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 0, 3, 2)), _MM_SHUFFLE(3, 0, 3, 0));
+    y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 2, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)),
+                       _MM_SHUFFLE(2, 0, 2, 0));
+    z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)),
+                       _MM_SHUFFLE(2, 0, 2, 0));
+  }
+  else
+  {
+    quad_t w;
+    x = _mm_loadu_ps(f);
+    y = _mm_loadu_ps(reinterpret_cast<float const*>(p + stride));
+    z = _mm_loadu_ps(reinterpret_cast<float const*>(p + 2 * stride));
+    w = _mm_loadu_ps(reinterpret_cast<float const*>(p + 3 * stride));
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+  }
+}
+
+//! Store x, y, z lanes as 4 vec3 stride bytes apart, only the 12 bytes of each vec3 are written
+inline void stream_store_vec3x4(std::uint8_t* p, std::uint32_t stride, quad_t x, quad_t y, quad_t z)
+{
+  float* f = reinterpret_cast<float*>(p);
+  if (stride == sizeof(vec3_t))
+  {
+    quad_t xy = _mm_unpacklo_ps(x, y);
+    _mm_storeu_ps(f, _mm_shuffle_ps(xy, _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 1, 0)));
+    _mm_storeu_ps(f + 4, _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)),
+                                        _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(f + 8, _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)),
+                                        _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0)));
+  }
+  else
+  {
+    quad_t w = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+    quad_t const r[4] = {x, y, z, w};
+    for (std::uint32_t i = 0; i < 4; ++i, p += stride)
+    {
+      _mm_storel_pi(reinterpret_cast<__m64*>(p), r[i]);
+      _mm_store_ss(reinterpret_cast<float*>(p) + 2, _mm_movehl_ps(r[i], r[i]));
+    }
+  }
+}
+
+/**
+ * @remarks Transform points in blocks of lane::element_count as x, y, z lanes, with the matrix
+ * splat once outside the loop. When project is set, x, y, z are divided by w, or multiplied by
+ * its refined reciprocal if VML_PREFER_SPEED_OVER_ACCURACY is set. The last point of the input is
+ * never part of a block. Returns the number of points done, the caller transforms the rest.
+ */
+template <bool project, typename lane = stream_lane>
+inline std::uint32_t transform_stream(mat4_t const& m, std::uint8_t const* inp, std::uint32_t inpstride,
+                                      std::uint32_t count, std::uint8_t* out, std::uint32_t outstride)
+{
+  using lane_t                    = typename lane::type;
+  constexpr std::uint32_t k_block = lane::element_count;
+
+  lane_t e[4][4];
+  for (std::uint32_t r = 0; r < 4; ++r)
+    for (std::uint32_t c = 0; c < 4; ++c)
+      e[r][c] = lane::set(m.e[r][c]);
+
+  bool const    prefetch = inpstride >= k_stream_prefetch_stride;
+  std::uint32_t i        = 0;
+  for (; i + k_block < count; i += k_block, inp += k_block * inpstride, out += k_block * outstride)
+  {
+    if (prefetch)
+    {
+      for (std::uint32_t k = 0; k < k_block; ++k)
+        _mm_prefetch(reinterpret_cast<char const*>(inp + (k_stream_prefetch_distance + k) * inpstride), _MM_HINT_T0);
+    }
+
+    lane_t x, y, z;
+    if constexpr (k_block == 4)
+    {
+      stream_load_vec3x4(inp, inpstride, x, y, z);
+    }
+    else
+    {
+      quad_t x0, y0, z0, x1, y1, z1;
+      stream_load_vec3x4(inp, inpstride, x0, y0, z0);
+      stream_load_vec3x4(inp + 4 * inpstride, inpstride, x1, y1, z1);
+      x = lane::set(x0, x1);
+      y = lane::set(y0, y1);
+      z = lane::set(z0, z1);
+    }
+
+    lane_t rx = lane::madd(x, e[0][0], lane::madd(y, e[1][0], lane::madd(z, e[2][0], e[3][0])));
+    lane_t ry = lane::madd(x, e[0][1], lane::madd(y, e[1][1], lane::madd(z, e[2][1], e[3][1])));
+    lane_t rz = lane::madd(x, e[0][2], lane::madd(y, e[1][2], lane::madd(z, e[2][2], e[3][2])));
+    if constexpr (project)
+    {
+      lane_t rw = lane::madd(x, e[0][3], lane::madd(y, e[1][3], lane::madd(z, e[2][3], e[3][3])));
+#if VML_PREFER_SPEED_OVER_ACCURACY
+      rw = lane::recip(rw);
+      rx = lane::mul(rx, rw);
+      ry = lane::mul(ry, rw);
+      rz = lane::mul(rz, rw);
+#else
+      rx = lane::div(rx, rw);
+      ry = lane::div(ry, rw);
+      rz = lane::div(rz, rw);
+#endif
+    }
+
+    if constexpr (k_block == 4)
+    {
+      stream_store_vec3x4(out, outstride, rx, ry, rz);
+    }
+    else
+    {
+      stream_store_vec3x4(out, outstride, lane::lo(rx), lane::lo(ry), lane::lo(rz));
+      stream_store_vec3x4(out + 4 * outstride, outstride, lane::hi(rx), lane::hi(ry), lane::hi(rz));
+    }
+  }
+  return i;
+}
+#endif
 } // namespace detail
 
 struct mat4 : public mat_base<detail::mat4_traits>
@@ -37,6 +183,17 @@ struct mat4 : public mat_base<detail::mat4_traits>
   static inline float max_scale(mat4_t const&);
   //! @brief Full matrix multiplication
   static inline type mul(pref m1, pref m2);
+  /**
+   * @remarks Batched multiplication, o_result[i] = m1 * m2[i]. The rows of m1 are splat once for the
+   * whole batch. With non_temporal set the results are written with streaming stores that bypass
+   * the cache, for write-once destinations such as mapped upload buffers. o_result may alias m2.
+   */
+  static inline void mul(pref m1, std::span<mat4_t const> m2, std::span<mat4_t> o_result, bool non_temporal = false);
+  //! @brief Batched multiplication, o_result[i] = m1[i] * m2, o_result may alias m1
+  static inline void mul(std::span<mat4_t const> m1, pref m2, std::span<mat4_t> o_result, bool non_temporal = false);
+  //! @brief Batched multiplication, o_result[i] = m1[i] * m2[i], o_result may alias m1 or m2
+  static inline void mul(std::span<mat4_t const> m1, std::span<mat4_t const> m2, std::span<mat4_t> o_result,
+                         bool non_temporal = false);
   //! @brief transform vertices assuming orthogonal matrix
   static inline void transform_assume_ortho(pref m, const vec3::type* i_stream, std::uint32_t i_stride,
                                             std::uint32_t count, vec3::type* o_stream, std::uint32_t i_output_stride);
@@ -53,6 +210,8 @@ struct mat4 : public mat_base<detail::mat4_traits>
   static inline vec3a_t transform_bounds_extends(pref m, vec3a::pref extends);
   //! @brief Special transform for AABB min and max
   static inline aabb_t transform_aabb(pref m, aabb::pref v);
+  //! @brief Batched transform_aabb, o_result[i] = transform_aabb(m[i], v[i]), o_result may alias v
+  static inline void transform_aabb(std::span<mat4_t const> m, std::span<aabb_t const> v, std::span<aabb_t> o_result);
 
   static inline type from_scale_rotation_translation(scalar_type scale, quat::pref rot, vec3a::pref pos);
   static inline type from_scale(vec3a::pref scale);
@@ -83,7 +242,15 @@ struct mat4 : public mat_base<detail::mat4_traits>
   static inline void transpose_in_place(ref m);
   static inline type inverse(pref m);
   //! @brief inverse for orthogonal matrix
-  static inline type          inverse_assume_ortho(pref m);
+  static inline type inverse_assume_ortho(pref m);
+  //! @brief inverse for affine matrix (rotation, scale incl. non uniform, translation), last column must be 0, 0, 0, 1
+  static inline type inverse_affine(pref m);
+  //! @brief Batched inverse, o_result may alias m
+  static inline void inverse(std::span<mat4_t const> m, std::span<mat4_t> o_result);
+  //! @brief Batched inverse_assume_ortho, o_result may alias m
+  static inline void inverse_assume_ortho(std::span<mat4_t const> m, std::span<mat4_t> o_result);
+  //! @brief Batched inverse_affine, o_result may alias m
+  static inline void          inverse_affine(std::span<mat4_t const> m, std::span<mat4_t> o_result);
   static inline mat3_t const& as_mat3(mat4_t const& m);
   static inline mat3_t&       as_mat3(mat4_t& m);
 };
@@ -111,11 +278,9 @@ inline mat4::type mat4::mul(pref m1, pref m2)
   // Perform the opertion on the first row
   vx = _mm_mul_ps(vx, m2.r[0]);
   vy = _mm_mul_ps(vy, m2.r[1]);
-  vz = _mm_mul_ps(vz, m2.r[2]);
-  vw = _mm_mul_ps(vw, m2.r[3]);
   // Perform a binary add to reduce cumulative errors
-  vx          = _mm_add_ps(vx, vz);
-  vy          = _mm_add_ps(vy, vw);
+  vx          = quad::madd(vz, m2.r[2], vx);
+  vy          = quad::madd(vw, m2.r[3], vy);
   vx          = _mm_add_ps(vx, vy);
   result.r[0] = vx;
   // Repeat for the other 3 rows
@@ -126,10 +291,8 @@ inline mat4::type mat4::mul(pref m1, pref m2)
   vw          = _mm_shuffle_ps(vw, vw, _MM_SHUFFLE(3, 3, 3, 3));
   vx          = _mm_mul_ps(vx, m2.r[0]);
   vy          = _mm_mul_ps(vy, m2.r[1]);
-  vz          = _mm_mul_ps(vz, m2.r[2]);
-  vw          = _mm_mul_ps(vw, m2.r[3]);
-  vx          = _mm_add_ps(vx, vz);
-  vy          = _mm_add_ps(vy, vw);
+  vx          = quad::madd(vz, m2.r[2], vx);
+  vy          = quad::madd(vw, m2.r[3], vy);
   vx          = _mm_add_ps(vx, vy);
   result.r[1] = vx;
   vw          = m1.r[2];
@@ -139,10 +302,8 @@ inline mat4::type mat4::mul(pref m1, pref m2)
   vw          = _mm_shuffle_ps(vw, vw, _MM_SHUFFLE(3, 3, 3, 3));
   vx          = _mm_mul_ps(vx, m2.r[0]);
   vy          = _mm_mul_ps(vy, m2.r[1]);
-  vz          = _mm_mul_ps(vz, m2.r[2]);
-  vw          = _mm_mul_ps(vw, m2.r[3]);
-  vx          = _mm_add_ps(vx, vz);
-  vy          = _mm_add_ps(vy, vw);
+  vx          = quad::madd(vz, m2.r[2], vx);
+  vy          = quad::madd(vw, m2.r[3], vy);
   vx          = _mm_add_ps(vx, vy);
   result.r[2] = vx;
   vw          = m1.r[3];
@@ -152,10 +313,8 @@ inline mat4::type mat4::mul(pref m1, pref m2)
   vw          = _mm_shuffle_ps(vw, vw, _MM_SHUFFLE(3, 3, 3, 3));
   vx          = _mm_mul_ps(vx, m2.r[0]);
   vy          = _mm_mul_ps(vy, m2.r[1]);
-  vz          = _mm_mul_ps(vz, m2.r[2]);
-  vw          = _mm_mul_ps(vw, m2.r[3]);
-  vx          = _mm_add_ps(vx, vz);
-  vy          = _mm_add_ps(vy, vw);
+  vx          = quad::madd(vz, m2.r[2], vx);
+  vy          = quad::madd(vw, m2.r[3], vy);
   vx          = _mm_add_ps(vx, vy);
   result.r[3] = vx;
   return result;
@@ -177,6 +336,162 @@ inline mat4::type mat4::mul(pref m1, pref m2)
 #endif
 }
 
+#if VML_USE_SSE_AVX
+namespace detail
+{
+inline void store_mat4_row(quad_t* o, quad_t v, bool non_temporal)
+{
+  if (non_temporal)
+    _mm_stream_ps(reinterpret_cast<float*>(o), v);
+  else
+    *o = v;
+}
+
+#if VML_USE_AVX
+//! Store two consecutive rows held in one __m256
+inline void store_mat4_rows(quad_t* o, __m256 v, bool non_temporal)
+{
+  if (!non_temporal)
+    _mm256_storeu_ps(reinterpret_cast<float*>(o), v);
+  else if ((reinterpret_cast<std::uintptr_t>(o) & 31) == 0)
+    _mm256_stream_ps(reinterpret_cast<float*>(o), v);
+  else
+  {
+    _mm_stream_ps(reinterpret_cast<float*>(o), _mm256_castps256_ps128(v));
+    _mm_stream_ps(reinterpret_cast<float*>(o + 1), _mm256_extractf128_ps(v, 1));
+  }
+}
+
+//! Rows 2i and 2i+1 of m1 * m2, where m1_rows holds the two rows of m1 and m2_rows[c] holds row c
+//! of m2 in both halves. Terms are added in the same order as mat4::mul.
+inline __m256 mul_mat4_rows(__m256 m1_rows, __m256 const (&m2_rows)[4])
+{
+  __m256 vx = _mm256_mul_ps(_mm256_shuffle_ps(m1_rows, m1_rows, _MM_SHUFFLE(0, 0, 0, 0)), m2_rows[0]);
+  __m256 vy = _mm256_mul_ps(_mm256_shuffle_ps(m1_rows, m1_rows, _MM_SHUFFLE(1, 1, 1, 1)), m2_rows[1]);
+  vx        = quad8::madd(_mm256_shuffle_ps(m1_rows, m1_rows, _MM_SHUFFLE(2, 2, 2, 2)), m2_rows[2], vx);
+  vy        = quad8::madd(_mm256_shuffle_ps(m1_rows, m1_rows, _MM_SHUFFLE(3, 3, 3, 3)), m2_rows[3], vy);
+  return _mm256_add_ps(vx, vy);
+}
+#endif
+} // namespace detail
+#endif
+
+inline void mat4::mul(pref m1, std::span<mat4_t const> m2, std::span<mat4_t> o_result, bool non_temporal)
+{
+  assert(o_result.size() >= m2.size());
+#if VML_USE_AVX
+  // s[r][c] holds m1[2r][c] in the low half and m1[2r + 1][c] in the high half
+  __m256 s[2][4];
+  for (std::uint32_t r = 0; r < 2; ++r)
+    for (std::uint32_t c = 0; c < 4; ++c)
+      s[r][c] = quad8::set(quad::set(m1.e[2 * r][c]), quad::set(m1.e[2 * r + 1][c]));
+
+  for (std::size_t i = 0, end = m2.size(); i < end; ++i)
+  {
+    __m256 const b[4] = {_mm256_broadcast_ps(&m2[i].r[0]), _mm256_broadcast_ps(&m2[i].r[1]),
+                         _mm256_broadcast_ps(&m2[i].r[2]), _mm256_broadcast_ps(&m2[i].r[3])};
+    for (std::uint32_t r = 0; r < 2; ++r)
+    {
+      __m256 vx = _mm256_mul_ps(s[r][0], b[0]);
+      __m256 vy = _mm256_mul_ps(s[r][1], b[1]);
+      vx        = quad8::madd(s[r][2], b[2], vx);
+      vy        = quad8::madd(s[r][3], b[3], vy);
+      detail::store_mat4_rows(&o_result[i].r[2 * r], _mm256_add_ps(vx, vy), non_temporal);
+    }
+  }
+  if (non_temporal)
+    _mm_sfence();
+#elif VML_USE_SSE_AVX
+  quad_t s[4][4];
+  for (std::uint32_t r = 0; r < 4; ++r)
+    for (std::uint32_t c = 0; c < 4; ++c)
+      s[r][c] = quad::set(m1.e[r][c]);
+
+  for (std::size_t i = 0, end = m2.size(); i < end; ++i)
+  {
+    quad_t const b[4] = {m2[i].r[0], m2[i].r[1], m2[i].r[2], m2[i].r[3]};
+    for (std::uint32_t r = 0; r < 4; ++r)
+    {
+      quad_t vx = _mm_mul_ps(s[r][0], b[0]);
+      quad_t vy = _mm_mul_ps(s[r][1], b[1]);
+      vx        = quad::madd(s[r][2], b[2], vx);
+      vy        = quad::madd(s[r][3], b[3], vy);
+      detail::store_mat4_row(&o_result[i].r[r], _mm_add_ps(vx, vy), non_temporal);
+    }
+  }
+  if (non_temporal)
+    _mm_sfence();
+#else
+  (void)non_temporal;
+  for (std::size_t i = 0, end = m2.size(); i < end; ++i)
+    o_result[i] = mul(m1, m2[i]);
+#endif
+}
+
+inline void mat4::mul(std::span<mat4_t const> m1, pref m2, std::span<mat4_t> o_result, bool non_temporal)
+{
+  assert(o_result.size() >= m1.size());
+#if VML_USE_AVX
+  __m256 const b[4] = {_mm256_broadcast_ps(&m2.r[0]), _mm256_broadcast_ps(&m2.r[1]), _mm256_broadcast_ps(&m2.r[2]),
+                       _mm256_broadcast_ps(&m2.r[3])};
+  for (std::size_t i = 0, end = m1.size(); i < end; ++i)
+  {
+    __m256 a01 = _mm256_loadu_ps(m1[i].e[0]);
+    __m256 a23 = _mm256_loadu_ps(m1[i].e[2]);
+    detail::store_mat4_rows(&o_result[i].r[0], detail::mul_mat4_rows(a01, b), non_temporal);
+    detail::store_mat4_rows(&o_result[i].r[2], detail::mul_mat4_rows(a23, b), non_temporal);
+  }
+  if (non_temporal)
+    _mm_sfence();
+#elif VML_USE_SSE_AVX
+  for (std::size_t i = 0, end = m1.size(); i < end; ++i)
+  {
+    mat4_t r = mul(m1[i], m2);
+    for (std::uint32_t k = 0; k < 4; ++k)
+      detail::store_mat4_row(&o_result[i].r[k], r.r[k], non_temporal);
+  }
+  if (non_temporal)
+    _mm_sfence();
+#else
+  (void)non_temporal;
+  for (std::size_t i = 0, end = m1.size(); i < end; ++i)
+    o_result[i] = mul(m1[i], m2);
+#endif
+}
+
+inline void mat4::mul(std::span<mat4_t const> m1, std::span<mat4_t const> m2, std::span<mat4_t> o_result,
+                      bool non_temporal)
+{
+  assert(m1.size() == m2.size());
+  assert(o_result.size() >= m1.size());
+#if VML_USE_AVX
+  for (std::size_t i = 0, end = m1.size(); i < end; ++i)
+  {
+    __m256 const b[4] = {_mm256_broadcast_ps(&m2[i].r[0]), _mm256_broadcast_ps(&m2[i].r[1]),
+                         _mm256_broadcast_ps(&m2[i].r[2]), _mm256_broadcast_ps(&m2[i].r[3])};
+    __m256       a01  = _mm256_loadu_ps(m1[i].e[0]);
+    __m256       a23  = _mm256_loadu_ps(m1[i].e[2]);
+    detail::store_mat4_rows(&o_result[i].r[0], detail::mul_mat4_rows(a01, b), non_temporal);
+    detail::store_mat4_rows(&o_result[i].r[2], detail::mul_mat4_rows(a23, b), non_temporal);
+  }
+  if (non_temporal)
+    _mm_sfence();
+#elif VML_USE_SSE_AVX
+  for (std::size_t i = 0, end = m1.size(); i < end; ++i)
+  {
+    mat4_t r = mul(m1[i], m2[i]);
+    for (std::uint32_t k = 0; k < 4; ++k)
+      detail::store_mat4_row(&o_result[i].r[k], r.r[k], non_temporal);
+  }
+  if (non_temporal)
+    _mm_sfence();
+#else
+  (void)non_temporal;
+  for (std::size_t i = 0, end = m1.size(); i < end; ++i)
+    o_result[i] = mul(m1[i], m2[i]);
+#endif
+}
+
 inline void mat4::transform_assume_ortho(pref m, const vec3::type* inpstream, std::uint32_t inpstride,
                                          std::uint32_t count, vec3::type* outstream, std::uint32_t outstride)
 {
@@ -186,17 +501,17 @@ inline void mat4::transform_assume_ortho(pref m, const vec3::type* inpstream, st
   const std::uint8_t* inp_vec = (const std::uint8_t*)inpstream;
   std::uint8_t*       out_vec = (std::uint8_t*)outstream;
 
-  for (std::uint32_t i = 0; i < count; i++)
+  std::uint32_t i = detail::transform_stream<false>(m, inp_vec, inpstride, count, out_vec, outstride);
+  inp_vec += i * inpstride;
+  out_vec += i * outstride;
+  for (; i < count; i++)
   {
     quad_t x   = _mm_load_ps1(reinterpret_cast<const float*>(inp_vec));
     quad_t y   = _mm_load_ps1(reinterpret_cast<const float*>(inp_vec) + 1);
     quad_t res = _mm_load_ps1(reinterpret_cast<const float*>(inp_vec) + 2);
-    res        = _mm_mul_ps(res, m.r[2]);
-    res        = _mm_add_ps(res, m.r[3]);
-    y          = _mm_mul_ps(y, m.r[1]);
-    res        = _mm_add_ps(res, y);
-    x          = _mm_mul_ps(x, m.r[0]);
-    res        = _mm_add_ps(res, x);
+    res        = quad::madd(res, m.r[2], m.r[3]);
+    res        = quad::madd(y, m.r[1], res);
+    res        = quad::madd(x, m.r[0], res);
 
     ((float*)out_vec)[0] = quad::x(res);
     ((float*)out_vec)[1] = quad::y(res);
@@ -239,17 +554,16 @@ inline void mat4::transform_assume_ortho(pref m, vec3::type* io_stream, std::uin
   assert(io_stream);
   std::uint8_t* inp_vec = (std::uint8_t*)io_stream;
 
-  for (std::uint32_t i = 0; i < count; i++)
+  std::uint32_t i = detail::transform_stream<false>(m, inp_vec, i_stride, count, inp_vec, i_stride);
+  inp_vec += i * i_stride;
+  for (; i < count; i++)
   {
     quad_t x             = _mm_load_ps1(reinterpret_cast<const float*>(inp_vec));
     quad_t y             = _mm_load_ps1(reinterpret_cast<const float*>(inp_vec) + 1);
     quad_t res           = _mm_load_ps1(reinterpret_cast<const float*>(inp_vec) + 2);
-    res                  = _mm_mul_ps(res, m.r[2]);
-    res                  = _mm_add_ps(res, m.r[3]);
-    y                    = _mm_mul_ps(y, m.r[1]);
-    res                  = _mm_add_ps(res, y);
-    x                    = _mm_mul_ps(x, m.r[0]);
-    res                  = _mm_add_ps(res, x);
+    res                  = quad::madd(res, m.r[2], m.r[3]);
+    res                  = quad::madd(y, m.r[1], res);
+    res                  = quad::madd(x, m.r[0], res);
     ((float*)inp_vec)[0] = quad::x(res);
     ((float*)inp_vec)[1] = quad::y(res);
     ((float*)inp_vec)[2] = quad::z(res);
@@ -289,17 +603,17 @@ inline void mat4::transform_and_project(pref m, const vec3::type* inpstream, std
   const std::uint8_t* inp_vec = (std::uint8_t*)inpstream;
   std::uint8_t*       out_vec = (std::uint8_t*)outstream;
 
-  for (std::uint32_t i = 0; i < count; i++)
+  std::uint32_t i = detail::transform_stream<true>(m, inp_vec, inpstride, count, out_vec, outstride);
+  inp_vec += i * inpstride;
+  out_vec += i * outstride;
+  for (; i < count; i++)
   {
     quad_t x   = _mm_load_ps1(reinterpret_cast<const float*>(inp_vec));
     quad_t y   = _mm_load_ps1(reinterpret_cast<const float*>(inp_vec) + 1);
     quad_t res = _mm_load_ps1(reinterpret_cast<const float*>(inp_vec) + 2);
-    res        = _mm_mul_ps(res, m.r[2]);
-    res        = _mm_add_ps(res, m.r[3]);
-    y          = _mm_mul_ps(y, m.r[1]);
-    res        = _mm_add_ps(res, y);
-    x          = _mm_mul_ps(x, m.r[0]);
-    res        = _mm_add_ps(res, x);
+    res        = quad::madd(res, m.r[2], m.r[3]);
+    res        = quad::madd(y, m.r[1], res);
+    res        = quad::madd(x, m.r[0], res);
 
     x   = _mm_shuffle_ps(res, res, _MM_SHUFFLE(3, 3, 3, 3));
     res = _mm_div_ps(res, x);
@@ -345,15 +659,12 @@ inline vec4::type mat4::transform_assume_ortho(pref m, vec3a::pref v)
 {
 #if VML_USE_SSE_AVX
   quad_t ret;
-  ret           = _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
-  ret           = _mm_mul_ps(ret, m.r[0]);
+  ret           = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+  ret           = quad::madd(ret, m.r[2], m.r[3]);
   quad_t v_temp = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
-  v_temp        = _mm_mul_ps(v_temp, m.r[1]);
-  ret           = _mm_add_ps(ret, v_temp);
-  v_temp        = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
-  v_temp        = _mm_mul_ps(v_temp, m.r[2]);
-  ret           = _mm_add_ps(ret, v_temp);
-  ret           = _mm_add_ps(ret, m.r[3]);
+  ret           = quad::madd(v_temp, m.r[1], ret);
+  v_temp        = _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
+  ret           = quad::madd(v_temp, m.r[0], ret);
   return ret;
 #else
   quad_t r, x, y, z;
@@ -373,15 +684,12 @@ inline vec4::type mat4::transform_and_project(pref m, vec3a::pref v)
 {
 #if VML_USE_SSE_AVX
   quad_t ret;
-  ret           = _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
-  ret           = _mm_mul_ps(ret, m.r[0]);
+  ret           = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+  ret           = quad::madd(ret, m.r[2], m.r[3]);
   quad_t v_temp = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
-  v_temp        = _mm_mul_ps(v_temp, m.r[1]);
-  ret           = _mm_add_ps(ret, v_temp);
-  v_temp        = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
-  v_temp        = _mm_mul_ps(v_temp, m.r[2]);
-  ret           = _mm_add_ps(ret, v_temp);
-  ret           = _mm_add_ps(ret, m.r[3]);
+  ret           = quad::madd(v_temp, m.r[1], ret);
+  v_temp        = _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
+  ret           = quad::madd(v_temp, m.r[0], ret);
   v_temp        = _mm_shuffle_ps(ret, ret, _MM_SHUFFLE(3, 3, 3, 3));
   ret           = _mm_div_ps(ret, v_temp);
   return ret;
@@ -733,17 +1041,14 @@ inline vec4_t mat4::mul(vec4::pref v, mat4::pref m)
 {
 #if VML_USE_SSE_AVX
   quad_t ret, v_temp;
-  ret    = _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
-  ret    = _mm_mul_ps(ret, m.r[0]);
-  v_temp = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
-  v_temp = _mm_mul_ps(v_temp, m.r[1]);
-  ret    = _mm_add_ps(ret, v_temp);
+  ret    = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+  ret    = _mm_mul_ps(ret, m.r[3]);
   v_temp = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
-  v_temp = _mm_mul_ps(v_temp, m.r[2]);
-  ret    = _mm_add_ps(ret, v_temp);
-  v_temp = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
-  v_temp = _mm_mul_ps(v_temp, m.r[3]);
-  ret    = _mm_add_ps(ret, v_temp);
+  ret    = quad::madd(v_temp, m.r[2], ret);
+  v_temp = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
+  ret    = quad::madd(v_temp, m.r[1], ret);
+  v_temp = _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
+  ret    = quad::madd(v_temp, m.r[0], ret);
   return ret;
 #else
   quad_t r, x, y, z, w;
@@ -1018,6 +1323,138 @@ inline mat4::type mat4::inverse_assume_ortho(pref m)
 
 #endif
 }
+inline mat4::type mat4::inverse_affine(pref m)
+{
+  // inverse = [ inv(A)       0 ]
+  //           [ -t * inv(A)  1 ]
+  // The columns of inv(A) are the cross products of the rows of A divided by det(A)
+  mat4_t      ret;
+  scalar_type rdet = 1.0f / vec3a::dot(m.r[0], vec3a::cross(m.r[1], m.r[2]));
+  ret.r[0]         = vec3a::mul(vec3a::cross(m.r[1], m.r[2]), rdet);
+  ret.r[1]         = vec3a::mul(vec3a::cross(m.r[2], m.r[0]), rdet);
+  ret.r[2]         = vec3a::mul(vec3a::cross(m.r[0], m.r[1]), rdet);
+  ret.r[3]         = quad::zero();
+  quad::transpose(ret.r[0], ret.r[1], ret.r[2], ret.r[3]);
+
+  quad_t t = vec3a::negate(m.r[3]);
+  ret.r[3] = quad::mul(quad::splat_x(t), ret.r[0]);
+  ret.r[3] = quad::madd(quad::splat_y(t), ret.r[1], ret.r[3]);
+  ret.r[3] = quad::madd(quad::splat_z(t), ret.r[2], ret.r[3]);
+  ret.r[3] = quad::set_w(ret.r[3], 1.0f);
+  return ret;
+}
+
+namespace detail
+{
+//! Run a batched mat4 routine lane::element_count matrices at a time through mat4xn, the
+//! remainder one by one
+template <typename lane = stream_lane, typename soa_fn, typename single_fn>
+inline void mat4_batch(std::span<mat4_t const> m, std::span<mat4_t> o_result, soa_fn&& soa, single_fn&& single)
+{
+  using mat4xn = vml::mat4xn<lane>;
+  assert(o_result.size() >= m.size());
+  std::size_t i = 0;
+  for (std::size_t end = m.size(); i + mat4xn::element_count <= end; i += mat4xn::element_count)
+    mat4xn::store(&o_result[i], soa(mat4xn::load(&m[i])));
+  for (std::size_t end = m.size(); i < end; ++i)
+    o_result[i] = single(m[i]);
+}
+} // namespace detail
+
+inline void mat4::inverse(std::span<mat4_t const> m, std::span<mat4_t> o_result)
+{
+  detail::mat4_batch(
+    m, o_result,
+    [](auto const& v)
+    {
+      return mat4xn<detail::stream_lane>::inverse(v);
+    },
+    [](mat4_t const& v)
+    {
+      return inverse(v);
+    });
+}
+
+inline void mat4::inverse_assume_ortho(std::span<mat4_t const> m, std::span<mat4_t> o_result)
+{
+  detail::mat4_batch(
+    m, o_result,
+    [](auto const& v)
+    {
+      return mat4xn<detail::stream_lane>::inverse_assume_ortho(v);
+    },
+    [](mat4_t const& v)
+    {
+      return inverse_assume_ortho(v);
+    });
+}
+
+inline void mat4::inverse_affine(std::span<mat4_t const> m, std::span<mat4_t> o_result)
+{
+  detail::mat4_batch(
+    m, o_result,
+    [](auto const& v)
+    {
+      return mat4xn<detail::stream_lane>::inverse_affine(v);
+    },
+    [](mat4_t const& v)
+    {
+      return inverse_affine(v);
+    });
+}
+
+inline void mat4::transform_aabb(std::span<mat4_t const> m, std::span<aabb_t const> v, std::span<aabb_t> o_result)
+{
+  // element_count boxes at a time in SoA, same min/max of the scaled corners as the single transform_aabb
+  using lane      = detail::stream_lane;
+  using lane_type = typename lane::type;
+  using mat4xn    = vml::mat4xn<lane>;
+  assert(v.size() == m.size() && o_result.size() >= v.size());
+
+  std::size_t i = 0;
+  for (std::size_t end = v.size(); i + lane::element_count <= end; i += lane::element_count)
+  {
+    quad_t lo[lane::element_count];
+    quad_t hi[lane::element_count];
+    for (std::uint32_t k = 0; k < lane::element_count; ++k)
+    {
+      lo[k] = v[i + k].r[0];
+      hi[k] = v[i + k].r[1];
+    }
+    lane_type bmin[4];
+    lane_type bmax[4];
+    detail::lanes_from_quads<lane>(lo, bmin);
+    detail::lanes_from_quads<lane>(hi, bmax);
+
+    typename mat4xn::type mm = mat4xn::load(&m[i]);
+    lane_type             rmin[4];
+    lane_type             rmax[4];
+    for (std::uint32_t c = 0; c < 3; ++c)
+    {
+      rmin[c] = mm.e[3][c];
+      rmax[c] = mm.e[3][c];
+      for (std::uint32_t j = 0; j < 3; ++j)
+      {
+        lane_type const a = lane::mul(bmin[j], mm.e[j][c]);
+        lane_type const b = lane::mul(bmax[j], mm.e[j][c]);
+        rmin[c]           = lane::add(rmin[c], lane::min(a, b));
+        rmax[c]           = lane::add(rmax[c], lane::max(a, b));
+      }
+    }
+    rmin[3] = lane::zero();
+    rmax[3] = lane::zero();
+    detail::lanes_to_quads<lane>(rmin, lo);
+    detail::lanes_to_quads<lane>(rmax, hi);
+    for (std::uint32_t k = 0; k < lane::element_count; ++k)
+    {
+      o_result[i + k].r[0] = lo[k];
+      o_result[i + k].r[1] = hi[k];
+    }
+  }
+  for (std::size_t end = v.size(); i < end; ++i)
+    o_result[i] = transform_aabb(m[i], v[i]);
+}
+
 inline mat3_t const& mat4::as_mat3(mat4_t const& m)
 {
   return reinterpret_cast<mat3_t const&>(m);
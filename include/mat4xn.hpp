@@ -0,0 +1,277 @@
+#pragma once
+#include "vec3xn.hpp"
+
+namespace vml
+{
+//! Structure of arrays mat4 over quad (4 matrices) or quad8 (8 matrices), mirrors mat4
+template <typename lane>
+struct mat4xn
+{
+  using lane_type   = typename lane::type;
+  using lane_pref   = typename lane::pref;
+  using type        = mat4xn_t<lane_type>;
+  using ref         = type&;
+  using pref        = type const&;
+  using cref        = type const&;
+  using scalar_type = float;
+  using row_type    = lane_type;
+  using vec3_type   = vec3xn_t<lane_type>;
+
+  enum : unsigned int
+  {
+    element_count = lane::element_count
+  };
+
+  //! Broadcast m to all lanes
+  static inline type set(mat4_t const& m);
+  static inline type identity();
+  //! Load element_count matrices, AoS to SoA
+  static inline type load(mat4_t const* m);
+  //! Store element_count matrices, SoA to AoS
+  static inline void store(mat4_t* o, pref m);
+  //! Return the matrix in lane i
+  static inline mat4_t get(pref m, std::uint32_t i);
+  static inline type   mul(pref m1, pref m2);
+  //! Multiply every lane of m1 with the same m2
+  static inline type      mul(pref m1, mat4_t const& m2);
+  static inline type      transpose(pref m);
+  static inline vec3_type transform_assume_ortho(pref m, vec3_type const& v);
+  static inline vec3_type transform_and_project(pref m, vec3_type const& v);
+  //! General inverse, same as mat4::inverse per lane
+  static inline type inverse(pref m);
+  //! Inverse for orthogonal matrices, same as mat4::inverse_assume_ortho per lane
+  static inline type inverse_assume_ortho(pref m);
+  //! Inverse for affine matrices with scale, same as mat4::inverse_affine per lane
+  static inline type inverse_affine(pref m);
+};
+
+using mat4x4 = mat4xn<quad>;
+using mat4x8 = mat4xn<quad8>;
+
+template <typename lane>
+inline typename mat4xn<lane>::type mat4xn<lane>::set(mat4_t const& m)
+{
+  type r;
+  for (std::uint32_t i = 0; i < 4; ++i)
+    for (std::uint32_t j = 0; j < 4; ++j)
+      r.e[i][j] = lane::set(m.e[i][j]);
+  return r;
+}
+
+template <typename lane>
+inline typename mat4xn<lane>::type mat4xn<lane>::identity()
+{
+  type r;
+  for (std::uint32_t i = 0; i < 4; ++i)
+    for (std::uint32_t j = 0; j < 4; ++j)
+      r.e[i][j] = i == j ? lane::set(1.0f) : lane::zero();
+  return r;
+}
+
+template <typename lane>
+inline typename mat4xn<lane>::type mat4xn<lane>::load(mat4_t const* m)
+{
+  type r;
+  for (std::uint32_t i = 0; i < 4; ++i)
+  {
+    quad_t q[element_count];
+    for (std::uint32_t k = 0; k < element_count; ++k)
+      q[k] = m[k].r[i];
+    detail::lanes_from_quads<lane>(q, r.e[i]);
+  }
+  return r;
+}
+
+template <typename lane>
+inline void mat4xn<lane>::store(mat4_t* o, pref m)
+{
+  for (std::uint32_t i = 0; i < 4; ++i)
+  {
+    quad_t q[element_count];
+    detail::lanes_to_quads<lane>(m.e[i], q);
+    for (std::uint32_t k = 0; k < element_count; ++k)
+      o[k].r[i] = q[k];
+  }
+}
+
+template <typename lane>
+inline mat4_t mat4xn<lane>::get(pref m, std::uint32_t i)
+{
+  mat4_t r;
+  for (std::uint32_t j = 0; j < 4; ++j)
+    r.r[j] = quad::set(lane::get(m.e[j][0], i), lane::get(m.e[j][1], i), lane::get(m.e[j][2], i),
+                       lane::get(m.e[j][3], i));
+  return r;
+}
+
+template <typename lane>
+inline typename mat4xn<lane>::type mat4xn<lane>::mul(pref m1, pref m2)
+{
+  type r;
+  for (std::uint32_t i = 0; i < 4; ++i)
+  {
+    for (std::uint32_t j = 0; j < 4; ++j)
+    {
+      lane_type v = lane::mul(m1.e[i][0], m2.e[0][j]);
+      v           = lane::madd(m1.e[i][1], m2.e[1][j], v);
+      v           = lane::madd(m1.e[i][2], m2.e[2][j], v);
+      r.e[i][j]   = lane::madd(m1.e[i][3], m2.e[3][j], v);
+    }
+  }
+  return r;
+}
+
+template <typename lane>
+inline typename mat4xn<lane>::type mat4xn<lane>::mul(pref m1, mat4_t const& m2)
+{
+  type r;
+  for (std::uint32_t i = 0; i < 4; ++i)
+  {
+    for (std::uint32_t j = 0; j < 4; ++j)
+    {
+      lane_type v = lane::mul(m1.e[i][0], lane::set(m2.e[0][j]));
+      v           = lane::madd(m1.e[i][1], lane::set(m2.e[1][j]), v);
+      v           = lane::madd(m1.e[i][2], lane::set(m2.e[2][j]), v);
+      r.e[i][j]   = lane::madd(m1.e[i][3], lane::set(m2.e[3][j]), v);
+    }
+  }
+  return r;
+}
+
+template <typename lane>
+inline typename mat4xn<lane>::type mat4xn<lane>::transpose(pref m)
+{
+  type r;
+  for (std::uint32_t i = 0; i < 4; ++i)
+    for (std::uint32_t j = 0; j < 4; ++j)
+      r.e[i][j] = m.e[j][i];
+  return r;
+}
+
+template <typename lane>
+inline typename mat4xn<lane>::vec3_type mat4xn<lane>::transform_assume_ortho(pref m, vec3_type const& v)
+{
+  vec3_type r;
+  r.x = lane::madd(v.x, m.e[0][0], lane::madd(v.y, m.e[1][0], lane::madd(v.z, m.e[2][0], m.e[3][0])));
+  r.y = lane::madd(v.x, m.e[0][1], lane::madd(v.y, m.e[1][1], lane::madd(v.z, m.e[2][1], m.e[3][1])));
+  r.z = lane::madd(v.x, m.e[0][2], lane::madd(v.y, m.e[1][2], lane::madd(v.z, m.e[2][2], m.e[3][2])));
+  return r;
+}
+
+template <typename lane>
+inline typename mat4xn<lane>::vec3_type mat4xn<lane>::transform_and_project(pref m, vec3_type const& v)
+{
+  vec3_type r = transform_assume_ortho(m, v);
+  lane_type w = lane::madd(v.x, m.e[0][3], lane::madd(v.y, m.e[1][3], lane::madd(v.z, m.e[2][3], m.e[3][3])));
+  r.x         = lane::div(r.x, w);
+  r.y         = lane::div(r.y, w);
+  r.z         = lane::div(r.z, w);
+  return r;
+}
+
+template <typename lane>
+inline typename mat4xn<lane>::type mat4xn<lane>::inverse(pref m)
+{
+  // Laplace expansion over the 2x2 sub-determinants of the upper and lower two rows
+  auto const& a  = m.e;
+  lane_type   s0 = lane::sub(lane::mul(a[0][0], a[1][1]), lane::mul(a[1][0], a[0][1]));
+  lane_type   s1 = lane::sub(lane::mul(a[0][0], a[1][2]), lane::mul(a[1][0], a[0][2]));
+  lane_type   s2 = lane::sub(lane::mul(a[0][0], a[1][3]), lane::mul(a[1][0], a[0][3]));
+  lane_type   s3 = lane::sub(lane::mul(a[0][1], a[1][2]), lane::mul(a[1][1], a[0][2]));
+  lane_type   s4 = lane::sub(lane::mul(a[0][1], a[1][3]), lane::mul(a[1][1], a[0][3]));
+  lane_type   s5 = lane::sub(lane::mul(a[0][2], a[1][3]), lane::mul(a[1][2], a[0][3]));
+  lane_type   c5 = lane::sub(lane::mul(a[2][2], a[3][3]), lane::mul(a[3][2], a[2][3]));
+  lane_type   c4 = lane::sub(lane::mul(a[2][1], a[3][3]), lane::mul(a[3][1], a[2][3]));
+  lane_type   c3 = lane::sub(lane::mul(a[2][1], a[3][2]), lane::mul(a[3][1], a[2][2]));
+  lane_type   c2 = lane::sub(lane::mul(a[2][0], a[3][3]), lane::mul(a[3][0], a[2][3]));
+  lane_type   c1 = lane::sub(lane::mul(a[2][0], a[3][2]), lane::mul(a[3][0], a[2][2]));
+  lane_type   c0 = lane::sub(lane::mul(a[2][0], a[3][1]), lane::mul(a[3][0], a[2][1]));
+
+  lane_type det = lane::sub(lane::mul(s0, c5), lane::mul(s1, c4));
+  det           = lane::madd(s2, c3, det);
+  det           = lane::madd(s3, c2, det);
+  det           = lane::sub(det, lane::mul(s4, c1));
+  det           = lane::madd(s5, c0, det);
+
+  lane_type rdet = lane::div(lane::set(1.0f), det);
+
+  // x * p - y * q + z * r, scaled by rdet
+  auto term = [rdet](lane_pref x, lane_pref p, lane_pref y, lane_pref q, lane_pref z, lane_pref r)
+  {
+    return lane::mul(lane::madd(z, r, lane::sub(lane::mul(x, p), lane::mul(y, q))), rdet);
+  };
+
+  type b;
+  b.e[0][0] = term(a[1][1], c5, a[1][2], c4, a[1][3], c3);
+  b.e[0][1] = lane::negate(term(a[0][1], c5, a[0][2], c4, a[0][3], c3));
+  b.e[0][2] = term(a[3][1], s5, a[3][2], s4, a[3][3], s3);
+  b.e[0][3] = lane::negate(term(a[2][1], s5, a[2][2], s4, a[2][3], s3));
+  b.e[1][0] = lane::negate(term(a[1][0], c5, a[1][2], c2, a[1][3], c1));
+  b.e[1][1] = term(a[0][0], c5, a[0][2], c2, a[0][3], c1);
+  b.e[1][2] = lane::negate(term(a[3][0], s5, a[3][2], s2, a[3][3], s1));
+  b.e[1][3] = term(a[2][0], s5, a[2][2], s2, a[2][3], s1);
+  b.e[2][0] = term(a[1][0], c4, a[1][1], c2, a[1][3], c0);
+  b.e[2][1] = lane::negate(term(a[0][0], c4, a[0][1], c2, a[0][3], c0));
+  b.e[2][2] = term(a[3][0], s4, a[3][1], s2, a[3][3], s0);
+  b.e[2][3] = lane::negate(term(a[2][0], s4, a[2][1], s2, a[2][3], s0));
+  b.e[3][0] = lane::negate(term(a[1][0], c3, a[1][1], c1, a[1][2], c0));
+  b.e[3][1] = term(a[0][0], c3, a[0][1], c1, a[0][2], c0);
+  b.e[3][2] = lane::negate(term(a[3][0], s3, a[3][1], s1, a[3][2], s0));
+  b.e[3][3] = term(a[2][0], s3, a[2][1], s1, a[2][2], s0);
+  return b;
+}
+
+template <typename lane>
+inline typename mat4xn<lane>::type mat4xn<lane>::inverse_assume_ortho(pref m)
+{
+  type b;
+  for (std::uint32_t i = 0; i < 3; ++i)
+  {
+    for (std::uint32_t j = 0; j < 3; ++j)
+      b.e[i][j] = m.e[j][i];
+    b.e[i][3] = lane::zero();
+  }
+  for (std::uint32_t j = 0; j < 3; ++j)
+  {
+    lane_type t = lane::mul(m.e[3][0], m.e[j][0]);
+    t           = lane::madd(m.e[3][1], m.e[j][1], t);
+    t           = lane::madd(m.e[3][2], m.e[j][2], t);
+    b.e[3][j]   = lane::negate(t);
+  }
+  b.e[3][3] = lane::set(1.0f);
+  return b;
+}
+
+template <typename lane>
+inline typename mat4xn<lane>::type mat4xn<lane>::inverse_affine(pref m)
+{
+  using vec3 = vec3xn<lane>;
+  // Column j of inv(A) is the cross product of the other two rows of A divided by det(A)
+  vec3_type const r0   = {m.e[0][0], m.e[0][1], m.e[0][2]};
+  vec3_type const r1   = {m.e[1][0], m.e[1][1], m.e[1][2]};
+  vec3_type const r2   = {m.e[2][0], m.e[2][1], m.e[2][2]};
+  vec3_type const t    = {m.e[3][0], m.e[3][1], m.e[3][2]};
+  lane_type const rdet = lane::div(lane::set(1.0f), vec3::dot(r0, vec3::cross(r1, r2)));
+  vec3_type const c[3] = {vec3::mul(vec3::cross(r1, r2), rdet), vec3::mul(vec3::cross(r2, r0), rdet),
+                          vec3::mul(vec3::cross(r0, r1), rdet)};
+
+  type b;
+  for (std::uint32_t j = 0; j < 3; ++j)
+  {
+    b.e[0][j] = c[j].x;
+    b.e[1][j] = c[j].y;
+    b.e[2][j] = c[j].z;
+    b.e[j][3] = lane::zero();
+  }
+  for (std::uint32_t j = 0; j < 3; ++j)
+  {
+    lane_type v = lane::mul(t.x, b.e[0][j]);
+    v           = lane::madd(t.y, b.e[1][j], v);
+    v           = lane::madd(t.z, b.e[2][j], v);
+    b.e[3][j]   = lane::negate(v);
+  }
+  b.e[3][3] = lane::set(1.0f);
+  return b;
+}
+
+} // namespace vml
@@ -86,10 +86,8 @@ inline void mat_base<concrete>::rotate(pref m, vec3::type* io_stream, std::uint3
     quad_t y   = _mm_load_ps1(reinterpret_cast<const scalar_type*>(inout_vec + 4));
     quad_t res = _mm_load_ps1(reinterpret_cast<const scalar_type*>(inout_vec + 8));
     res        = _mm_mul_ps(res, m.r[2]);
-    y          = _mm_mul_ps(y, m.r[1]);
-    res        = _mm_add_ps(res, y);
-    x          = _mm_mul_ps(x, m.r[0]);
-    res        = _mm_add_ps(res, x);
+    res        = quad::madd(y, m.r[1], res);
+    res        = quad::madd(x, m.r[0], res);
     res        = vec3a::normalize(res);
     _mm_store_ps(store.s, res);
     ((scalar_type*)inout_vec)[0] = store.s[0];
@@ -123,14 +121,12 @@ template <typename concrete>
 inline vec3a_t mat_base<concrete>::rotate(pref m, vec3a::pref v)
 {
 #if VML_USE_SSE_AVX
-  quad_t v_res  = _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
-  v_res         = _mm_mul_ps(v_res, m.r[0]);
+  quad_t v_res  = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+  v_res         = _mm_mul_ps(v_res, m.r[2]);
   quad_t v_temp = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
-  v_temp        = _mm_mul_ps(v_temp, m.r[1]);
-  v_res         = _mm_add_ps(v_res, v_temp);
-  v_temp        = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
-  v_temp        = _mm_mul_ps(v_temp, m.r[2]);
-  v_res         = _mm_add_ps(v_res, v_temp);
+  v_res         = quad::madd(v_temp, m.r[1], v_res);
+  v_temp        = _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
+  v_res         = quad::madd(v_temp, m.r[0], v_res);
   return v_res;
 #else
   quad_t r = vec3a::mul(vec3a::splat_z(v), row(m, 2));
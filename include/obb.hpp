@@ -0,0 +1,332 @@
+#pragma once
+
+#include "aabb.hpp"
+#include "frustum.hpp"
+#include "intersect.hpp"
+#include "mat3.hpp"
+#include "sphere.hpp"
+#include "transform.hpp"
+#include "vec3xn.hpp"
+#include <span>
+
+namespace vml
+{
+//! Oriented box: center, unit axes and the half extents along them
+struct obb_t
+{
+  vec3a_t center;
+  //! Axes of the box, the rows of its rotation matrix
+  vec3a_t axes[3];
+  vec3a_t half_extents;
+};
+
+struct obb
+{
+  static inline obb_t set(vec3a::pref center, quat::pref rotation, vec3a::pref half_extents);
+  static inline obb_t from_aabb(aabb_t const& box);
+  //! Box covering local once transformed by t
+  static inline obb_t from_transform(transform_t const& t, aabb_t const& local);
+  //! Smallest aabb_t containing the box
+  static inline aabb_t to_aabb(obb_t const& box);
+  //! Separating axis test over the 15 face and edge axes
+  static inline bool intersect_obb(obb_t const& a, obb_t const& b);
+  static inline bool intersect_aabb(obb_t const& a, aabb_t const& b);
+  static inline bool intersect_sphere(obb_t const& a, sphere_t const& s);
+  //! Plane test with the radius of the box projected on each plane normal
+  static inline intersect::result_t intersect_frustum(obb_t const& a, frustum_t const& f);
+  /**
+   * @remarks Test boxes against a frustum_t, element_count boxes per plane test, setting bit i % 32
+   * of o_visible[i / 32] if box i is inside or intersecting, as
+   * intersect::bounding_volumes_frustum_visibility does. o_visible must hold at least
+   * (count + 31) / 32 words.
+   */
+  static inline void intersect_frustum(std::span<obb_t const> boxes, frustum_t const& f,
+                                       std::span<std::uint32_t> o_visible);
+};
+
+/**
+ * @remarks quad (4) or quad8 (8) boxes in SoA tested against one primitive per call, every test
+ * returns the mask of boxes overlapping it, bit k for box k, same as the obb function of the same
+ * name.
+ */
+template <typename lane>
+struct obbxn
+{
+  using lane_type = typename lane::type;
+  using vec3_type = vec3xn_t<lane_type>;
+
+  enum : unsigned int
+  {
+    element_count = lane::element_count
+  };
+
+  struct type
+  {
+    vec3_type center;
+    vec3_type axes[3];
+    vec3_type half_extents;
+  };
+
+  //! Load element_count boxes
+  static inline type          load(obb_t const* boxes);
+  static inline std::uint32_t intersect_obb(type const& a, obb_t const& b);
+  static inline std::uint32_t intersect_aabb(type const& a, aabb_t const& b);
+  static inline std::uint32_t intersect_sphere(type const& a, sphere_t const& s);
+  //! Boxes inside or intersecting f
+  static inline std::uint32_t intersect_frustum(type const& a, frustum_t const& f);
+};
+
+using obbx4 = obbxn<quad>;
+using obbx8 = obbxn<quad8>;
+
+namespace detail
+{
+//! Added to the rotation terms of the SAT so near parallel edges, whose cross product vanishes, do not report a
+//! separation from rounding
+constexpr float k_obb_epsilon = 1e-6f;
+} // namespace detail
+
+inline obb_t obb::set(vec3a::pref center, quat::pref rotation, vec3a::pref half_extents)
+{
+  mat3_t const m = mat3::from_quat(rotation);
+  return {center, {vec3a::from_vec4(m.r[0]), vec3a::from_vec4(m.r[1]), vec3a::from_vec4(m.r[2])}, half_extents};
+}
+
+inline obb_t obb::from_aabb(aabb_t const& box)
+{
+  return {aabb::center(box),
+          {vec3a::set(1.0f, 0.0f, 0.0f), vec3a::set(0.0f, 1.0f, 0.0f), vec3a::set(0.0f, 0.0f, 1.0f)},
+          aabb::half_size(box)};
+}
+
+inline obb_t obb::from_transform(transform_t const& t, aabb_t const& local)
+{
+  return set(transform::mul(aabb::center(local), t), transform::rotation(t),
+             vec3a::mul(aabb::half_size(local), transform::scale(t)));
+}
+
+inline aabb_t obb::to_aabb(obb_t const& box)
+{
+  vec3a_t e = vec3a::mul(vec3a::abs(box.axes[0]), vec3a::x(box.half_extents));
+  e         = vec3a::madd(vec3a::abs(box.axes[1]), vec3a::set(vec3a::y(box.half_extents)), e);
+  e         = vec3a::madd(vec3a::abs(box.axes[2]), vec3a::set(vec3a::z(box.half_extents)), e);
+  return aabb::set(box.center, e);
+}
+
+inline bool obb::intersect_obb(obb_t const& a, obb_t const& b)
+{
+  // r[i][j] = a_i . b_j, b in the frame of a
+  float r[3][3];
+  float ar[3][3];
+  for (std::uint32_t i = 0; i < 3; ++i)
+  {
+    for (std::uint32_t j = 0; j < 3; ++j)
+    {
+      r[i][j]  = vec3a::dot(a.axes[i], b.axes[j]);
+      ar[i][j] = std::abs(r[i][j]) + detail::k_obb_epsilon;
+    }
+  }
+  vec3a_t const d     = vec3a::sub(b.center, a.center);
+  float const   t[3]  = {vec3a::dot(d, a.axes[0]), vec3a::dot(d, a.axes[1]), vec3a::dot(d, a.axes[2])};
+  float const   ea[3] = {vec3a::x(a.half_extents), vec3a::y(a.half_extents), vec3a::z(a.half_extents)};
+  float const   eb[3] = {vec3a::x(b.half_extents), vec3a::y(b.half_extents), vec3a::z(b.half_extents)};
+
+  // Face axes of a, then of b
+  for (std::uint32_t i = 0; i < 3; ++i)
+  {
+    if (std::abs(t[i]) > ea[i] + eb[0] * ar[i][0] + eb[1] * ar[i][1] + eb[2] * ar[i][2])
+      return false;
+  }
+  for (std::uint32_t j = 0; j < 3; ++j)
+  {
+    if (std::abs(t[0] * r[0][j] + t[1] * r[1][j] + t[2] * r[2][j]) >
+        eb[j] + ea[0] * ar[0][j] + ea[1] * ar[1][j] + ea[2] * ar[2][j])
+      return false;
+  }
+  // Edge axes a_i x b_j
+  for (std::uint32_t i = 0; i < 3; ++i)
+  {
+    std::uint32_t const i1 = (i + 1) % 3;
+    std::uint32_t const i2 = (i + 2) % 3;
+    for (std::uint32_t j = 0; j < 3; ++j)
+    {
+      std::uint32_t const j1 = (j + 1) % 3;
+      std::uint32_t const j2 = (j + 2) % 3;
+      float const         ra = ea[i1] * ar[i2][j] + ea[i2] * ar[i1][j];
+      float const         rb = eb[j1] * ar[i][j2] + eb[j2] * ar[i][j1];
+      if (std::abs(t[i2] * r[i1][j] - t[i1] * r[i2][j]) > ra + rb)
+        return false;
+    }
+  }
+  return true;
+}
+
+inline bool obb::intersect_aabb(obb_t const& a, aabb_t const& b)
+{
+  return intersect_obb(a, from_aabb(b));
+}
+
+inline bool obb::intersect_sphere(obb_t const& a, sphere_t const& s)
+{
+  // Distance from the center of s to its closest point in the box, in the frame of the box
+  vec3a_t const d     = vec3a::sub(sphere::center(s), a.center);
+  vec3a_t const local = vec3a::set(vec3a::dot(d, a.axes[0]), vec3a::dot(d, a.axes[1]), vec3a::dot(d, a.axes[2]));
+  vec3a_t const out   = vec3a::sub(local, vec3a::min(vec3a::max(local, vec3a::negate(a.half_extents)), a.half_extents));
+  return vec3a::dot(out, out) <= sphere::radius(s) * sphere::radius(s);
+}
+
+inline intersect::result_t obb::intersect_frustum(obb_t const& a, frustum_t const& f)
+{
+  auto const          planes = frustum::get_planes(f);
+  intersect::result_t result = intersect::result_t::k_inside;
+  for (std::uint32_t p = 0; p < planes.second; ++p)
+  {
+    vec3a_t const n = plane::get_normal(planes.first[p]);
+    float const   r = vec3a::x(a.half_extents) * std::abs(vec3a::dot(n, a.axes[0])) +
+                    vec3a::y(a.half_extents) * std::abs(vec3a::dot(n, a.axes[1])) +
+                    vec3a::z(a.half_extents) * std::abs(vec3a::dot(n, a.axes[2]));
+    float const d = plane::dot(planes.first[p], a.center);
+    if (d + r < 0.0f)
+      return intersect::result_t::k_outside;
+    if (d - r < 0.0f)
+      result = intersect::result_t::k_intersecting;
+  }
+  return result;
+}
+
+inline void obb::intersect_frustum(std::span<obb_t const> boxes, frustum_t const& f,
+                                   std::span<std::uint32_t> o_visible)
+{
+  using obbxn             = vml::obbxn<detail::stream_lane>;
+  std::uint32_t const n   = obbxn::element_count;
+  std::uint32_t const end = static_cast<std::uint32_t>(boxes.size());
+  std::fill_n(o_visible.begin(), (end + 31) / 32, 0u);
+  std::uint32_t i = 0;
+  for (; i + n <= end; i += n)
+    o_visible[i / 32] |= obbxn::intersect_frustum(obbxn::load(&boxes[i]), f) << (i % 32);
+  for (; i < end; ++i)
+  {
+    if (intersect_frustum(boxes[i], f) != intersect::result_t::k_outside)
+      o_visible[i / 32] |= 1u << (i % 32);
+  }
+}
+
+template <typename lane>
+inline typename obbxn<lane>::type obbxn<lane>::load(obb_t const* boxes)
+{
+  quad_t q[5][element_count];
+  for (std::uint32_t k = 0; k < element_count; ++k)
+  {
+    q[0][k] = boxes[k].center;
+    q[1][k] = boxes[k].axes[0];
+    q[2][k] = boxes[k].axes[1];
+    q[3][k] = boxes[k].axes[2];
+    q[4][k] = boxes[k].half_extents;
+  }
+  type      o;
+  lane_type l[4];
+  for (std::uint32_t v = 0; v < 5; ++v)
+  {
+    detail::lanes_from_quads<lane>(q[v], l);
+    vec3_type& dst = v == 0 ? o.center : (v == 4 ? o.half_extents : o.axes[v - 1]);
+    dst            = {l[0], l[1], l[2]};
+  }
+  return o;
+}
+
+template <typename lane>
+inline std::uint32_t obbxn<lane>::intersect_obb(type const& a, obb_t const& b)
+{
+  using vec3xn = vml::vec3xn<lane>;
+  // r[i][j] = a_i . b_j per lane, the same terms as obb::intersect_obb
+  lane_type       r[3][3];
+  lane_type       ar[3][3];
+  lane_type const epsilon = lane::set(detail::k_obb_epsilon);
+  for (std::uint32_t i = 0; i < 3; ++i)
+  {
+    for (std::uint32_t j = 0; j < 3; ++j)
+    {
+      r[i][j]  = vec3xn::dot(a.axes[i], vec3xn::set(b.axes[j]));
+      ar[i][j] = lane::add(lane::abs(r[i][j]), epsilon);
+    }
+  }
+  vec3_type const d     = vec3xn::sub(vec3xn::set(b.center), a.center);
+  lane_type const t[3]  = {vec3xn::dot(d, a.axes[0]), vec3xn::dot(d, a.axes[1]), vec3xn::dot(d, a.axes[2])};
+  lane_type const ea[3] = {a.half_extents.x, a.half_extents.y, a.half_extents.z};
+  lane_type const eb[3] = {lane::set(vec3a::x(b.half_extents)), lane::set(vec3a::y(b.half_extents)),
+                           lane::set(vec3a::z(b.half_extents))};
+
+  lane_type apart = lane::zero();
+  for (std::uint32_t i = 0; i < 3; ++i)
+  {
+    lane_type reach = lane::madd(eb[2], ar[i][2], ea[i]);
+    reach           = lane::madd(eb[0], ar[i][0], lane::madd(eb[1], ar[i][1], reach));
+    apart           = lane::bit_or(apart, lane::greaterv(lane::abs(t[i]), reach));
+  }
+  for (std::uint32_t j = 0; j < 3; ++j)
+  {
+    lane_type const dist  = lane::madd(t[0], r[0][j], lane::madd(t[1], r[1][j], lane::mul(t[2], r[2][j])));
+    lane_type       reach = lane::madd(ea[2], ar[2][j], eb[j]);
+    reach                 = lane::madd(ea[0], ar[0][j], lane::madd(ea[1], ar[1][j], reach));
+    apart                 = lane::bit_or(apart, lane::greaterv(lane::abs(dist), reach));
+  }
+  for (std::uint32_t i = 0; i < 3; ++i)
+  {
+    std::uint32_t const i1 = (i + 1) % 3;
+    std::uint32_t const i2 = (i + 2) % 3;
+    for (std::uint32_t j = 0; j < 3; ++j)
+    {
+      std::uint32_t const j1    = (j + 1) % 3;
+      std::uint32_t const j2    = (j + 2) % 3;
+      lane_type const     ra    = lane::madd(ea[i1], ar[i2][j], lane::mul(ea[i2], ar[i1][j]));
+      lane_type const     reach = lane::madd(eb[j1], ar[i][j2], lane::madd(eb[j2], ar[i][j1], ra));
+      lane_type const     dist  = lane::sub(lane::mul(t[i2], r[i1][j]), lane::mul(t[i1], r[i2][j]));
+      apart                     = lane::bit_or(apart, lane::greaterv(lane::abs(dist), reach));
+    }
+  }
+  return ~lane::mask(apart) & ((1u << element_count) - 1);
+}
+
+template <typename lane>
+inline std::uint32_t obbxn<lane>::intersect_aabb(type const& a, aabb_t const& b)
+{
+  return intersect_obb(a, obb::from_aabb(b));
+}
+
+template <typename lane>
+inline std::uint32_t obbxn<lane>::intersect_sphere(type const& a, sphere_t const& s)
+{
+  using vec3xn           = vml::vec3xn<lane>;
+  vec3_type const d      = vec3xn::sub(vec3xn::set(sphere::center(s)), a.center);
+  lane_type       d2     = lane::zero();
+  lane_type const radius = lane::set(sphere::radius(s));
+  lane_type const ea[3]  = {a.half_extents.x, a.half_extents.y, a.half_extents.z};
+  for (std::uint32_t i = 0; i < 3; ++i)
+  {
+    lane_type const local = vec3xn::dot(d, a.axes[i]);
+    lane_type const out   = lane::sub(local, lane::min(lane::max(local, lane::negate(ea[i])), ea[i]));
+    d2                    = lane::madd(out, out, d2);
+  }
+  return lane::mask(lane::lesser_equalv(d2, lane::mul(radius, radius)));
+}
+
+template <typename lane>
+inline std::uint32_t obbxn<lane>::intersect_frustum(type const& a, frustum_t const& f)
+{
+  using vec3xn           = vml::vec3xn<lane>;
+  auto const      planes = frustum::get_planes(f);
+  lane_type const zero   = lane::zero();
+  lane_type       apart  = zero;
+  for (std::uint32_t p = 0; p < planes.second; ++p)
+  {
+    vec3_type const n = vec3xn::set(plane::get_normal(planes.first[p]));
+    lane_type       r = lane::mul(a.half_extents.x, lane::abs(vec3xn::dot(n, a.axes[0])));
+    r                 = lane::madd(a.half_extents.y, lane::abs(vec3xn::dot(n, a.axes[1])), r);
+    r                 = lane::madd(a.half_extents.z, lane::abs(vec3xn::dot(n, a.axes[2])), r);
+    lane_type const d = lane::add(vec3xn::dot(n, a.center), lane::set(quad::w(planes.first[p])));
+    apart             = lane::bit_or(apart, lane::lesserv(lane::add(d, r), zero));
+  }
+  return ~lane::mask(apart) & ((1u << element_count) - 1);
+}
+
+} // namespace vml
@@ -2,6 +2,7 @@
 
 #include "detail/deduced_types.hpp"
 #include "real.hpp"
+#include <functional>
 
 namespace vml
 {
@@ -32,6 +33,8 @@ struct quad
   static inline type set(scalar_type x, scalar_type y, scalar_type z, scalar_type w);
   static inline type set(scalar_type const* v);
   static inline type set_unaligned(scalar_type const* v);
+  //! Store to 16 byte aligned memory
+  static inline void store(scalar_type* o, pref v);
   static inline type set_x(scalar_type x);
   static inline type set_x(pref v, scalar_type x);
   static inline type set_y(pref v, scalar_type y);
@@ -95,6 +98,20 @@ struct quad
   static inline bool        greater_any(pref q1, pref q2);
   static inline bool        lesser_all(pref q1, pref q2);
   static inline bool        lesser_any(pref q1, pref q2);
+  static inline type        bit_and(pref a, pref b);
+  static inline type        bit_or(pref a, pref b);
+  //! Return ~a & b
+  static inline type bit_andnot(pref a, pref b);
+  //! Lane mask of a < b (all bits set for true), same as quad8::lesserv
+  static inline type lesserv(pref a, pref b);
+  //! Lane mask of a <= b
+  static inline type lesser_equalv(pref a, pref b);
+  //! Lane mask of a > b
+  static inline type greaterv(pref a, pref b);
+  //! Lane mask of a >= b
+  static inline type greater_equalv(pref a, pref b);
+  //! Collect the sign bit of lane i into bit i
+  static inline std::uint32_t mask(pref v);
   static inline type        vdot(pref q1, pref q2);
   static inline scalar_type dot(pref q1, pref q2);
   static inline scalar_type sqlength(pref c1);
@@ -104,6 +121,11 @@ struct quad
   static inline type        normalize(pref v);
   static inline type        lerp(pref src, pref dest, scalar_type t);
   static inline type        recip_sqrt(pref qpf);
+  //! Reciprocal, rcp refined by one Newton-Raphson step if VML_PREFER_SPEED_OVER_ACCURACY is set, 1 / v otherwise
+  static inline type recip(pref v);
+  static inline type sqrt(pref qpf);
+  //! Transpose the 4x4 block formed by r0-r3 in place
+  static inline void transpose(ref r0, ref r1, ref r2, ref r3);
   //! set the vector as 0, 0, 0, w -> where w = a[select]
   static inline type set_000w(pref a, std::uint8_t select);
   //! set the vector as 1, 1, 1, w -> where w = a[select]
@@ -219,6 +241,16 @@ inline quad::type quad::set_unaligned(scalar_type const* v)
 #endif
 }
 
+inline void quad::store(scalar_type* o, quad::pref v)
+{
+#if VML_USE_SSE_AVX
+  _mm_store_ps(o, v);
+#else
+  for (std::uint32_t i = 0; i < element_count; ++i)
+    o[i] = v[i];
+#endif
+}
+
 inline quad::type quad::zero()
 {
 #if VML_USE_SSE_AVX
@@ -521,6 +553,122 @@ inline bool quad::lesser_all(quad::pref a, quad::pref b)
 #endif
 }
 
+#if !VML_USE_SSE_AVX
+namespace detail
+{
+template <typename bit_fn>
+inline types::quad_t<float> quad_bits(types::quad_t<float> const& a, types::quad_t<float> const& b, bit_fn&& fn)
+{
+  types::quad_t<float> r;
+  std::uint32_t*       ir = reinterpret_cast<std::uint32_t*>(&r);
+  std::uint32_t const* ia = reinterpret_cast<std::uint32_t const*>(&a);
+  std::uint32_t const* ib = reinterpret_cast<std::uint32_t const*>(&b);
+  for (std::uint32_t i = 0; i < 4; ++i)
+    ir[i] = fn(ia[i], ib[i]);
+  return r;
+}
+
+template <typename compare_fn>
+inline types::quad_t<float> quad_compare(types::quad_t<float> const& a, types::quad_t<float> const& b,
+                                         compare_fn&& cmp)
+{
+  types::quad_t<float> r;
+  std::uint32_t*       ir = reinterpret_cast<std::uint32_t*>(&r);
+  for (std::uint32_t i = 0; i < 4; ++i)
+    ir[i] = cmp(a[i], b[i]) ? 0xffffffff : 0;
+  return r;
+}
+} // namespace detail
+#endif
+
+inline quad::type quad::bit_and(quad::pref a, quad::pref b)
+{
+#if VML_USE_SSE_AVX
+  return _mm_and_ps(a, b);
+#else
+  return detail::quad_bits(a, b,
+                           [](std::uint32_t x, std::uint32_t y)
+                           {
+                             return x & y;
+                           });
+#endif
+}
+
+inline quad::type quad::bit_or(quad::pref a, quad::pref b)
+{
+#if VML_USE_SSE_AVX
+  return _mm_or_ps(a, b);
+#else
+  return detail::quad_bits(a, b,
+                           [](std::uint32_t x, std::uint32_t y)
+                           {
+                             return x | y;
+                           });
+#endif
+}
+
+inline quad::type quad::bit_andnot(quad::pref a, quad::pref b)
+{
+#if VML_USE_SSE_AVX
+  return _mm_andnot_ps(a, b);
+#else
+  return detail::quad_bits(a, b,
+                           [](std::uint32_t x, std::uint32_t y)
+                           {
+                             return ~x & y;
+                           });
+#endif
+}
+
+inline quad::type quad::lesserv(quad::pref a, quad::pref b)
+{
+#if VML_USE_SSE_AVX
+  return _mm_cmplt_ps(a, b);
+#else
+  return detail::quad_compare(a, b, std::less<>());
+#endif
+}
+
+inline quad::type quad::lesser_equalv(quad::pref a, quad::pref b)
+{
+#if VML_USE_SSE_AVX
+  return _mm_cmple_ps(a, b);
+#else
+  return detail::quad_compare(a, b, std::less_equal<>());
+#endif
+}
+
+inline quad::type quad::greaterv(quad::pref a, quad::pref b)
+{
+#if VML_USE_SSE_AVX
+  return _mm_cmpgt_ps(a, b);
+#else
+  return detail::quad_compare(a, b, std::greater<>());
+#endif
+}
+
+inline quad::type quad::greater_equalv(quad::pref a, quad::pref b)
+{
+#if VML_USE_SSE_AVX
+  return _mm_cmpge_ps(a, b);
+#else
+  return detail::quad_compare(a, b, std::greater_equal<>());
+#endif
+}
+
+inline std::uint32_t quad::mask(quad::pref v)
+{
+#if VML_USE_SSE_AVX
+  return static_cast<std::uint32_t>(_mm_movemask_ps(v));
+#else
+  std::uint32_t        r  = 0;
+  std::uint32_t const* iv = reinterpret_cast<std::uint32_t const*>(&v);
+  for (std::uint32_t i = 0; i < element_count; ++i)
+    r |= (iv[i] >> 31) << i;
+  return r;
+#endif
+}
+
 inline quad::type quad::abs(quad::pref q)
 {
 #if VML_USE_SSE_AVX
@@ -657,8 +805,12 @@ inline quad::type quad::mul(scalar_type val, quad::pref q)
 inline quad::type quad::madd(quad::pref a, quad::pref v, quad::pref c)
 {
 #if VML_USE_SSE_AVX
+#if VML_USE_FMA
+  return _mm_fmadd_ps(a, v, c);
+#else
   type t = _mm_mul_ps(a, v);
   return _mm_add_ps(t, c);
+#endif
 #else
   return quad::add(quad::mul(a, v), c);
 #endif
@@ -723,6 +875,43 @@ inline quad::type quad::recip_sqrt(quad::pref qpf)
 #endif
 }
 
+inline quad::type quad::recip(quad::pref v)
+{
+#if VML_USE_SSE_AVX
+#if VML_PREFER_SPEED_OVER_ACCURACY
+  const __m128 approx = _mm_rcp_ps(v);
+  return _mm_mul_ps(approx, _mm_sub_ps(_mm_set_ps1(2.0f), _mm_mul_ps(v, approx)));
+#else
+  return _mm_div_ps(_mm_set_ps1(1.0f), v);
+#endif
+#else
+  return quad::set(1.0f / v[0], 1.0f / v[1], 1.0f / v[2], 1.0f / v[3]);
+#endif
+}
+
+inline quad::type quad::sqrt(quad::pref qpf)
+{
+#if VML_USE_SSE_AVX
+  return _mm_sqrt_ps(qpf);
+#else
+  return quad::set(vml::sqrt(qpf[0]), vml::sqrt(qpf[1]), vml::sqrt(qpf[2]), vml::sqrt(qpf[3]));
+#endif
+}
+
+inline void quad::transpose(quad::ref r0, quad::ref r1, quad::ref r2, quad::ref r3)
+{
+#if VML_USE_SSE_AVX
+  _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+#else
+  std::swap(r0[1], r1[0]);
+  std::swap(r0[2], r2[0]);
+  std::swap(r0[3], r3[0]);
+  std::swap(r1[2], r2[1]);
+  std::swap(r1[3], r3[1]);
+  std::swap(r2[3], r3[2]);
+#endif
+}
+
 inline quad::type quad::select(quad::pref v1, quad::pref v2, quad::pref control)
 {
 #if VML_USE_SSE_AVX
@@ -854,7 +1043,8 @@ inline quad::type quad::set_111w(pref a, std::uint8_t select)
 }
 } // namespace vml
 
-#if VML_USE_SSE_AVX
+// __m128 is a builtin vector type on GCC and Clang, which cannot take overloaded operators
+#if VML_USE_SSE_AVX && defined(_MSC_VER)
 
 inline bool operator==(__m128 const& a, __m128 const& b) noexcept
 {
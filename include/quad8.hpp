@@ -0,0 +1,511 @@
+#pragma once
+
+#include "quad.hpp"
+#include <functional>
+
+namespace vml
+{
+#if !VML_USE_AVX
+namespace detail
+{
+template <typename compare_fn>
+inline types::quad8_t<float> quad8_compare(types::quad8_t<float> const& a, types::quad8_t<float> const& b,
+                                           compare_fn&& cmp)
+{
+  types::quad8_t<float> r;
+  std::uint32_t*        ir = reinterpret_cast<std::uint32_t*>(&r);
+  for (std::uint32_t i = 0; i < 8; ++i)
+    ir[i] = cmp(a[i], b[i]) ? 0xffffffff : 0;
+  return r;
+}
+} // namespace detail
+#endif
+
+//! 8 lane float vector, __m256 when VML_USE_AVX is set, std::array<float, 8> otherwise.
+//! Lanes 0-3 form the low quad and lanes 4-7 the high quad. Comparisons return lane masks
+//! (all bits set for true) usable with select, bit_and/bit_or/bit_andnot and mask.
+struct quad8
+{
+  using type        = types::quad8_t<float>;
+  using ref         = type&;
+  using pref        = std::conditional_t<types::is_pref_cref, type const&, type>;
+  using cref        = type const&;
+  using scalar_type = float;
+  using row_type    = float;
+
+  enum : unsigned int
+  {
+    element_count = 8
+  };
+
+  //! Broadcast v to all lanes
+  static inline type set(scalar_type v);
+  //! Load from 32 byte aligned memory
+  static inline type set(scalar_type const* v);
+  static inline type set_unaligned(scalar_type const* v);
+  //! Set lanes 0-3 from lo and lanes 4-7 from hi
+  static inline type set(quad::pref lo, quad::pref hi);
+  //! Store to 32 byte aligned memory
+  static inline void store(scalar_type* o, pref v);
+  static inline void store_unaligned(scalar_type* o, pref v);
+  //! Return lanes 0-3
+  static inline quad::type lo(pref v);
+  //! Return lanes 4-7
+  static inline quad::type  hi(pref v);
+  static inline type        zero();
+  static inline scalar_type get(pref v, std::uint32_t i);
+  static inline type        min(pref a, pref b);
+  static inline type        max(pref a, pref b);
+  static inline type        abs(pref v);
+  static inline type        negate(pref v);
+  static inline type        add(pref a, pref b);
+  static inline type        sub(pref a, pref b);
+  static inline type        mul(pref a, pref b);
+  static inline type        mul(pref a, scalar_type b);
+  static inline type        div(pref a, pref b);
+  //! Return v * m + a
+  static inline type madd(pref v, pref m, pref a);
+  static inline type sqrt(pref v);
+  static inline type recip_sqrt(pref v);
+  //! Reciprocal, rcp refined by one Newton-Raphson step if VML_PREFER_SPEED_OVER_ACCURACY is set, 1 / v otherwise
+  static inline type recip(pref v);
+  //! Pick v2 where control bits are set, v1 otherwise
+  static inline type select(pref v1, pref v2, pref control);
+  static inline type bit_and(pref a, pref b);
+  static inline type bit_or(pref a, pref b);
+  //! Return ~a & b
+  static inline type bit_andnot(pref a, pref b);
+  //! Lane mask of a < b
+  static inline type lesserv(pref a, pref b);
+  //! Lane mask of a <= b
+  static inline type lesser_equalv(pref a, pref b);
+  //! Lane mask of a > b
+  static inline type greaterv(pref a, pref b);
+  //! Lane mask of a >= b
+  static inline type greater_equalv(pref a, pref b);
+  //! Lane mask of a == b
+  static inline type equalv(pref a, pref b);
+  //! Collect the sign bit of lane i into bit i
+  static inline std::uint32_t mask(pref v);
+  static inline bool          any(pref v);
+  static inline bool          all(pref v);
+  static inline bool          greater_all(pref a, pref b);
+  static inline bool          greater_any(pref a, pref b);
+  static inline bool          lesser_all(pref a, pref b);
+  static inline bool          lesser_any(pref a, pref b);
+  //! Sum of all lanes
+  static inline scalar_type hadd(pref v);
+};
+
+inline quad8::type quad8::set(scalar_type v)
+{
+#if VML_USE_AVX
+  return _mm256_set1_ps(v);
+#else
+  return {v, v, v, v, v, v, v, v};
+#endif
+}
+
+inline quad8::type quad8::set(scalar_type const* v)
+{
+#if VML_USE_AVX
+  return _mm256_load_ps(v);
+#else
+  return {v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7]};
+#endif
+}
+
+inline quad8::type quad8::set_unaligned(scalar_type const* v)
+{
+#if VML_USE_AVX
+  return _mm256_loadu_ps(v);
+#else
+  return {v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7]};
+#endif
+}
+
+inline quad8::type quad8::set(quad::pref lo, quad::pref hi)
+{
+#if VML_USE_AVX
+  return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+#else
+  return {quad::x(lo), quad::y(lo), quad::z(lo), quad::w(lo), quad::x(hi), quad::y(hi), quad::z(hi), quad::w(hi)};
+#endif
+}
+
+inline void quad8::store(scalar_type* o, quad8::pref v)
+{
+#if VML_USE_AVX
+  _mm256_store_ps(o, v);
+#else
+  for (std::uint32_t i = 0; i < element_count; ++i)
+    o[i] = v[i];
+#endif
+}
+
+inline void quad8::store_unaligned(scalar_type* o, quad8::pref v)
+{
+#if VML_USE_AVX
+  _mm256_storeu_ps(o, v);
+#else
+  for (std::uint32_t i = 0; i < element_count; ++i)
+    o[i] = v[i];
+#endif
+}
+
+inline quad::type quad8::lo(quad8::pref v)
+{
+#if VML_USE_AVX
+  return _mm256_castps256_ps128(v);
+#else
+  return quad::set(v[0], v[1], v[2], v[3]);
+#endif
+}
+
+inline quad::type quad8::hi(quad8::pref v)
+{
+#if VML_USE_AVX
+  return _mm256_extractf128_ps(v, 1);
+#else
+  return quad::set(v[4], v[5], v[6], v[7]);
+#endif
+}
+
+inline quad8::type quad8::zero()
+{
+#if VML_USE_AVX
+  return _mm256_setzero_ps();
+#else
+  return {0, 0, 0, 0, 0, 0, 0, 0};
+#endif
+}
+
+inline quad8::scalar_type quad8::get(quad8::pref v, std::uint32_t idx)
+{
+#if VML_USE_AVX
+#if defined(_MSC_VER)
+  return v.m256_f32[idx];
+#else
+  return reinterpret_cast<scalar_type const*>(&v)[idx];
+#endif
+#else
+  return v[idx];
+#endif
+}
+
+inline quad8::type quad8::min(quad8::pref a, quad8::pref b)
+{
+#if VML_USE_AVX
+  return _mm256_min_ps(a, b);
+#else
+  type r;
+  for (std::uint32_t i = 0; i < element_count; ++i)
+    r[i] = std::min(a[i], b[i]);
+  return r;
+#endif
+}
+
+inline quad8::type quad8::max(quad8::pref a, quad8::pref b)
+{
+#if VML_USE_AVX
+  return _mm256_max_ps(a, b);
+#else
+  type r;
+  for (std::uint32_t i = 0; i < element_count; ++i)
+    r[i] = std::max(a[i], b[i]);
+  return r;
+#endif
+}
+
+inline quad8::type quad8::abs(quad8::pref v)
+{
+#if VML_USE_AVX
+  return _mm256_and_ps(v, _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff)));
+#else
+  type r;
+  for (std::uint32_t i = 0; i < element_count; ++i)
+    r[i] = vml::abs(v[i]);
+  return r;
+#endif
+}
+
+inline quad8::type quad8::negate(quad8::pref v)
+{
+#if VML_USE_AVX
+  return _mm256_xor_ps(v, _mm256_set1_ps(-0.0f));
+#else
+  type r;
+  for (std::uint32_t i = 0; i < element_count; ++i)
+    r[i] = -v[i];
+  return r;
+#endif
+}
+
+inline quad8::type quad8::add(quad8::pref a, quad8::pref b)
+{
+#if VML_USE_AVX
+  return _mm256_add_ps(a, b);
+#else
+  type r;
+  for (std::uint32_t i = 0; i < element_count; ++i)
+    r[i] = a[i] + b[i];
+  return r;
+#endif
+}
+
+inline quad8::type quad8::sub(quad8::pref a, quad8::pref b)
+{
+#if VML_USE_AVX
+  return _mm256_sub_ps(a, b);
+#else
+  type r;
+  for (std::uint32_t i = 0; i < element_count; ++i)
+    r[i] = a[i] - b[i];
+  return r;
+#endif
+}
+
+inline quad8::type quad8::mul(quad8::pref a, quad8::pref b)
+{
+#if VML_USE_AVX
+  return _mm256_mul_ps(a, b);
+#else
+  type r;
+  for (std::uint32_t i = 0; i < element_count; ++i)
+    r[i] = a[i] * b[i];
+  return r;
+#endif
+}
+
+inline quad8::type quad8::mul(quad8::pref a, scalar_type b)
+{
+  return quad8::mul(a, quad8::set(b));
+}
+
+inline quad8::type quad8::div(quad8::pref a, quad8::pref b)
+{
+#if VML_USE_AVX
+  return _mm256_div_ps(a, b);
+#else
+  type r;
+  for (std::uint32_t i = 0; i < element_count; ++i)
+    r[i] = a[i] / b[i];
+  return r;
+#endif
+}
+
+inline quad8::type quad8::madd(quad8::pref v, quad8::pref m, quad8::pref a)
+{
+#if VML_USE_AVX
+#if VML_USE_FMA
+  return _mm256_fmadd_ps(v, m, a);
+#else
+  return _mm256_add_ps(_mm256_mul_ps(v, m), a);
+#endif
+#else
+  return quad8::add(quad8::mul(v, m), a);
+#endif
+}
+
+inline quad8::type quad8::sqrt(quad8::pref v)
+{
+#if VML_USE_AVX
+  return _mm256_sqrt_ps(v);
+#else
+  type r;
+  for (std::uint32_t i = 0; i < element_count; ++i)
+    r[i] = vml::sqrt(v[i]);
+  return r;
+#endif
+}
+
+inline quad8::type quad8::recip_sqrt(quad8::pref v)
+{
+#if VML_USE_AVX
+#if VML_PREFER_SPEED_OVER_ACCURACY
+  return _mm256_rsqrt_ps(v);
+#else
+  const __m256 approx = _mm256_rsqrt_ps(v);
+  const __m256 muls   = _mm256_mul_ps(_mm256_mul_ps(v, approx), approx);
+  return _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), approx), _mm256_sub_ps(_mm256_set1_ps(3.0f), muls));
+#endif
+#else
+  type r;
+  for (std::uint32_t i = 0; i < element_count; ++i)
+    r[i] = vml::recip_sqrt(v[i]);
+  return r;
+#endif
+}
+
+inline quad8::type quad8::recip(quad8::pref v)
+{
+#if VML_USE_AVX
+#if VML_PREFER_SPEED_OVER_ACCURACY
+  const __m256 approx = _mm256_rcp_ps(v);
+  return _mm256_mul_ps(approx, _mm256_sub_ps(_mm256_set1_ps(2.0f), _mm256_mul_ps(v, approx)));
+#else
+  return _mm256_div_ps(_mm256_set1_ps(1.0f), v);
+#endif
+#else
+  type r;
+  for (std::uint32_t i = 0; i < element_count; ++i)
+    r[i] = 1.0f / v[i];
+  return r;
+#endif
+}
+
+inline quad8::type quad8::select(quad8::pref v1, quad8::pref v2, quad8::pref control)
+{
+#if VML_USE_AVX
+  return _mm256_or_ps(_mm256_andnot_ps(control, v1), _mm256_and_ps(v2, control));
+#else
+  return quad8::bit_or(quad8::bit_andnot(control, v1), quad8::bit_and(v2, control));
+#endif
+}
+
+inline quad8::type quad8::bit_and(quad8::pref a, quad8::pref b)
+{
+#if VML_USE_AVX
+  return _mm256_and_ps(a, b);
+#else
+  type                 r;
+  std::uint32_t*       ir = reinterpret_cast<std::uint32_t*>(&r);
+  std::uint32_t const* ia = reinterpret_cast<std::uint32_t const*>(&a);
+  std::uint32_t const* ib = reinterpret_cast<std::uint32_t const*>(&b);
+  for (std::uint32_t i = 0; i < element_count; ++i)
+    ir[i] = ia[i] & ib[i];
+  return r;
+#endif
+}
+
+inline quad8::type quad8::bit_or(quad8::pref a, quad8::pref b)
+{
+#if VML_USE_AVX
+  return _mm256_or_ps(a, b);
+#else
+  type                 r;
+  std::uint32_t*       ir = reinterpret_cast<std::uint32_t*>(&r);
+  std::uint32_t const* ia = reinterpret_cast<std::uint32_t const*>(&a);
+  std::uint32_t const* ib = reinterpret_cast<std::uint32_t const*>(&b);
+  for (std::uint32_t i = 0; i < element_count; ++i)
+    ir[i] = ia[i] | ib[i];
+  return r;
+#endif
+}
+
+inline quad8::type quad8::bit_andnot(quad8::pref a, quad8::pref b)
+{
+#if VML_USE_AVX
+  return _mm256_andnot_ps(a, b);
+#else
+  type                 r;
+  std::uint32_t*       ir = reinterpret_cast<std::uint32_t*>(&r);
+  std::uint32_t const* ia = reinterpret_cast<std::uint32_t const*>(&a);
+  std::uint32_t const* ib = reinterpret_cast<std::uint32_t const*>(&b);
+  for (std::uint32_t i = 0; i < element_count; ++i)
+    ir[i] = ~ia[i] & ib[i];
+  return r;
+#endif
+}
+
+inline quad8::type quad8::lesserv(quad8::pref a, quad8::pref b)
+{
+#if VML_USE_AVX
+  return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+#else
+  return detail::quad8_compare(a, b, std::less<>());
+#endif
+}
+
+inline quad8::type quad8::lesser_equalv(quad8::pref a, quad8::pref b)
+{
+#if VML_USE_AVX
+  return _mm256_cmp_ps(a, b, _CMP_LE_OQ);
+#else
+  return detail::quad8_compare(a, b, std::less_equal<>());
+#endif
+}
+
+inline quad8::type quad8::greaterv(quad8::pref a, quad8::pref b)
+{
+#if VML_USE_AVX
+  return _mm256_cmp_ps(a, b, _CMP_GT_OQ);
+#else
+  return detail::quad8_compare(a, b, std::greater<>());
+#endif
+}
+
+inline quad8::type quad8::greater_equalv(quad8::pref a, quad8::pref b)
+{
+#if VML_USE_AVX
+  return _mm256_cmp_ps(a, b, _CMP_GE_OQ);
+#else
+  return detail::quad8_compare(a, b, std::greater_equal<>());
+#endif
+}
+
+inline quad8::type quad8::equalv(quad8::pref a, quad8::pref b)
+{
+#if VML_USE_AVX
+  return _mm256_cmp_ps(a, b, _CMP_EQ_OQ);
+#else
+  return detail::quad8_compare(a, b, std::equal_to<>());
+#endif
+}
+
+inline std::uint32_t quad8::mask(quad8::pref v)
+{
+#if VML_USE_AVX
+  return static_cast<std::uint32_t>(_mm256_movemask_ps(v));
+#else
+  std::uint32_t        r  = 0;
+  std::uint32_t const* iv = reinterpret_cast<std::uint32_t const*>(&v);
+  for (std::uint32_t i = 0; i < element_count; ++i)
+    r |= (iv[i] >> 31) << i;
+  return r;
+#endif
+}
+
+inline bool quad8::any(quad8::pref v)
+{
+  return quad8::mask(v) != 0;
+}
+
+inline bool quad8::all(quad8::pref v)
+{
+  return quad8::mask(v) == 0xff;
+}
+
+inline bool quad8::greater_all(quad8::pref a, quad8::pref b)
+{
+  return quad8::all(quad8::greaterv(a, b));
+}
+
+inline bool quad8::greater_any(quad8::pref a, quad8::pref b)
+{
+  return quad8::any(quad8::greaterv(a, b));
+}
+
+inline bool quad8::lesser_all(quad8::pref a, quad8::pref b)
+{
+  return quad8::all(quad8::lesserv(a, b));
+}
+
+inline bool quad8::lesser_any(quad8::pref a, quad8::pref b)
+{
+  return quad8::any(quad8::lesserv(a, b));
+}
+
+inline quad8::scalar_type quad8::hadd(quad8::pref v)
+{
+#if VML_USE_AVX
+  return quad::hadd(_mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+#else
+  scalar_type r = 0;
+  for (std::uint32_t i = 0; i < element_count; ++i)
+    r += v[i];
+  return r;
+#endif
+}
+
+} // namespace vml
@@ -84,8 +84,9 @@ inline quat::type quat::from_mat3(mat3_t const& m)
   trace = m.e[0][0] + m.e[1][1] + m.e[2][2] + 1.0f;
   if (trace > 0.0f)
   {
-    return set((m.e[1][2] - m.e[2][1]) / (2.0f * sqrt(trace)), (m.e[2][0] - m.e[0][2]) / (2.0f * sqrt(trace)),
-               (m.e[0][1] - m.e[1][0]) / (2.0f * sqrt(trace)), sqrt(trace) / 2.0f);
+    return set((m.e[1][2] - m.e[2][1]) / (2.0f * vml::sqrt(trace)),
+               (m.e[2][0] - m.e[0][2]) / (2.0f * vml::sqrt(trace)),
+               (m.e[0][1] - m.e[1][0]) / (2.0f * vml::sqrt(trace)), vml::sqrt(trace) / 2.0f);
   }
   maxi    = 0;
   maxdiag = m.e[0][0];
@@ -106,19 +107,19 @@ inline quat::type quat::from_mat3(mat3_t const& m)
   switch (maxi)
   {
   case 0:
-    s    = 2.0f * sqrt(1.0f + m.e[0][0] - m.e[1][1] - m.e[2][2]);
+    s    = 2.0f * vml::sqrt(1.0f + m.e[0][0] - m.e[1][1] - m.e[2][2]);
     invS = 1 / s;
     return set(0.25f * s, (m.e[0][1] + m.e[1][0]) * invS, (m.e[0][2] + m.e[2][0]) * invS,
                (m.e[1][2] - m.e[2][1]) * invS);
 
   case 1:
-    s    = 2.0f * sqrt(1.0f + m.e[1][1] - m.e[0][0] - m.e[2][2]);
+    s    = 2.0f * vml::sqrt(1.0f + m.e[1][1] - m.e[0][0] - m.e[2][2]);
     invS = 1 / s;
     return set((m.e[0][1] + m.e[1][0]) * invS, 0.25f * s, (m.e[1][2] + m.e[2][1]) * invS,
                (m.e[2][0] - m.e[0][2]) * invS);
   case 2:
   default:
-    s    = 2.0f * sqrt(1.0f + m.e[2][2] - m.e[0][0] - m.e[1][1]);
+    s    = 2.0f * vml::sqrt(1.0f + m.e[2][2] - m.e[0][0] - m.e[1][1]);
     invS = 1 / s;
     return set((m.e[0][2] + m.e[2][0]) * invS, (m.e[1][2] + m.e[2][1]) * invS, 0.25f * s,
                (m.e[0][1] - m.e[1][0]) * invS);
@@ -127,7 +128,7 @@ inline quat::type quat::from_mat3(mat3_t const& m)
 inline quat::type quat::mul(pref q1, pref q2)
 {
 #if VML_USE_SSE_AVX
-#if VML_USE_SSE_LEVEL >= 3
+#if VML_USE_SSE_LEVEL >= 3 && !VML_USE_FMA
 #define _mm_pshufd(r, i) vml_cast_i_to_v(_mm_shuffle_epi32(vml_cast_v_to_i(r), i))
   // @link
   // http://momchil-velikov.blogspot.com/2013/10/fast-sse-quternion-multiplication.html
@@ -184,6 +185,7 @@ inline quat::type quat::mul(pref q1, pref q2)
 #define _mm_pshufd(r, i) vml_cast_i_to_v(_mm_shuffle_epi32(vml_cast_v_to_i(r), i))
 
   // Copy to SSE registers and use as few as possible for x86
+  // Signs are flipped on q1 before the multiply so each term is a single madd
   __m128 result;
   {
     result = vml::quad::mul(vml::quad::splat_w(q2), q1);
@@ -191,23 +193,20 @@ inline quat::type quat::mul(pref q1, pref q2)
   {
     const __m128i k_sign = _mm_set_epi32(0x80000000, 0x80000000, 0x00000000, 0x00000000);
     __m128        t      = _mm_pshufd(q1, _MM_SHUFFLE(0, 1, 2, 3));
-    t                    = vml::quad::mul(vml::quad::splat_x(q2), t);
     t                    = _mm_xor_ps(t, vml_cast_i_to_v(k_sign));
-    result               = vml::quad::add(t, result);
+    result               = vml::quad::madd(vml::quad::splat_x(q2), t, result);
   }
   {
     const __m128i k_sign = _mm_set_epi32(0x80000000, 0x00000000, 0x00000000, 0x80000000);
     __m128        t      = _mm_pshufd(q1, _MM_SHUFFLE(1, 0, 3, 2));
-    t                    = vml::quad::mul(vml::quad::splat_y(q2), t);
     t                    = _mm_xor_ps(t, vml_cast_i_to_v(k_sign));
-    result               = vml::quad::add(t, result);
+    result               = vml::quad::madd(vml::quad::splat_y(q2), t, result);
   }
   {
     const __m128i k_sign = _mm_set_epi32(0x80000000, 0x00000000, 0x80000000, 0x00000000);
     __m128        t      = _mm_pshufd(q1, _MM_SHUFFLE(2, 3, 0, 1));
-    t                    = vml::quad::mul(vml::quad::splat_z(q2), t);
     t                    = _mm_xor_ps(t, vml_cast_i_to_v(k_sign));
-    result               = vml::quad::add(t, result);
+    result               = vml::quad::madd(vml::quad::splat_z(q2), t, result);
   }
   return result;
 #endif
@@ -0,0 +1,126 @@
+#pragma once
+#include "vec3xn.hpp"
+
+namespace vml
+{
+//! Structure of arrays quat over quad (4 quaternions) or quad8 (8 quaternions), mirrors quat
+template <typename lane>
+struct quatxn
+{
+  using lane_type   = typename lane::type;
+  using lane_pref   = typename lane::pref;
+  using type        = quatxn_t<lane_type>;
+  using ref         = type&;
+  using pref        = type const&;
+  using cref        = type const&;
+  using scalar_type = float;
+  using row_type    = lane_type;
+  using vec3_type   = vec3xn_t<lane_type>;
+
+  enum : unsigned int
+  {
+    element_count = lane::element_count
+  };
+
+  static inline type set(lane_pref x, lane_pref y, lane_pref z, lane_pref w);
+  //! Broadcast q to all lanes
+  static inline type set(quat_t const& q);
+  static inline type identity();
+  //! Load element_count quaternions, AoS to SoA
+  static inline type load(quat_t const* q);
+  //! Store element_count quaternions, SoA to AoS
+  static inline void store(quat_t* o, pref q);
+  //! Return the quaternion in lane i
+  static inline quat_t    get(pref q, std::uint32_t i);
+  static inline type      conjugate(pref q);
+  static inline lane_type dot(pref q1, pref q2);
+  static inline type      normalize(pref q);
+  static inline type      mul(pref q1, pref q2);
+  static inline vec3_type transform(pref q, vec3_type const& v);
+};
+
+using quatx4 = quatxn<quad>;
+using quatx8 = quatxn<quad8>;
+
+template <typename lane>
+inline typename quatxn<lane>::type quatxn<lane>::set(lane_pref x, lane_pref y, lane_pref z, lane_pref w)
+{
+  return {x, y, z, w};
+}
+
+template <typename lane>
+inline typename quatxn<lane>::type quatxn<lane>::set(quat_t const& q)
+{
+  return {lane::set(quad::x(q)), lane::set(quad::y(q)), lane::set(quad::z(q)), lane::set(quad::w(q))};
+}
+
+template <typename lane>
+inline typename quatxn<lane>::type quatxn<lane>::identity()
+{
+  return {lane::zero(), lane::zero(), lane::zero(), lane::set(1.0f)};
+}
+
+template <typename lane>
+inline typename quatxn<lane>::type quatxn<lane>::load(quat_t const* q)
+{
+  lane_type o[4];
+  detail::lanes_from_quads<lane>(q, o);
+  return {o[0], o[1], o[2], o[3]};
+}
+
+template <typename lane>
+inline void quatxn<lane>::store(quat_t* o, pref q)
+{
+  lane_type const l[4] = {q.x, q.y, q.z, q.w};
+  detail::lanes_to_quads<lane>(l, o);
+}
+
+template <typename lane>
+inline quat_t quatxn<lane>::get(pref q, std::uint32_t i)
+{
+  return quad::set(lane::get(q.x, i), lane::get(q.y, i), lane::get(q.z, i), lane::get(q.w, i));
+}
+
+template <typename lane>
+inline typename quatxn<lane>::type quatxn<lane>::conjugate(pref q)
+{
+  return {lane::negate(q.x), lane::negate(q.y), lane::negate(q.z), q.w};
+}
+
+template <typename lane>
+inline typename quatxn<lane>::lane_type quatxn<lane>::dot(pref q1, pref q2)
+{
+  return lane::madd(q1.w, q2.w, lane::madd(q1.z, q2.z, lane::madd(q1.y, q2.y, lane::mul(q1.x, q2.x))));
+}
+
+template <typename lane>
+inline typename quatxn<lane>::type quatxn<lane>::normalize(pref q)
+{
+  lane_type l = lane::sqrt(dot(q, q));
+  return {lane::div(q.x, l), lane::div(q.y, l), lane::div(q.z, l), lane::div(q.w, l)};
+}
+
+template <typename lane>
+inline typename quatxn<lane>::type quatxn<lane>::mul(pref q1, pref q2)
+{
+  // Same term order as quat::mul
+  type r;
+  r.x = lane::madd(q2.z, q1.y, lane::sub(lane::madd(q2.x, q1.w, lane::mul(q2.w, q1.x)), lane::mul(q2.y, q1.z)));
+  r.y = lane::sub(lane::madd(q2.y, q1.w, lane::madd(q2.x, q1.z, lane::mul(q2.w, q1.y))), lane::mul(q2.z, q1.x));
+  r.z = lane::madd(q2.z, q1.w, lane::madd(q2.y, q1.x, lane::sub(lane::mul(q2.w, q1.z), lane::mul(q2.x, q1.y))));
+  r.w = lane::sub(lane::sub(lane::sub(lane::mul(q2.w, q1.w), lane::mul(q2.x, q1.x)), lane::mul(q2.y, q1.y)),
+                  lane::mul(q2.z, q1.z));
+  return r;
+}
+
+template <typename lane>
+inline typename quatxn<lane>::vec3_type quatxn<lane>::transform(pref q, vec3_type const& v)
+{
+  using vec3 = vec3xn<lane>;
+  vec3_type u   = {q.x, q.y, q.z};
+  vec3_type uv  = vec3::cross(u, v);
+  vec3_type uuv = vec3::cross(u, uv);
+  return vec3::add(vec3::add(v, vec3::mul(uv, lane::add(q.w, q.w))), vec3::add(uuv, uuv));
+}
+
+} // namespace vml
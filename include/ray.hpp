@@ -0,0 +1,296 @@
+#pragma once
+
+#include "aabb.hpp"
+#include "mat4.hpp"
+#include "plane.hpp"
+#include "sphere.hpp"
+#include "vec3xn.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace vml
+{
+//! Ray with the reciprocal of its direction and the direction signs precomputed for slab tests
+struct ray_t
+{
+  vec3a_t origin;
+  //! Not normalized, t values are in units of its length
+  vec3a_t direction;
+  //! 1 / direction, FLT_MAX on axes the ray is parallel to
+  vec3a_t inv_direction;
+  //! Bit a set if component a of direction is negative, picks the near face of a box per axis
+  std::uint32_t sign;
+};
+
+struct ray
+{
+  static inline ray_t set(vec3a::pref origin, vec3a::pref direction);
+  //! Ray from origin through target, t = 1 at target
+  static inline ray_t from_points(vec3a::pref origin, vec3a::pref target);
+  /**
+   * @remarks Ray through the normalized device coordinates (x, y), in [-1, 1] with y up, from the
+   * near plane at t = 0 to the far plane at t = 1. inv_view_projection is the inverse of the view
+   * projection matrix, with depth in [0, 1] as for the mat4 projections.
+   */
+  static inline ray_t from_ndc(mat4::pref inv_view_projection, float x, float y);
+  //! Ray through pixel (px, py) of a width x height viewport with y down, as from_ndc
+  static inline ray_t   from_screen(mat4::pref inv_view_projection, float px, float py, float width, float height);
+  static inline vec3a_t at(ray_t const& r, float t);
+  //! Entry distance into box in [0, t_max], 0 if origin is inside, negative on a miss
+  static inline float intersect_box(ray_t const& r, aabb_t const& box, float t_max);
+  //! Entry distance into sphere in [0, t_max], 0 if origin is inside, negative on a miss
+  static inline float intersect_sphere(ray_t const& r, sphere_t const& s, float t_max);
+  //! Distance to the plane in [0, t_max], negative on a miss or if the ray is parallel to it
+  static inline float intersect_plane(ray_t const& r, plane_t const& p, float t_max);
+};
+
+/**
+ * @remarks One ray against quad (4) or quad8 (8) primitives per call. The ray is broadcast once
+ * with set, then every test returns a hit mask with bit k set for primitive k and fills lane k of
+ * o_t with its distance, same as the ray functions of the same name. Arrays passed to the tests
+ * hold element_count primitives.
+ */
+template <typename lane>
+struct rayxn
+{
+  using lane_type = typename lane::type;
+  using vec3_type = vec3xn_t<lane_type>;
+
+  enum : unsigned int
+  {
+    element_count = lane::element_count
+  };
+
+  struct type
+  {
+    vec3_type     origin;
+    vec3_type     direction;
+    vec3_type     inv_direction;
+    lane_type     inv_length_sq;
+    std::uint32_t sign;
+  };
+
+  //! Broadcast r to all lanes
+  static inline type          set(ray_t const& r);
+  static inline std::uint32_t intersect_boxes(type const& r, aabb_t const* boxes, float t_max, lane_type& o_t);
+  //! Same as intersect_boxes over box bounds already in SoA, lane k of lo and hi is box k
+  static inline std::uint32_t intersect_boxes(type const& r, vec3_type const& lo, vec3_type const& hi, float t_max,
+                                              lane_type& o_t);
+  static inline std::uint32_t intersect_spheres(type const& r, sphere_t const* spheres, float t_max, lane_type& o_t);
+  static inline std::uint32_t intersect_planes(type const& r, plane_t const* planes, float t_max, lane_type& o_t);
+  /**
+   * @remarks Möller–Trumbore test against triangles given as 3 vertices each, either side facing.
+   * o_u and o_v receive the barycentric coordinates of the second and third vertex at the hits.
+   */
+  static inline std::uint32_t intersect_triangles(type const& r, vec3a_t const* vertices, float t_max, lane_type& o_t,
+                                                  lane_type& o_u, lane_type& o_v);
+  //! Same as intersect_triangles over triangles in SoA as their first vertex and the edges from it to the others
+  static inline std::uint32_t intersect_triangles(type const& r, vec3_type const& v0, vec3_type const& e1,
+                                                  vec3_type const& e2, float t_max, lane_type& o_t, lane_type& o_u,
+                                                  lane_type& o_v);
+};
+
+using rayx4 = rayxn<quad>;
+using rayx8 = rayxn<quad8>;
+
+inline ray_t ray::set(vec3a::pref origin, vec3a::pref direction)
+{
+  auto recip = [](float d)
+  {
+    return d != 0.0f ? 1.0f / d : std::numeric_limits<float>::max();
+  };
+  float const x = vec3a::x(direction);
+  float const y = vec3a::y(direction);
+  float const z = vec3a::z(direction);
+  return {origin, direction, vec3a::set(recip(x), recip(y), recip(z)),
+          (x < 0.0f ? 1u : 0u) | (y < 0.0f ? 2u : 0u) | (z < 0.0f ? 4u : 0u)};
+}
+
+inline ray_t ray::from_points(vec3a::pref origin, vec3a::pref target)
+{
+  return set(origin, vec3a::sub(target, origin));
+}
+
+inline ray_t ray::from_ndc(mat4::pref inv_view_projection, float x, float y)
+{
+  vec3a_t const near = vec3a::from_vec4(mat4::transform_and_project(inv_view_projection, vec3a::set(x, y, 0.0f)));
+  vec3a_t const far  = vec3a::from_vec4(mat4::transform_and_project(inv_view_projection, vec3a::set(x, y, 1.0f)));
+  return from_points(near, far);
+}
+
+inline ray_t ray::from_screen(mat4::pref inv_view_projection, float px, float py, float width, float height)
+{
+  return from_ndc(inv_view_projection, 2.0f * px / width - 1.0f, 1.0f - 2.0f * py / height);
+}
+
+inline vec3a_t ray::at(ray_t const& r, float t)
+{
+  return vec3a::madd(r.direction, vec3a::set(t), r.origin);
+}
+
+inline float ray::intersect_box(ray_t const& r, aabb_t const& box, float t_max)
+{
+  vec3a_t const t0    = vec3a::mul(vec3a::sub(box.r[0], r.origin), r.inv_direction);
+  vec3a_t const t1    = vec3a::mul(vec3a::sub(box.r[1], r.origin), r.inv_direction);
+  vec3a_t const near  = vec3a::min(t0, t1);
+  vec3a_t const far   = vec3a::max(t0, t1);
+  float const   enter = std::max({vec3a::x(near), vec3a::y(near), vec3a::z(near), 0.0f});
+  float const   exit  = std::min({vec3a::x(far), vec3a::y(far), vec3a::z(far), t_max});
+  return enter <= exit ? enter : -1.0f;
+}
+
+inline float ray::intersect_sphere(ray_t const& r, sphere_t const& s, float t_max)
+{
+  vec3a_t const oc   = vec3a::sub(r.origin, sphere::center(s));
+  float const   a    = vec3a::dot(r.direction, r.direction);
+  float const   b    = vec3a::dot(oc, r.direction);
+  float const   c    = vec3a::dot(oc, oc) - sphere::radius(s) * sphere::radius(s);
+  float const   disc = b * b - a * c;
+  if (disc < 0.0f)
+    return -1.0f;
+  float const root  = std::sqrt(disc);
+  float const enter = std::max((-b - root) / a, 0.0f);
+  return (-b + root) / a >= 0.0f && enter <= t_max ? enter : -1.0f;
+}
+
+inline float ray::intersect_plane(ray_t const& r, plane_t const& p, float t_max)
+{
+  float const den = vec3a::dot(plane::get_normal(p), r.direction);
+  if (den == 0.0f)
+    return -1.0f;
+  float const t = -plane::dot(p, r.origin) / den;
+  return t >= 0.0f && t <= t_max ? t : -1.0f;
+}
+
+template <typename lane>
+inline typename rayxn<lane>::type rayxn<lane>::set(ray_t const& r)
+{
+  auto const broadcast = [](vec3a::pref v) -> vec3_type
+  {
+    return {lane::set(vec3a::x(v)), lane::set(vec3a::y(v)), lane::set(vec3a::z(v))};
+  };
+  return {broadcast(r.origin), broadcast(r.direction), broadcast(r.inv_direction),
+          lane::set(1.0f / vec3a::dot(r.direction, r.direction)), r.sign};
+}
+
+template <typename lane>
+inline std::uint32_t rayxn<lane>::intersect_boxes(type const& r, aabb_t const* boxes, float t_max, lane_type& o_t)
+{
+  quad_t lo[element_count];
+  quad_t hi[element_count];
+  for (std::uint32_t k = 0; k < element_count; ++k)
+  {
+    lo[k] = boxes[k].r[0];
+    hi[k] = boxes[k].r[1];
+  }
+  lane_type l[4];
+  lane_type h[4];
+  detail::lanes_from_quads<lane>(lo, l);
+  detail::lanes_from_quads<lane>(hi, h);
+  return intersect_boxes(r, {l[0], l[1], l[2]}, {h[0], h[1], h[2]}, t_max, o_t);
+}
+
+template <typename lane>
+inline std::uint32_t rayxn<lane>::intersect_boxes(type const& r, vec3_type const& lo, vec3_type const& hi, float t_max,
+                                                  lane_type& o_t)
+{
+  // The sign picks the near and far face per axis, no min and max of the slab distances needed
+  lane_type const near_x = lane::mul(lane::sub(r.sign & 1 ? hi.x : lo.x, r.origin.x), r.inv_direction.x);
+  lane_type const far_x  = lane::mul(lane::sub(r.sign & 1 ? lo.x : hi.x, r.origin.x), r.inv_direction.x);
+  lane_type const near_y = lane::mul(lane::sub(r.sign & 2 ? hi.y : lo.y, r.origin.y), r.inv_direction.y);
+  lane_type const far_y  = lane::mul(lane::sub(r.sign & 2 ? lo.y : hi.y, r.origin.y), r.inv_direction.y);
+  lane_type const near_z = lane::mul(lane::sub(r.sign & 4 ? hi.z : lo.z, r.origin.z), r.inv_direction.z);
+  lane_type const far_z  = lane::mul(lane::sub(r.sign & 4 ? lo.z : hi.z, r.origin.z), r.inv_direction.z);
+  lane_type const enter  = lane::max(lane::max(near_x, near_y), lane::max(near_z, lane::zero()));
+  lane_type const exit   = lane::min(lane::min(far_x, far_y), lane::min(far_z, lane::set(t_max)));
+  o_t                    = enter;
+  return lane::mask(lane::lesser_equalv(enter, exit));
+}
+
+template <typename lane>
+inline std::uint32_t rayxn<lane>::intersect_spheres(type const& r, sphere_t const* spheres, float t_max,
+                                                    lane_type& o_t)
+{
+  lane_type s[4];
+  detail::lanes_from_quads<lane>(spheres, s);
+  lane_type const ox   = lane::sub(r.origin.x, s[0]);
+  lane_type const oy   = lane::sub(r.origin.y, s[1]);
+  lane_type const oz   = lane::sub(r.origin.z, s[2]);
+  lane_type const a    = lane::madd(r.direction.x, r.direction.x,
+                                    lane::madd(r.direction.y, r.direction.y, lane::mul(r.direction.z, r.direction.z)));
+  lane_type const b    = lane::madd(ox, r.direction.x, lane::madd(oy, r.direction.y, lane::mul(oz, r.direction.z)));
+  lane_type const c    = lane::sub(lane::madd(ox, ox, lane::madd(oy, oy, lane::mul(oz, oz))), lane::mul(s[3], s[3]));
+  lane_type const disc = lane::sub(lane::mul(b, b), lane::mul(a, c));
+  lane_type const root = lane::sqrt(lane::max(disc, lane::zero()));
+  lane_type const nb   = lane::negate(b);
+  lane_type const exit = lane::mul(lane::add(nb, root), r.inv_length_sq);
+  o_t                  = lane::max(lane::mul(lane::sub(nb, root), r.inv_length_sq), lane::zero());
+  lane_type const hit  = lane::bit_and(lane::bit_and(lane::greater_equalv(disc, lane::zero()),
+                                                     lane::greater_equalv(exit, lane::zero())),
+                                       lane::lesser_equalv(o_t, lane::set(t_max)));
+  return lane::mask(hit);
+}
+
+template <typename lane>
+inline std::uint32_t rayxn<lane>::intersect_planes(type const& r, plane_t const* planes, float t_max, lane_type& o_t)
+{
+  lane_type p[4];
+  detail::lanes_from_quads<lane>(planes, p);
+  lane_type const den =
+    lane::madd(p[0], r.direction.x, lane::madd(p[1], r.direction.y, lane::mul(p[2], r.direction.z)));
+  lane_type const num = lane::madd(p[0], r.origin.x, lane::madd(p[1], r.origin.y, lane::madd(p[2], r.origin.z, p[3])));
+  o_t                 = lane::div(lane::negate(num), den);
+  lane_type const hit = lane::bit_and(lane::bit_and(lane::greaterv(lane::abs(den), lane::zero()),
+                                                    lane::greater_equalv(o_t, lane::zero())),
+                                      lane::lesser_equalv(o_t, lane::set(t_max)));
+  return lane::mask(hit);
+}
+
+template <typename lane>
+inline std::uint32_t rayxn<lane>::intersect_triangles(type const& r, vec3a_t const* vertices, float t_max,
+                                                      lane_type& o_t, lane_type& o_u, lane_type& o_v)
+{
+  quad_t v0[element_count];
+  quad_t e1[element_count];
+  quad_t e2[element_count];
+  for (std::uint32_t k = 0; k < element_count; ++k)
+  {
+    v0[k] = vertices[k * 3];
+    e1[k] = vec3a::sub(vertices[k * 3 + 1], v0[k]);
+    e2[k] = vec3a::sub(vertices[k * 3 + 2], v0[k]);
+  }
+  lane_type l0[4];
+  lane_type l1[4];
+  lane_type l2[4];
+  detail::lanes_from_quads<lane>(v0, l0);
+  detail::lanes_from_quads<lane>(e1, l1);
+  detail::lanes_from_quads<lane>(e2, l2);
+  return intersect_triangles(r, {l0[0], l0[1], l0[2]}, {l1[0], l1[1], l1[2]}, {l2[0], l2[1], l2[2]}, t_max, o_t, o_u,
+                             o_v);
+}
+
+template <typename lane>
+inline std::uint32_t rayxn<lane>::intersect_triangles(type const& r, vec3_type const& v0, vec3_type const& e1,
+                                                      vec3_type const& e2, float t_max, lane_type& o_t,
+                                                      lane_type& o_u, lane_type& o_v)
+{
+  using vec3xn         = vml::vec3xn<lane>;
+  vec3_type const pvec = vec3xn::cross(r.direction, e2);
+  lane_type const det  = vec3xn::dot(e1, pvec);
+  lane_type const inv  = lane::div(lane::set(1.0f), det);
+  vec3_type const tvec = vec3xn::sub(r.origin, v0);
+  vec3_type const qvec = vec3xn::cross(tvec, e1);
+  o_u                  = lane::mul(vec3xn::dot(tvec, pvec), inv);
+  o_v                  = lane::mul(vec3xn::dot(r.direction, qvec), inv);
+  o_t                  = lane::mul(vec3xn::dot(e2, qvec), inv);
+  lane_type const zero = lane::zero();
+  // Degenerate triangles and rays parallel to them give an infinite or nan inv, the det test drops them
+  lane_type hit = lane::greaterv(lane::abs(det), lane::set(std::numeric_limits<float>::min()));
+  hit           = lane::bit_and(hit, lane::bit_and(lane::greater_equalv(o_u, zero), lane::greater_equalv(o_v, zero)));
+  hit           = lane::bit_and(hit, lane::lesser_equalv(lane::add(o_u, o_v), lane::set(1.0f)));
+  hit           = lane::bit_and(hit, lane::greater_equalv(o_t, zero));
+  hit           = lane::bit_and(hit, lane::lesser_equalv(o_t, lane::set(t_max)));
+  return lane::mask(hit);
+}
+
+} // namespace vml
@@ -0,0 +1,290 @@
+#pragma once
+
+#include "ray.hpp"
+#include <bit>
+#include <cmath>
+#include <span>
+
+namespace vml
+{
+//! element_count rays of quad (4) or quad8 (8) in SoA, lane k holds ray k
+template <typename lane>
+struct ray_packet_t
+{
+  using lane_type = typename lane::type;
+
+  vec3xn_t<lane_type> origin;
+  vec3xn_t<lane_type> direction;
+  vec3xn_t<lane_type> inv_direction;
+  //! Rays are tested up to t_max, lowered by nearest hit searches
+  lane_type t_max;
+};
+
+/**
+ * @remarks Coherent rays traced together, one lane per ray. Tests take a mask of active rays and
+ * return the mask of active rays that hit, so callers drop rays as they miss and stop once the
+ * mask is empty. bounding_planes encloses the whole packet in planes, boxes outside one of them
+ * are missed by every ray and are culled with a few dot products instead of a slab test per ray.
+ * Packets are as wide as the lane types, so ray_packet8 is the widest: the library targets SSE
+ * up to AVX2 and has no 16 float lane for AVX-512.
+ */
+template <typename lane>
+struct ray_packetn
+{
+  using lane_type = typename lane::type;
+  using vec3xn    = vml::vec3xn<lane>;
+  using type      = ray_packet_t<lane>;
+
+  enum : unsigned int
+  {
+    element_count = lane::element_count
+  };
+
+  //! Nearest hits found by intersect_triangles
+  struct hit_type
+  {
+    lane_type u;
+    lane_type v;
+    //! Triangle hit by ray k, k_no_hit if none
+    std::uint32_t triangle[element_count];
+  };
+
+  static constexpr std::uint32_t k_no_hit = 0xffffffff;
+  //! Mask with every ray active
+  static constexpr std::uint32_t all_active = (1u << element_count) - 1;
+
+  //! Load element_count rays, tested up to t_max
+  static inline type set(ray_t const* rays, float t_max);
+  //! Return ray i
+  static inline ray_t get(type const& p, std::uint32_t i);
+  //! Active rays entering box within their t_max, o_t receives the entry distances
+  static inline std::uint32_t intersect_box(type const& p, aabb_t const& box, std::uint32_t active, lane_type& o_t);
+  /**
+   * @remarks Möller–Trumbore test of the active rays against triangle (v0, v1, v2), either side
+   * facing. Returns the rays hitting it before their t_max, with the distance and the barycentric
+   * coordinates of v1 and v2 in o_t, o_u and o_v.
+   */
+  static inline std::uint32_t intersect_triangle(type const& p, vec3a::pref v0, vec3a::pref v1, vec3a::pref v2,
+                                                 std::uint32_t active, lane_type& o_t, lane_type& o_u,
+                                                 lane_type& o_v);
+  //! intersect_triangle for all rays, returns a lane mask
+  static inline lane_type triangle_hits(type const& p, vec3a::pref v0, vec3a::pref v1, vec3a::pref v2, lane_type& o_t,
+                                        lane_type& o_u, lane_type& o_v);
+  //! Lane k all bits set if bit k of mask is
+  static inline lane_type lanes(std::uint32_t mask);
+  /**
+   * @remarks Nearest hit of each active ray among triangles, given as 3 vertices each. t_max of
+   * rays that hit is lowered to the hit distance, o_hit receives the triangle and barycentrics.
+   * Returns the rays that hit.
+   */
+  static inline std::uint32_t intersect_triangles(type& p, std::span<vec3a_t const> triangles, std::uint32_t active,
+                                                  hit_type& o_hit);
+  /**
+   * @remarks Planes bounding every ray of the packet within [0, t_max], positive inside: four
+   * around the mean direction, one through the origins facing along it and one past the ends of
+   * the rays if every t_max is finite. Returns the plane count, or 0 if the rays spread over more
+   * than the half space around their mean direction.
+   */
+  static inline std::uint32_t bounding_planes(type const& p, plane_t (&o_planes)[6]);
+  //! True if box is outside one of planes, no ray bounded by them hits it
+  static inline bool outside(plane_t const* planes, std::uint32_t count, aabb_t const& box);
+};
+
+using ray_packet4 = ray_packetn<quad>;
+using ray_packet8 = ray_packetn<quad8>;
+
+template <typename lane>
+inline typename ray_packetn<lane>::type ray_packetn<lane>::set(ray_t const* rays, float t_max)
+{
+  quad_t o[element_count];
+  quad_t d[element_count];
+  quad_t i[element_count];
+  for (std::uint32_t k = 0; k < element_count; ++k)
+  {
+    o[k] = rays[k].origin;
+    d[k] = rays[k].direction;
+    i[k] = rays[k].inv_direction;
+  }
+  lane_type lo[4];
+  lane_type ld[4];
+  lane_type li[4];
+  detail::lanes_from_quads<lane>(o, lo);
+  detail::lanes_from_quads<lane>(d, ld);
+  detail::lanes_from_quads<lane>(i, li);
+  return {{lo[0], lo[1], lo[2]}, {ld[0], ld[1], ld[2]}, {li[0], li[1], li[2]}, lane::set(t_max)};
+}
+
+template <typename lane>
+inline ray_t ray_packetn<lane>::get(type const& p, std::uint32_t i)
+{
+  return ray::set(vec3xn::get(p.origin, i), vec3xn::get(p.direction, i));
+}
+
+template <typename lane>
+inline std::uint32_t ray_packetn<lane>::intersect_box(type const& p, aabb_t const& box, std::uint32_t active,
+                                                      lane_type& o_t)
+{
+  if (!active)
+    return 0;
+  vec3xn_t<lane_type> const lo = vec3xn::set(box.r[0]);
+  vec3xn_t<lane_type> const hi = vec3xn::set(box.r[1]);
+  lane_type const           x0 = lane::mul(lane::sub(lo.x, p.origin.x), p.inv_direction.x);
+  lane_type const           x1 = lane::mul(lane::sub(hi.x, p.origin.x), p.inv_direction.x);
+  lane_type const           y0 = lane::mul(lane::sub(lo.y, p.origin.y), p.inv_direction.y);
+  lane_type const           y1 = lane::mul(lane::sub(hi.y, p.origin.y), p.inv_direction.y);
+  lane_type const           z0 = lane::mul(lane::sub(lo.z, p.origin.z), p.inv_direction.z);
+  lane_type const           z1 = lane::mul(lane::sub(hi.z, p.origin.z), p.inv_direction.z);
+  lane_type const           exit =
+    lane::min(lane::min(lane::max(x0, x1), lane::max(y0, y1)), lane::min(lane::max(z0, z1), p.t_max));
+  o_t = lane::max(lane::max(lane::min(x0, x1), lane::min(y0, y1)), lane::max(lane::min(z0, z1), lane::zero()));
+  return lane::mask(lane::lesser_equalv(o_t, exit)) & active;
+}
+
+template <typename lane>
+inline std::uint32_t ray_packetn<lane>::intersect_triangle(type const& p, vec3a::pref v0, vec3a::pref v1,
+                                                           vec3a::pref v2, std::uint32_t active, lane_type& o_t,
+                                                           lane_type& o_u, lane_type& o_v)
+{
+  if (!active)
+    return 0;
+  return lane::mask(triangle_hits(p, v0, v1, v2, o_t, o_u, o_v)) & active;
+}
+
+template <typename lane>
+inline typename ray_packetn<lane>::lane_type ray_packetn<lane>::triangle_hits(type const& p, vec3a::pref v0,
+                                                                              vec3a::pref v1, vec3a::pref v2,
+                                                                              lane_type& o_t, lane_type& o_u,
+                                                                              lane_type& o_v)
+{
+  vec3xn_t<lane_type> const e1   = vec3xn::set(vec3a::sub(v1, v0));
+  vec3xn_t<lane_type> const e2   = vec3xn::set(vec3a::sub(v2, v0));
+  vec3xn_t<lane_type> const pvec = vec3xn::cross(p.direction, e2);
+  lane_type const           det  = vec3xn::dot(e1, pvec);
+  lane_type const           inv  = lane::div(lane::set(1.0f), det);
+  vec3xn_t<lane_type> const tvec = vec3xn::sub(p.origin, vec3xn::set(v0));
+  vec3xn_t<lane_type> const qvec = vec3xn::cross(tvec, e1);
+  o_u                            = lane::mul(vec3xn::dot(tvec, pvec), inv);
+  o_v                            = lane::mul(vec3xn::dot(p.direction, qvec), inv);
+  o_t                            = lane::mul(vec3xn::dot(e2, qvec), inv);
+  lane_type const zero           = lane::zero();
+  // Rays parallel to the triangle give an infinite or nan inv, the det test drops them
+  lane_type hit = lane::greaterv(lane::abs(det), lane::set(std::numeric_limits<float>::min()));
+  hit           = lane::bit_and(hit, lane::bit_and(lane::greater_equalv(o_u, zero), lane::greater_equalv(o_v, zero)));
+  hit           = lane::bit_and(hit, lane::lesser_equalv(lane::add(o_u, o_v), lane::set(1.0f)));
+  return lane::bit_and(hit, lane::bit_and(lane::greater_equalv(o_t, zero), lane::lesserv(o_t, p.t_max)));
+}
+
+template <typename lane>
+inline typename ray_packetn<lane>::lane_type ray_packetn<lane>::lanes(std::uint32_t mask)
+{
+  alignas(32) float bits[element_count];
+  for (std::uint32_t k = 0; k < element_count; ++k)
+    bits[k] = std::bit_cast<float>((mask >> k) & 1 ? 0xffffffffu : 0u);
+  return lane::set(bits);
+}
+
+template <typename lane>
+inline std::uint32_t ray_packetn<lane>::intersect_triangles(type& p, std::span<vec3a_t const> triangles,
+                                                            std::uint32_t active, hit_type& o_hit)
+{
+  std::fill_n(o_hit.triangle, element_count, k_no_hit);
+  o_hit.u = lane::zero();
+  o_hit.v = lane::zero();
+  if (!active)
+    return 0;
+  lane_type const enabled = lanes(active);
+  std::uint32_t   hit     = 0;
+  for (std::uint32_t i = 0, count = static_cast<std::uint32_t>(triangles.size() / 3); i < count; ++i)
+  {
+    lane_type       t, u, v;
+    lane_type const hits = lane::bit_and(
+      triangle_hits(p, triangles[i * 3], triangles[i * 3 + 1], triangles[i * 3 + 2], t, u, v), enabled);
+    std::uint32_t const mask = lane::mask(hits);
+    if (!mask)
+      continue;
+    // t_max drops to the hit, later triangles only replace it if nearer
+    p.t_max = lane::select(p.t_max, t, hits);
+    o_hit.u = lane::select(o_hit.u, u, hits);
+    o_hit.v = lane::select(o_hit.v, v, hits);
+    for (std::uint32_t m = mask; m; m &= m - 1)
+      o_hit.triangle[std::countr_zero(m)] = i;
+    hit |= mask;
+  }
+  return hit;
+}
+
+template <typename lane>
+inline std::uint32_t ray_packetn<lane>::bounding_planes(type const& p, plane_t (&o_planes)[6])
+{
+  vec3a_t origins[element_count];
+  vec3a_t directions[element_count];
+  vec3xn::store(origins, p.origin);
+  vec3xn::store(directions, p.direction);
+  alignas(32) float t_max[element_count];
+  lane::store(t_max, p.t_max);
+
+  vec3a_t mean = vec3a::zero();
+  for (vec3a_t const& d : directions)
+    mean = vec3a::add(mean, vec3a::normalize(d));
+  if (vec3a::dot(mean, mean) == 0.0f)
+    return 0;
+  mean = vec3a::normalize(mean);
+  // Any axis not parallel to mean gives the two others
+  vec3a_t const axis = std::abs(vec3a::x(mean)) < 0.5f ? vec3a::set(1.0f, 0.0f, 0.0f) : vec3a::set(0.0f, 1.0f, 0.0f);
+  vec3a_t const u    = vec3a::normalize(vec3a::cross(mean, axis));
+  vec3a_t const w    = vec3a::cross(mean, u);
+
+  // Slopes of the directions across mean, the side planes pass through the extreme ones
+  float lo_u = std::numeric_limits<float>::max();
+  float hi_u = std::numeric_limits<float>::lowest();
+  float lo_w = lo_u;
+  float hi_w = hi_u;
+  for (vec3a_t const& d : directions)
+  {
+    float const along = vec3a::dot(d, mean);
+    if (along <= 0.0f)
+      return 0;
+    float const su = vec3a::dot(d, u) / along;
+    float const sw = vec3a::dot(d, w) / along;
+    lo_u           = std::min(lo_u, su);
+    hi_u           = std::max(hi_u, su);
+    lo_w           = std::min(lo_w, sw);
+    hi_w           = std::max(hi_w, sw);
+  }
+
+  // Every ray moves towards the inside of each normal, the plane goes through the lowest origin
+  vec3a_t const normals[5] = {vec3a::sub(vec3a::mul(mean, hi_u), u), vec3a::sub(u, vec3a::mul(mean, lo_u)),
+                              vec3a::sub(vec3a::mul(mean, hi_w), w), vec3a::sub(w, vec3a::mul(mean, lo_w)), mean};
+  for (std::uint32_t n = 0; n < 5; ++n)
+  {
+    float offset = std::numeric_limits<float>::max();
+    for (vec3a_t const& o : origins)
+      offset = std::min(offset, vec3a::dot(normals[n], o));
+    o_planes[n] = plane::set(normals[n], -offset);
+  }
+
+  float far = std::numeric_limits<float>::lowest();
+  for (std::uint32_t k = 0; k < element_count; ++k)
+  {
+    if (!std::isfinite(t_max[k]))
+      return 5;
+    far = std::max(far, vec3a::dot(mean, vec3a::madd(directions[k], vec3a::set(t_max[k]), origins[k])));
+  }
+  o_planes[5] = plane::set(vec3a::negate(mean), far);
+  return 6;
+}
+
+template <typename lane>
+inline bool ray_packetn<lane>::outside(plane_t const* planes, std::uint32_t count, aabb_t const& box)
+{
+  vec3a_t const c = aabb::center(box);
+  vec3a_t const e = aabb::half_size(box);
+  for (std::uint32_t i = 0; i < count; ++i)
+  {
+    if (plane::dot(planes[i], c) + vec3a::dot(plane::abs_normal(planes[i]), e) < 0.0f)
+      return true;
+  }
+  return false;
+}
+
+} // namespace vml
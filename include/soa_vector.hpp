@@ -0,0 +1,368 @@
+#pragma once
+
+#include "aabb.hpp"
+#include "bounding_volume.hpp"
+#include "transform.hpp"
+#include "vec3xn.hpp"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace vml
+{
+//! Describes how soa_vector splits a value into float components. source[c] is the index of
+//! component c when the value is viewed as an array of floats; floats not listed (padding w
+//! lanes) are not stored and read back as 0.
+template <typename value_t>
+struct soa_traits;
+
+//! vec3a_t, vec4_t, quat_t, sphere_t and plane_t are all quad_t, so w is kept for every one of them
+template <>
+struct soa_traits<quad_t>
+{
+  static constexpr std::uint32_t                component_count = 4;
+  static constexpr std::array<std::uint8_t, 4> source          = {0, 1, 2, 3};
+};
+
+//! min x, y, z then max x, y, z
+template <>
+struct soa_traits<aabb_t>
+{
+  static constexpr std::uint32_t                component_count = 6;
+  static constexpr std::array<std::uint8_t, 6> source          = {0, 1, 2, 4, 5, 6};
+};
+
+//! rotation x, y, z, w then translation x, y, z and scale
+template <>
+struct soa_traits<transform_t>
+{
+  static constexpr std::uint32_t                component_count = 8;
+  static constexpr std::array<std::uint8_t, 8> source          = {0, 1, 2, 3, 4, 5, 6, 7};
+};
+
+//! center x, y, z, radius, half extends x, y, z, then the same for the original volume
+template <>
+struct soa_traits<bounding_volume_t>
+{
+  static constexpr std::uint32_t                 component_count = 14;
+  static constexpr std::array<std::uint8_t, 14> source = {0, 1, 2, 3, 4, 5, 6, 8, 9, 10, 11, 12, 13, 14};
+};
+
+/**
+ * @remarks Chunked structure of arrays (AoSoA) container. Values are split into components as
+ * described by soa_traits and stored in blocks of lane::element_count (4 for quad, 8 for quad8):
+ * a block holds every component of element_count values, each component as one aligned lane.
+ * Values are addressed by stable indices returned from insert, which survive erasing other
+ * values. Storage stays dense: erase moves the last value into the hole, so blocks can be handed
+ * to batch kernels directly; every block is full except the last one, whose unused lanes are
+ * kept at 0 and reported through count/mask.
+ */
+template <typename value_t, typename lane = quad>
+class soa_vector
+{
+public:
+  using value_type = value_t;
+  using traits     = soa_traits<value_t>;
+  using lane_type  = typename lane::type;
+  using index_type = std::uint32_t;
+
+  enum : unsigned int
+  {
+    block_size      = lane::element_count,
+    component_count = traits::component_count,
+    block_floats    = component_count * block_size
+  };
+
+  static constexpr index_type k_null = 0xffffffff;
+
+  //! View over one block, component c of lane i is data[c * block_size + i]
+  template <typename float_t>
+  struct basic_block
+  {
+    float_t*      data;
+    //! Number of valid lanes, block_size for all blocks but the tail
+    std::uint32_t count;
+
+    inline lane_type load(std::uint32_t c) const
+    {
+      return lane::set(data + c * block_size);
+    }
+
+    inline void store(std::uint32_t c, typename lane::pref v) const
+      requires(!std::is_const_v<float_t>)
+    {
+      lane::store(data + c * block_size, v);
+    }
+
+    //! Bit i set for each valid lane i, same layout as quad8::mask
+    inline std::uint32_t mask() const
+    {
+      return (1u << count) - 1;
+    }
+
+    //! Lane mask with all bits set in valid lanes, usable with lane::select
+    inline lane_type lane_mask() const
+    {
+      alignas(32) static constexpr std::uint32_t k_tail[16] = {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff,
+                                                               0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff};
+      return lane::set_unaligned(reinterpret_cast<float const*>(k_tail + 8 - count));
+    }
+  };
+
+  using block       = basic_block<float>;
+  using const_block = basic_block<float const>;
+
+  soa_vector() = default;
+  soa_vector(soa_vector const& i_other)
+      : index_to_dense(i_other.index_to_dense), dense_to_index(i_other.dense_to_index),
+        free_indices(i_other.free_indices), count(i_other.count)
+  {
+    reserve(i_other.count);
+    if (count)
+      std::memcpy(blocks, i_other.blocks, sizeof(float) * block_floats * block_count());
+  }
+  soa_vector(soa_vector&& i_other) noexcept
+      : index_to_dense(std::move(i_other.index_to_dense)), dense_to_index(std::move(i_other.dense_to_index)),
+        free_indices(std::move(i_other.free_indices)), blocks(i_other.blocks), count(i_other.count),
+        capacity(i_other.capacity)
+  {
+    i_other.blocks   = nullptr;
+    i_other.count    = 0;
+    i_other.capacity = 0;
+  }
+  ~soa_vector()
+  {
+    release();
+  }
+
+  inline soa_vector& operator=(soa_vector const& i_other)
+  {
+    if (this != &i_other)
+    {
+      clear();
+      reserve(i_other.count);
+      index_to_dense = i_other.index_to_dense;
+      dense_to_index = i_other.dense_to_index;
+      free_indices   = i_other.free_indices;
+      count          = i_other.count;
+      if (count)
+        std::memcpy(blocks, i_other.blocks, sizeof(float) * block_floats * block_count());
+    }
+    return *this;
+  }
+
+  inline soa_vector& operator=(soa_vector&& i_other) noexcept
+  {
+    if (this != &i_other)
+    {
+      release();
+      index_to_dense   = std::move(i_other.index_to_dense);
+      dense_to_index   = std::move(i_other.dense_to_index);
+      free_indices     = std::move(i_other.free_indices);
+      blocks           = i_other.blocks;
+      count            = i_other.count;
+      capacity         = i_other.capacity;
+      i_other.blocks   = nullptr;
+      i_other.count    = 0;
+      i_other.capacity = 0;
+    }
+    return *this;
+  }
+
+  //! Add a value, returns its stable index
+  inline index_type insert(value_t const& v)
+  {
+    if (count == capacity)
+      reserve(capacity ? capacity * 2 : block_size);
+
+    index_type index;
+    if (!free_indices.empty())
+    {
+      index = free_indices.back();
+      free_indices.pop_back();
+    }
+    else
+    {
+      index = static_cast<index_type>(index_to_dense.size());
+      index_to_dense.push_back(k_null);
+    }
+    index_to_dense[index] = count;
+    dense_to_index.push_back(index);
+    write(count++, v);
+    return index;
+  }
+
+  //! Remove the value at index, the last value moves into its place
+  inline void erase(index_type index)
+  {
+    assert(contains(index));
+    std::uint32_t const hole = index_to_dense[index];
+    std::uint32_t const last = --count;
+    if (hole != last)
+    {
+      for (std::uint32_t c = 0; c < component_count; ++c)
+        component(hole, c) = component(last, c);
+      index_type const moved = dense_to_index[last];
+      dense_to_index[hole]   = moved;
+      index_to_dense[moved]  = hole;
+    }
+    for (std::uint32_t c = 0; c < component_count; ++c)
+      component(last, c) = 0.0f;
+    dense_to_index.pop_back();
+    index_to_dense[index] = k_null;
+    free_indices.push_back(index);
+  }
+
+  inline bool contains(index_type index) const noexcept
+  {
+    return index < index_to_dense.size() && index_to_dense[index] != k_null;
+  }
+
+  inline value_t get(index_type index) const
+  {
+    assert(contains(index));
+    return read(index_to_dense[index]);
+  }
+
+  inline void set(index_type index, value_t const& v)
+  {
+    assert(contains(index));
+    write(index_to_dense[index], v);
+  }
+
+  //! Dense position of index, values are stored in position order
+  inline std::uint32_t position(index_type index) const
+  {
+    assert(contains(index));
+    return index_to_dense[index];
+  }
+
+  //! Stable index of the value at dense position p
+  inline index_type index_at(std::uint32_t p) const
+  {
+    assert(p < count);
+    return dense_to_index[p];
+  }
+
+  inline value_t at_position(std::uint32_t p) const
+  {
+    assert(p < count);
+    return read(p);
+  }
+
+  inline std::uint32_t size() const noexcept
+  {
+    return count;
+  }
+
+  inline bool empty() const noexcept
+  {
+    return count == 0;
+  }
+
+  inline std::uint32_t block_count() const noexcept
+  {
+    return (count + block_size - 1) / block_size;
+  }
+
+  //! Number of blocks with all lanes valid
+  inline std::uint32_t full_block_count() const noexcept
+  {
+    return count / block_size;
+  }
+
+  inline block block_at(std::uint32_t b) noexcept
+  {
+    assert(b < block_count());
+    return {blocks + b * block_floats, std::min<std::uint32_t>(count - b * block_size, block_size)};
+  }
+
+  inline const_block block_at(std::uint32_t b) const noexcept
+  {
+    assert(b < block_count());
+    return {blocks + b * block_floats, std::min<std::uint32_t>(count - b * block_size, block_size)};
+  }
+
+  //! Call fn with every full block, then with the partially filled tail block if there is one
+  template <typename block_fn>
+  inline void for_each_block(block_fn&& fn)
+  {
+    for (std::uint32_t b = 0, end = block_count(); b < end; ++b)
+      fn(block_at(b));
+  }
+
+  template <typename block_fn>
+  inline void for_each_block(block_fn&& fn) const
+  {
+    for (std::uint32_t b = 0, end = block_count(); b < end; ++b)
+      fn(block_at(b));
+  }
+
+  inline void reserve(std::uint32_t n)
+  {
+    std::uint32_t const needed = ((n + block_size - 1) / block_size) * block_size;
+    if (needed <= capacity)
+      return;
+    std::size_t const bytes = sizeof(float) * component_count * needed;
+    float*            mem   = vml::allocate<float>(bytes, alignof(lane_type));
+    std::memset(mem, 0, bytes);
+    if (blocks)
+    {
+      std::memcpy(mem, blocks, sizeof(float) * component_count * capacity);
+      vml::deallocate(blocks, sizeof(float) * component_count * capacity);
+    }
+    blocks   = mem;
+    capacity = needed;
+  }
+
+  inline void clear()
+  {
+    if (blocks)
+      std::memset(blocks, 0, sizeof(float) * component_count * capacity);
+    index_to_dense.clear();
+    dense_to_index.clear();
+    free_indices.clear();
+    count = 0;
+  }
+
+private:
+  inline float& component(std::uint32_t p, std::uint32_t c) const
+  {
+    return blocks[(p / block_size) * block_floats + c * block_size + (p % block_size)];
+  }
+
+  inline value_t read(std::uint32_t p) const
+  {
+    float f[sizeof(value_t) / sizeof(float)] = {};
+    for (std::uint32_t c = 0; c < component_count; ++c)
+      f[traits::source[c]] = component(p, c);
+    value_t v;
+    std::memcpy(&v, f, sizeof(value_t));
+    return v;
+  }
+
+  inline void write(std::uint32_t p, value_t const& v)
+  {
+    float f[sizeof(value_t) / sizeof(float)];
+    std::memcpy(f, &v, sizeof(value_t));
+    for (std::uint32_t c = 0; c < component_count; ++c)
+      component(p, c) = f[traits::source[c]];
+  }
+
+  inline void release()
+  {
+    if (blocks)
+      vml::deallocate(blocks, sizeof(float) * component_count * capacity);
+    blocks   = nullptr;
+    capacity = 0;
+  }
+
+  std::vector<std::uint32_t> index_to_dense;
+  std::vector<index_type>    dense_to_index;
+  std::vector<index_type>    free_indices;
+  float*                     blocks   = nullptr;
+  std::uint32_t              count    = 0;
+  std::uint32_t              capacity = 0;
+};
+
+} // namespace vml
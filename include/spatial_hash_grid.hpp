@@ -0,0 +1,349 @@
+#pragma once
+
+#include "ivec3.hpp"
+#include "mat4.hpp"
+#include "sphere.hpp"
+#include "vec3xn.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace vml
+{
+namespace detail
+{
+//! Floor of lane values within +-2^22: adding 1.5 * 2^23 rounds to an integer in the mantissa,
+//! results above the input are then lowered by one
+template <typename lane>
+inline typename lane::type floor_lanes(typename lane::type v)
+{
+  typename lane::type const magic   = lane::set(12582912.0f);
+  typename lane::type const rounded = lane::sub(lane::add(v, magic), magic);
+  return lane::sub(rounded, lane::bit_and(lane::greaterv(rounded, v), lane::set(1.0f)));
+}
+} // namespace detail
+
+/**
+ * @remarks Uniform grid over spheres or points, hashed so only occupied cells cost memory. Each
+ * item goes to the ivec3_t cell of its center, and items are stored sorted by cell hash in one
+ * array with an offset table per hash bucket (CSR), rebuilt with a counting sort in O(n). Items
+ * keep their cell, so buckets shared by colliding cells are filtered exactly. Queries visit the
+ * cells within reach of the query plus the largest item radius. Cell coordinates must stay within
+ * +-2^22.
+ */
+class spatial_hash_grid
+{
+public:
+  using index_type = std::uint32_t;
+
+  //! nearest keeps up to this many candidates without allocating
+  static constexpr std::uint32_t k_nearest_local_size = 64;
+
+  spatial_hash_grid(float i_cell_size = 1.0f) : cell_size(i_cell_size), inv_cell_size(1.0f / i_cell_size) {}
+
+  //! Build over spheres, w is the radius, any previous content is dropped
+  inline void build(std::span<sphere_t const> i_spheres)
+  {
+    std::uint32_t const count = static_cast<std::uint32_t>(i_spheres.size());
+    table_mask                = std::bit_ceil(std::max(count, 1u)) - 1;
+    hash_cells(i_spheres);
+
+    // Counting sort by bucket, starts[h] ends up as the first item of bucket h
+    starts.assign(table_mask + 2, 0);
+    for (std::uint32_t i = 0; i < count; ++i)
+      starts[hashes[i] + 1]++;
+    for (std::uint32_t h = 1; h < starts.size(); ++h)
+      starts[h] += starts[h - 1];
+    cursor.assign(starts.begin(), starts.end() - 1);
+    items.resize(count);
+    cells.resize(count);
+    order.resize(count);
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+      std::uint32_t const pos = cursor[hashes[i]]++;
+      items[pos]              = i_spheres[i];
+      cells[pos]              = item_cells[i];
+      order[pos]              = i;
+    }
+  }
+
+  //! Build over points, the w component is ignored
+  inline void build_points(std::span<vec3a_t const> i_points)
+  {
+    points.resize(i_points.size());
+    for (std::size_t i = 0; i < i_points.size(); ++i)
+      points[i] = sphere::set(i_points[i], 0.0f);
+    build(points);
+  }
+
+  //! Cell containing point
+  inline ivec3_t cell(vec3a::pref point) const
+  {
+    return {static_cast<int>(std::floor(vec3a::x(point) * inv_cell_size)),
+            static_cast<int>(std::floor(vec3a::y(point) * inv_cell_size)),
+            static_cast<int>(std::floor(vec3a::z(point) * inv_cell_size))};
+  }
+
+  //! Call visit(index) for every item overlapping sphere, points are reported within its radius
+  template <typename visit_fn>
+  inline void query(sphere_t const& i_sphere, visit_fn&& visit) const
+  {
+    vec3a_t const center = sphere::center(i_sphere);
+    float const   radius = sphere::radius(i_sphere);
+    for_each_in(center, radius + max_radius,
+                [&](std::uint32_t pos)
+                {
+                  float const reach = radius + sphere::radius(items[pos]);
+                  if (vec3a::sqdistance(center, sphere::center(items[pos])) <= reach * reach)
+                    visit(order[pos]);
+                });
+  }
+
+  /**
+   * @remarks Fill o_indices with the items whose centers are closest to point, nearest first,
+   * returns how many were found. Cells are visited in rings of growing distance around the cell of
+   * point until no unvisited cell can be closer than the farthest item kept.
+   */
+  inline std::uint32_t nearest(vec3a::pref point, std::span<index_type> o_indices) const
+  {
+    std::uint32_t const k = static_cast<std::uint32_t>(std::min(o_indices.size(), items.size()));
+    if (!k)
+      return 0;
+    // Max heap on distance of the k best so far, in fixed storage up to k_nearest_local_size
+    using candidate = std::pair<float, std::uint32_t>;
+    candidate              local[k_nearest_local_size];
+    std::vector<candidate> overflow;
+    if (k > k_nearest_local_size)
+      overflow.resize(k);
+    candidate* const best = k > k_nearest_local_size ? overflow.data() : local;
+    std::uint32_t    size = 0;
+
+    auto const consider = [&](std::uint32_t pos)
+    {
+      float const d2 = vec3a::sqdistance(point, sphere::center(items[pos]));
+      if (size < k)
+      {
+        best[size++] = {d2, pos};
+        std::push_heap(best, best + size);
+      }
+      else if (d2 < best[0].first)
+      {
+        std::pop_heap(best, best + size);
+        best[size - 1] = {d2, pos};
+        std::push_heap(best, best + size);
+      }
+    };
+
+    ivec3_t const c       = cell(point);
+    int           rings   = 0;
+    std::size_t   visited = 0;
+    for (std::uint32_t a = 0; a < 3; ++a)
+      rings = std::max({rings, c[a] - cell_lo[a], cell_hi[a] - c[a]});
+    for (int r = 0; r <= rings; ++r)
+    {
+      // Items in ring r are at least (r - 1) cells away from point
+      float const gap = static_cast<float>(r - 1) * cell_size;
+      if (size == k && r > 0 && best[0].first <= gap * gap)
+        break;
+      // Sparse grids would visit mostly empty rings, test every item instead
+      if (visited > items.size())
+      {
+        size = 0;
+        for (std::uint32_t pos = 0, end = static_cast<std::uint32_t>(items.size()); pos < end; ++pos)
+          consider(pos);
+        break;
+      }
+      visited += r == 0 ? 1 : 24 * r * r + 2;
+      for (int z = c[2] - r; z <= c[2] + r; ++z)
+      {
+        for (int y = c[1] - r; y <= c[1] + r; ++y)
+        {
+          bool const face = std::abs(z - c[2]) == r || std::abs(y - c[1]) == r;
+          for (int x = c[0] - r; x <= c[0] + r; x += face || r == 0 ? 1 : 2 * r)
+            for_each_in_cell({x, y, z}, consider);
+        }
+      }
+    }
+
+    std::sort_heap(best, best + size);
+    for (std::uint32_t i = 0; i < size; ++i)
+      o_indices[i] = order[best[i].second];
+    return size;
+  }
+
+  /**
+   * @remarks Call visit(a, b), a < b, once for every pair of items whose centers are within
+   * distance plus both radii, distance 0 reports overlapping spheres.
+   */
+  template <typename visit_fn>
+  inline void query_pairs(float distance, visit_fn&& visit) const
+  {
+    for (std::uint32_t i = 0, count = static_cast<std::uint32_t>(items.size()); i < count; ++i)
+    {
+      vec3a_t const center = sphere::center(items[i]);
+      float const   radius = distance + sphere::radius(items[i]);
+      for_each_in(center, radius + max_radius,
+                  [&](std::uint32_t j)
+                  {
+                    if (j <= i)
+                      return;
+                    float const reach = radius + sphere::radius(items[j]);
+                    if (vec3a::sqdistance(center, sphere::center(items[j])) <= reach * reach)
+                      visit(std::min(order[i], order[j]), std::max(order[i], order[j]));
+                  });
+    }
+  }
+
+  //! Number of items
+  inline std::uint32_t size() const noexcept
+  {
+    return static_cast<std::uint32_t>(items.size());
+  }
+
+  inline void clear()
+  {
+    starts.clear();
+    items.clear();
+    cells.clear();
+    order.clear();
+    max_radius = 0.0f;
+  }
+
+private:
+  static inline std::uint32_t hash(ivec3_t const& c)
+  {
+    return (static_cast<std::uint32_t>(c[0]) * 73856093u) ^ (static_cast<std::uint32_t>(c[1]) * 19349663u) ^
+           (static_cast<std::uint32_t>(c[2]) * 83492791u);
+  }
+
+  //! Cells and buckets of the sphere centers, width centers at a time in SoA, and the grid extent
+  inline void hash_cells(std::span<sphere_t const> i_spheres)
+  {
+    using lane      = detail::stream_lane;
+    using lane_type = typename lane::type;
+    constexpr std::uint32_t width = lane::element_count;
+
+    std::uint32_t const count = static_cast<std::uint32_t>(i_spheres.size());
+    item_cells.resize(count);
+    hashes.resize(count);
+    cell_lo = {0, 0, 0};
+    cell_hi = {-1, -1, -1};
+    if (count)
+    {
+      cell_lo = cell(sphere::center(i_spheres[0]));
+      cell_hi = cell_lo;
+    }
+
+    auto const add = [this](std::uint32_t i, ivec3_t const& c)
+    {
+      item_cells[i] = c;
+      hashes[i]     = hash(c) & table_mask;
+      for (std::uint32_t a = 0; a < 3; ++a)
+      {
+        cell_lo[a] = std::min(cell_lo[a], c[a]);
+        cell_hi[a] = std::max(cell_hi[a], c[a]);
+      }
+    };
+
+    lane_type const scale = lane::set(inv_cell_size);
+    lane_type       radii = lane::zero();
+    std::uint32_t   i     = 0;
+    for (; i + width <= count; i += width)
+    {
+      lane_type v[4];
+      detail::lanes_from_quads<lane>(&i_spheres[i], v);
+      alignas(32) float c[3][width];
+      for (std::uint32_t a = 0; a < 3; ++a)
+        lane::store(c[a], detail::floor_lanes<lane>(lane::mul(v[a], scale)));
+      radii = lane::max(radii, v[3]);
+      for (std::uint32_t k = 0; k < width; ++k)
+        add(i + k, {static_cast<int>(c[0][k]), static_cast<int>(c[1][k]), static_cast<int>(c[2][k])});
+    }
+    max_radius = 0.0f;
+    for (std::uint32_t k = 0; k < width; ++k)
+      max_radius = std::max(max_radius, lane::get(radii, k));
+    for (; i < count; ++i)
+    {
+      add(i, cell(sphere::center(i_spheres[i])));
+      max_radius = std::max(max_radius, sphere::radius(i_spheres[i]));
+    }
+  }
+
+  template <typename fn_t>
+  inline void for_each_in_cell(ivec3_t const& c, fn_t&& fn) const
+  {
+    std::uint32_t const h = hash(c) & table_mask;
+    for (std::uint32_t pos = starts[h], end = starts[h + 1]; pos < end; ++pos)
+    {
+      if (cells[pos] == c)
+        fn(pos);
+    }
+  }
+
+  //! Call fn(pos) for the items in cells within reach of center, ranges covering more cells than
+  //! there are items scan the items instead
+  template <typename fn_t>
+  inline void for_each_in(vec3a::pref center, float reach, fn_t&& fn) const
+  {
+    if (items.empty())
+      return;
+    // Clamped to the occupied cells while still in float, far reaches would overflow int
+    ivec3_t     lo;
+    ivec3_t     hi;
+    float const r = reach * inv_cell_size;
+    double      n = 1.0;
+    for (std::uint32_t a = 0; a < 3; ++a)
+    {
+      float const c = vec3a::get(center, a) * inv_cell_size;
+      lo[a]         = static_cast<int>(std::max(std::floor(c - r), static_cast<float>(cell_lo[a])));
+      hi[a]         = static_cast<int>(std::min(std::floor(c + r), static_cast<float>(cell_hi[a])));
+      if (lo[a] > hi[a])
+        return;
+      n *= hi[a] - lo[a] + 1;
+    }
+
+    if (n > static_cast<double>(items.size()))
+    {
+      for (std::uint32_t pos = 0, end = static_cast<std::uint32_t>(items.size()); pos < end; ++pos)
+      {
+        ivec3_t const& c = cells[pos];
+        if (c[0] >= lo[0] && c[0] <= hi[0] && c[1] >= lo[1] && c[1] <= hi[1] && c[2] >= lo[2] && c[2] <= hi[2])
+          fn(pos);
+      }
+      return;
+    }
+    for (int z = lo[2]; z <= hi[2]; ++z)
+    {
+      for (int y = lo[1]; y <= hi[1]; ++y)
+      {
+        for (int x = lo[0]; x <= hi[0]; ++x)
+          for_each_in_cell({x, y, z}, fn);
+      }
+    }
+  }
+
+  float cell_size;
+  float inv_cell_size;
+  float max_radius = 0.0f;
+  //! Bucket count - 1, a power of two at least the item count
+  std::uint32_t table_mask = 0;
+  //! Items of bucket h are [starts[h], starts[h + 1])
+  std::vector<std::uint32_t> starts;
+  // By bucket order
+  std::vector<sphere_t>   items;
+  std::vector<ivec3_t>    cells;
+  std::vector<index_type> order;
+  //! Smallest and largest occupied cell coordinates
+  ivec3_t cell_lo = {0, 0, 0};
+  ivec3_t cell_hi = {-1, -1, -1};
+  // Build scratch, by input order
+  std::vector<ivec3_t>       item_cells;
+  std::vector<std::uint32_t> hashes;
+  std::vector<std::uint32_t> cursor;
+  std::vector<sphere_t>      points;
+};
+
+} // namespace vml
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "bvh.hpp"
+
+namespace vml
+{
+/**
+ * @remarks Sweep and prune broadphase over a span of boxes, best for many similarly sized movers.
+ * Boxes are sorted by their min on the axis where box centers vary most, then each box is tested
+ * against the run of following boxes that start before it ends on that axis. The run is tested on
+ * the aabb_t rows as they are, two boxes per lane compare. The sort order is kept between updates:
+ * when the axis and box count are unchanged an insertion sort fixes the small changes of a frame,
+ * and a radix sort on the float bits of the mins is used otherwise or when the insertion sort
+ * moves too many boxes. Pairs are reported by index in the span given to update.
+ */
+class sweep_and_prune
+{
+public:
+  using index_type = std::uint32_t;
+
+  struct pair
+  {
+    //! a < b
+    index_type a;
+    index_type b;
+  };
+
+  //! Insertion sort gives up in favour of a radix sort past this many moves per box
+  static constexpr std::uint32_t k_max_moves_per_box = 8;
+
+  //! Sort boxes and find the overlapping pairs, the previous pairs are dropped
+  inline void update(std::span<aabb_t const> i_boxes)
+  {
+    std::uint32_t const count = static_cast<std::uint32_t>(i_boxes.size());
+    std::uint32_t const axis  = dominant_axis(i_boxes);
+    if (count != order.size() || axis != sort_axis || !insertion_sort(i_boxes))
+      radix_sort(i_boxes, axis);
+
+    hi.resize(count);
+    sorted.resize(count);
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+      sorted[i] = i_boxes[order[i]];
+      hi[i]     = quad::get(sorted[i].r[1], sort_axis);
+    }
+    sweep();
+  }
+
+  //! Overlapping pairs found by the last update
+  inline std::span<pair const> pairs() const noexcept
+  {
+    return found;
+  }
+
+  //! Axis the boxes were sorted on by the last update, 3 before the first
+  inline std::uint32_t axis() const noexcept
+  {
+    return sort_axis;
+  }
+
+  inline void clear()
+  {
+    order.clear();
+    lo.clear();
+    hi.clear();
+    sorted.clear();
+    keys.clear();
+    found.clear();
+    sort_axis = 3;
+  }
+
+private:
+  //! Axis with the largest variance of box centers
+  static inline std::uint32_t dominant_axis(std::span<aabb_t const> i_boxes)
+  {
+    if (i_boxes.empty())
+      return 0;
+    // Two passes, sum2 / n - mean^2 cancels when the centers are far from the origin
+    vec3a_t sum = vec3a::zero();
+    for (aabb_t const& b : i_boxes)
+      sum = vec3a::add(sum, aabb::center(b));
+    vec3a_t const mean     = vec3a::mul(sum, 1.0f / static_cast<float>(i_boxes.size()));
+    vec3a_t       variance = vec3a::zero();
+    for (aabb_t const& b : i_boxes)
+    {
+      vec3a_t const d = vec3a::sub(aabb::center(b), mean);
+      variance        = vec3a::add(variance, vec3a::mul(d, d));
+    }
+    float const x = vec3a::x(variance);
+    float const y = vec3a::y(variance);
+    float const z = vec3a::z(variance);
+    return x >= y && x >= z ? 0 : (y >= z ? 1 : 2);
+  }
+
+  //! Floats mapped to integers with the same order
+  static inline std::uint32_t sort_key(float f)
+  {
+    std::uint32_t const bits = std::bit_cast<std::uint32_t>(f);
+    return bits & 0x80000000 ? ~bits : bits | 0x80000000;
+  }
+
+  inline void radix_sort(std::span<aabb_t const> i_boxes, std::uint32_t axis)
+  {
+    std::uint32_t const count = static_cast<std::uint32_t>(i_boxes.size());
+    sort_axis                 = axis;
+    keys.resize(count);
+    order.resize(count);
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+      keys[i]  = sort_key(quad::get(i_boxes[i].r[0], axis));
+      order[i] = i;
+    }
+    detail::radix_sort(keys, order, 32, std::max(count, 1u), detail::serial_executor{});
+    lo.resize(count);
+    for (std::uint32_t i = 0; i < count; ++i)
+      lo[i] = quad::get(i_boxes[order[i]].r[0], axis);
+  }
+
+  //! Re-sort the previous order with the new mins, false if it needed too many moves
+  inline bool insertion_sort(std::span<aabb_t const> i_boxes)
+  {
+    std::uint32_t const count = static_cast<std::uint32_t>(i_boxes.size());
+    for (std::uint32_t i = 0; i < count; ++i)
+      lo[i] = quad::get(i_boxes[order[i]].r[0], sort_axis);
+
+    std::uint32_t       moves  = 0;
+    std::uint32_t const budget = count * k_max_moves_per_box;
+    for (std::uint32_t i = 1; i < count; ++i)
+    {
+      float const      key   = lo[i];
+      index_type const index = order[i];
+      std::uint32_t    j     = i;
+      for (; j > 0 && lo[j - 1] > key; --j)
+      {
+        lo[j]    = lo[j - 1];
+        order[j] = order[j - 1];
+      }
+      lo[j]    = key;
+      order[j] = index;
+      moves += i - j;
+      if (moves > budget)
+        return false;
+    }
+    return true;
+  }
+
+  //! Test each box against the following boxes starting before it ends, two per compare
+  inline void sweep()
+  {
+    found.clear();
+    std::uint32_t const count = static_cast<std::uint32_t>(order.size());
+    auto const          add   = [this](std::uint32_t i, std::uint32_t j)
+    {
+      found.push_back({std::min(order[i], order[j]), std::max(order[i], order[j])});
+    };
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+      float const   end = hi[i];
+      aabb_t const& box = sorted[i];
+      std::uint32_t j   = i + 1;
+      for (; j + 1 < count && lo[j + 1] <= end; j += 2)
+      {
+        std::uint32_t const hits = detail::aabb_overlap2(box, sorted[j], sorted[j + 1]);
+        if (hits & 1)
+          add(i, j);
+        if (hits & 2)
+          add(i, j + 1);
+      }
+      if (j < count && lo[j] <= end && detail::aabb_overlap(box, sorted[j]))
+        add(i, j);
+    }
+  }
+
+  // By sorted position
+  std::vector<index_type> order;
+  std::vector<float>      lo;
+  std::vector<float>      hi;
+  std::vector<aabb_t>     sorted;
+  //! Radix sort keys
+  std::vector<std::uint32_t> keys;
+  std::vector<pair>          found;
+  std::uint32_t              sort_axis = 3;
+};
+
+} // namespace vml
@@ -3,7 +3,9 @@
 #include "mat4.hpp"
 #include "quad.hpp"
 #include "quat.hpp"
+#include "quatxn.hpp"
 #include "vec4.hpp"
+#include <span>
 
 namespace vml
 {
@@ -27,7 +29,10 @@ struct transform
   static inline void        set_rotation(transform_t& _, quat_t const&);
   static inline void        set_scale(transform_t& _, float);
   static inline transform_t combine(transform_t const& parent_combined, transform_t const& local);
-  static inline vec3a_t     mul(vec3a::pref p, transform_t const& _);
+  //! @brief Batched combine, o_result[i] = combine(parent_combined[i], local[i]), o_result may alias either input
+  static inline void    combine(std::span<transform_t const> parent_combined, std::span<transform_t const> local,
+                                std::span<transform_t> o_result);
+  static inline vec3a_t mul(vec3a::pref p, transform_t const& _);
 };
 
 static_assert(sizeof(transform_t) == sizeof(vec4_t) * 2, "Fix size");
@@ -87,6 +92,48 @@ inline transform_t transform::combine(transform_t const& parent_combined, transf
                                       quad::set_111w(local.translation_and_scale, 3));
   return _;
 }
+inline void transform::combine(std::span<transform_t const> parent_combined, std::span<transform_t const> local,
+                               std::span<transform_t> o_result)
+{
+  // element_count transforms at a time in SoA, same math as the single combine
+  using lane      = detail::stream_lane;
+  using lane_type = typename lane::type;
+  using quatxn    = vml::quatxn<lane>;
+  using vec3xn    = vml::vec3xn<lane>;
+  assert(local.size() == parent_combined.size() && o_result.size() >= local.size());
+
+  std::size_t i = 0;
+  for (std::size_t end = local.size(); i + lane::element_count <= end; i += lane::element_count)
+  {
+    quat_t parent_rot[lane::element_count];
+    quat_t local_rot[lane::element_count];
+    quad_t parent_ts[lane::element_count];
+    quad_t local_ts[lane::element_count];
+    for (std::uint32_t k = 0; k < lane::element_count; ++k)
+    {
+      parent_rot[k] = parent_combined[i + k].rotation;
+      local_rot[k]  = local[i + k].rotation;
+      parent_ts[k]  = parent_combined[i + k].translation_and_scale;
+      local_ts[k]   = local[i + k].translation_and_scale;
+    }
+    lane_type pts[4];
+    lane_type lts[4];
+    detail::lanes_from_quads<lane>(parent_ts, pts);
+    detail::lanes_from_quads<lane>(local_ts, lts);
+
+    typename quatxn::type prot    = quatxn::load(parent_rot);
+    typename vec3xn::type rotated = quatxn::transform(prot, vec3xn::mul(vec3xn::set(lts[0], lts[1], lts[2]), pts[3]));
+    quatxn::store(parent_rot, quatxn::mul(prot, quatxn::load(local_rot)));
+    lane_type const ts[4] = {lane::add(pts[0], rotated.x), lane::add(pts[1], rotated.y), lane::add(pts[2], rotated.z),
+                             lane::mul(pts[3], lts[3])};
+    detail::lanes_to_quads<lane>(ts, parent_ts);
+    for (std::uint32_t k = 0; k < lane::element_count; ++k)
+      o_result[i + k] = {parent_rot[k], parent_ts[k]};
+  }
+  for (std::size_t end = local.size(); i < end; ++i)
+    o_result[i] = combine(parent_combined[i], local[i]);
+}
+
 inline vec3a_t transform::mul(vec3a::pref v, transform_t const& _)
 {
   vec3a_t rotated_trans = quat::transform(_.rotation, quad::mul(v, quad::splat_w(_.translation_and_scale)));
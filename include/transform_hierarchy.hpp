@@ -0,0 +1,291 @@
+#pragma once
+
+#include "transform.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace vml
+{
+/**
+ * @remarks Transform hierarchy kept in flat arrays instead of a pointer based scene graph. Nodes
+ * are addressed by stable indices returned from insert. Internally locals and world transforms are
+ * stored sorted by depth, so update walks the hierarchy level by level: every parent is final
+ * before its children are visited, and the dirty nodes of a level are combined with their parents
+ * through the batched transform::combine. Only nodes whose local changed, and their descendants,
+ * are recomputed. Structural changes (insert, erase, set_parent) re-sort the arrays on the next
+ * update.
+ */
+class transform_hierarchy
+{
+public:
+  using index_type = std::uint32_t;
+
+  static constexpr index_type k_null = 0xffffffff;
+  //! Levels with at least this many dirty nodes are split into tasks for the executor passed to
+  //! update, each task covering this many nodes
+  static constexpr std::uint32_t k_parallel_task_size = 4096;
+
+  //! Add a node with local transform, parent is k_null for a root
+  inline index_type insert(transform_t const& local, index_type parent = k_null)
+  {
+    assert(parent == k_null || contains(parent));
+    index_type node;
+    if (!free_nodes.empty())
+    {
+      node = free_nodes.back();
+      free_nodes.pop_back();
+    }
+    else
+    {
+      node = static_cast<index_type>(parents.size());
+      parents.push_back(k_null);
+      slots.push_back(k_null);
+      child_counts.push_back(0);
+    }
+    parents[node] = parent;
+    slots[node]   = static_cast<std::uint32_t>(nodes.size());
+    if (parent != k_null)
+      child_counts[parent]++;
+    nodes.push_back(node);
+    locals.push_back(local);
+    worlds.push_back(local);
+    dirty.push_back(1);
+    sorted = false;
+    return node;
+  }
+
+  //! Remove a node, it must not have children
+  inline void erase(index_type node)
+  {
+    assert(contains(node) && child_counts[node] == 0);
+    if (parents[node] != k_null)
+      child_counts[parents[node]]--;
+    nodes[slots[node]] = k_null;
+    slots[node]        = k_null;
+    parents[node]      = k_null;
+    free_nodes.push_back(node);
+    sorted = false;
+  }
+
+  //! Move node with its subtree under parent (k_null to make it a root), parent must not be in
+  //! the subtree of node
+  inline void set_parent(index_type node, index_type parent)
+  {
+    assert(contains(node) && (parent == k_null || contains(parent)));
+    if (parents[node] != k_null)
+      child_counts[parents[node]]--;
+    if (parent != k_null)
+      child_counts[parent]++;
+    parents[node]      = parent;
+    dirty[slots[node]] = 1;
+    sorted             = false;
+  }
+
+  inline void set_local(index_type node, transform_t const& local)
+  {
+    assert(contains(node));
+    locals[slots[node]] = local;
+    dirty[slots[node]]  = 1;
+  }
+
+  inline transform_t const& local(index_type node) const
+  {
+    assert(contains(node));
+    return locals[slots[node]];
+  }
+
+  //! World transform as of the last update
+  inline transform_t const& world(index_type node) const
+  {
+    assert(contains(node));
+    return worlds[slots[node]];
+  }
+
+  inline index_type parent(index_type node) const
+  {
+    assert(contains(node));
+    return parents[node];
+  }
+
+  inline bool contains(index_type node) const noexcept
+  {
+    return node < slots.size() && slots[node] != k_null;
+  }
+
+  inline std::uint32_t size() const noexcept
+  {
+    return static_cast<std::uint32_t>(parents.size() - free_nodes.size());
+  }
+
+  //! Number of levels, valid after update
+  inline std::uint32_t depth() const noexcept
+  {
+    return levels.empty() ? 0 : static_cast<std::uint32_t>(levels.size()) - 1;
+  }
+
+  inline void clear()
+  {
+    parents.clear();
+    slots.clear();
+    child_counts.clear();
+    free_nodes.clear();
+    nodes.clear();
+    parent_slots.clear();
+    locals.clear();
+    worlds.clear();
+    dirty.clear();
+    levels.clear();
+    sorted = false;
+  }
+
+  /**
+   * @remarks Recompute world transforms of dirty nodes and their descendants. Wide levels are split
+   * into tasks of exec covering k_parallel_task_size nodes, see detail::serial_executor. Tasks of a
+   * level write disjoint nodes.
+   */
+  template <typename executor = detail::serial_executor>
+  inline void update(executor&& exec = {})
+  {
+    if (!sorted)
+      sort();
+    if (levels.empty())
+      return;
+
+    for (std::uint32_t s = levels[0], end = levels[1]; s < end; ++s)
+    {
+      if (dirty[s])
+        worlds[s] = locals[s];
+    }
+
+    for (std::uint32_t l = 1, last = static_cast<std::uint32_t>(levels.size()) - 1; l < last; ++l)
+    {
+      // The parent level is final, so its dirty flags already include its own ancestors
+      dirty_slots.clear();
+      for (std::uint32_t s = levels[l], end = levels[l + 1]; s < end; ++s)
+      {
+        dirty[s] |= dirty[parent_slots[s]];
+        if (dirty[s])
+          dirty_slots.push_back(s);
+      }
+
+      auto const count = static_cast<std::uint32_t>(dirty_slots.size());
+      if (count < k_parallel_task_size)
+        combine(0, count);
+      else
+        exec((count + k_parallel_task_size - 1) / k_parallel_task_size,
+             [this, count](std::uint32_t t)
+             {
+               combine(t * k_parallel_task_size, std::min(count, (t + 1) * k_parallel_task_size));
+             });
+    }
+    std::fill(dirty.begin(), dirty.end(), std::uint8_t(0));
+  }
+
+private:
+  //! Combine dirty_slots[begin, end) with their parents, in chunks gathered for the batched combine
+  inline void combine(std::uint32_t begin, std::uint32_t end)
+  {
+    constexpr std::uint32_t k_chunk = 64;
+    transform_t             parent_world[k_chunk];
+    transform_t             local[k_chunk];
+    transform_t             world[k_chunk];
+    for (std::uint32_t i = begin; i < end; i += k_chunk)
+    {
+      std::uint32_t const n = std::min(k_chunk, end - i);
+      for (std::uint32_t k = 0; k < n; ++k)
+      {
+        std::uint32_t const s = dirty_slots[i + k];
+        parent_world[k]       = worlds[parent_slots[s]];
+        local[k]              = locals[s];
+      }
+      transform::combine(std::span<transform_t const>(parent_world, n), std::span<transform_t const>(local, n),
+                         std::span<transform_t>(world, n));
+      for (std::uint32_t k = 0; k < n; ++k)
+        worlds[dirty_slots[i + k]] = world[k];
+    }
+  }
+
+  //! Counting sort of the live nodes by depth, drops erased slots
+  inline void sort()
+  {
+    std::uint32_t const        node_count = static_cast<std::uint32_t>(parents.size());
+    std::vector<std::uint32_t> depths(node_count, k_null);
+    std::vector<std::uint32_t> chain;
+    for (index_type n = 0; n < node_count; ++n)
+    {
+      if (slots[n] == k_null || depths[n] != k_null)
+        continue;
+      // Walk up to the first node with known depth, then assign depths on the way back
+      index_type p = n;
+      while (p != k_null && depths[p] == k_null)
+      {
+        chain.push_back(p);
+        p = parents[p];
+      }
+      std::uint32_t d = p == k_null ? 0 : depths[p] + 1;
+      while (!chain.empty())
+      {
+        depths[chain.back()] = d++;
+        chain.pop_back();
+      }
+    }
+
+    levels.clear();
+    for (index_type n : nodes)
+    {
+      if (n == k_null)
+        continue;
+      if (depths[n] + 2 > levels.size())
+        levels.resize(depths[n] + 2, 0);
+      levels[depths[n] + 1]++;
+    }
+    for (std::uint32_t l = 1; l < levels.size(); ++l)
+      levels[l] += levels[l - 1];
+
+    std::uint32_t const        count = levels.empty() ? 0 : levels.back();
+    std::vector<index_type>    sorted_nodes(count);
+    std::vector<transform_t>   sorted_locals(count);
+    std::vector<transform_t>   sorted_worlds(count);
+    std::vector<std::uint8_t>  sorted_dirty(count);
+    std::vector<std::uint32_t> next(levels);
+    for (std::uint32_t s = 0, end = static_cast<std::uint32_t>(nodes.size()); s < end; ++s)
+    {
+      index_type const n = nodes[s];
+      if (n == k_null)
+        continue;
+      std::uint32_t const t = next[depths[n]]++;
+      sorted_nodes[t]       = n;
+      sorted_locals[t]      = locals[s];
+      sorted_worlds[t]      = worlds[s];
+      sorted_dirty[t]       = dirty[s];
+      slots[n]              = t;
+    }
+    nodes  = std::move(sorted_nodes);
+    locals = std::move(sorted_locals);
+    worlds = std::move(sorted_worlds);
+    dirty  = std::move(sorted_dirty);
+
+    parent_slots.resize(count);
+    for (std::uint32_t s = 0; s < count; ++s)
+      parent_slots[s] = parents[nodes[s]] == k_null ? k_null : slots[parents[nodes[s]]];
+    sorted = true;
+  }
+
+  // Per node index
+  std::vector<index_type>    parents;
+  std::vector<std::uint32_t> slots;
+  std::vector<std::uint32_t> child_counts;
+  std::vector<index_type>    free_nodes;
+  // Per slot, sorted by depth after sort
+  std::vector<index_type>    nodes;
+  std::vector<std::uint32_t> parent_slots;
+  std::vector<transform_t>   locals;
+  std::vector<transform_t>   worlds;
+  std::vector<std::uint8_t>  dirty;
+  //! Slots of level l are [levels[l], levels[l + 1])
+  std::vector<std::uint32_t> levels;
+  std::vector<std::uint32_t> dirty_slots;
+  bool                       sorted = true;
+};
+
+} // namespace vml
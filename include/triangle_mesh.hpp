@@ -0,0 +1,190 @@
+#pragma once
+
+#include "bvh.hpp"
+
+namespace vml
+{
+/**
+ * @remarks Triangle mesh prepacked for raycasts. build reads indexed triangles from a position
+ * stream with a byte stride, as mat4::transform_assume_ortho takes, orders them along the Morton
+ * curve of their centroids and packs them width at a time into SoA blocks of first vertex and
+ * edges, the layout rayxn::intersect_triangles tests in one call. A bvhn over the block bounds
+ * finds the blocks a ray crosses. Hits report triangles by their position in the index list,
+ * triangle i is made of indices 3i to 3i + 2.
+ */
+template <typename lane>
+class triangle_meshn
+{
+public:
+  using lane_type  = typename lane::type;
+  using index_type = std::uint32_t;
+  using vec3_type  = vec3xn_t<lane_type>;
+
+  enum : unsigned int
+  {
+    width = lane::element_count
+  };
+
+  static constexpr index_type k_no_hit = 0xffffffff;
+
+  //! width triangles in SoA, slots past the triangle count are degenerate and never hit
+  struct block
+  {
+    vec3_type  v0;
+    vec3_type  e1;
+    vec3_type  e2;
+    index_type triangle[width];
+  };
+
+  //! Nearest hit found by raycast
+  struct hit_type
+  {
+    float t;
+    //! Barycentric coordinates of the second and third vertex of the triangle
+    float      u;
+    float      v;
+    index_type triangle;
+  };
+
+  /**
+   * @remarks Build over the triangles of i_indices, 3 per triangle, into i_positions where vertex
+   * v starts v * i_stride bytes in. Any previous content is dropped.
+   */
+  inline void build(vec3_t const* i_positions, std::uint32_t i_stride, std::span<index_type const> i_indices)
+  {
+    clear();
+    count = static_cast<std::uint32_t>(i_indices.size() / 3);
+    if (!count)
+      return;
+    auto const position = [&](index_type v) -> vec3a_t
+    {
+      vec3_t const& p = *reinterpret_cast<vec3_t const*>(reinterpret_cast<std::uint8_t const*>(i_positions) +
+                                                         std::size_t(v) * i_stride);
+      return vec3a::set(p[0], p[1], p[2]);
+    };
+
+    std::vector<vec3a_t> vertices(count * 3);
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+      for (std::uint32_t c = 0; c < 3; ++c)
+        vertices[i * 3 + c] = position(i_indices[i * 3 + c]);
+    }
+
+    // Blocks take triangles in the Morton order of their centroids
+    std::vector<std::uint32_t> codes(count);
+    std::vector<std::uint32_t> order(count);
+    detail::morton_order<lane>(
+      count,
+      [&vertices](std::uint32_t i)
+      {
+        vec3a_t const sum = vec3a::add(vertices[i * 3], vec3a::add(vertices[i * 3 + 1], vertices[i * 3 + 2]));
+        return vec3a::mul(sum, 1.0f / 3.0f);
+      },
+      count, detail::serial_executor{}, codes, order);
+
+    std::uint32_t const block_count = (count + width - 1) / width;
+    std::vector<aabb_t> boxes(block_count, detail::empty_box());
+    blocks.resize(block_count);
+    for (std::uint32_t b = 0; b < block_count; ++b)
+    {
+      quad_t v0[width];
+      quad_t e1[width];
+      quad_t e2[width];
+      for (std::uint32_t k = 0; k < width; ++k)
+      {
+        std::uint32_t const i = b * width + k;
+        if (i >= count)
+        {
+          v0[k] = e1[k] = e2[k] = vec3a::zero();
+          blocks[b].triangle[k] = k_no_hit;
+          continue;
+        }
+        vec3a_t const* v      = &vertices[order[i] * 3];
+        v0[k]                 = v[0];
+        e1[k]                 = vec3a::sub(v[1], v[0]);
+        e2[k]                 = vec3a::sub(v[2], v[0]);
+        blocks[b].triangle[k] = order[i];
+        boxes[b]              = aabb::append(aabb::append(aabb::append(boxes[b], v[0]), v[1]), v[2]);
+      }
+      lane_type l[4];
+      detail::lanes_from_quads<lane>(v0, l);
+      blocks[b].v0 = {l[0], l[1], l[2]};
+      detail::lanes_from_quads<lane>(e1, l);
+      blocks[b].e1 = {l[0], l[1], l[2]};
+      detail::lanes_from_quads<lane>(e2, l);
+      blocks[b].e2 = {l[0], l[1], l[2]};
+    }
+    tree.build(boxes);
+  }
+
+  /**
+   * @remarks Nearest triangle hit by r within [0, t_max], either side facing. Returns false and
+   * leaves o_hit unchanged on a miss.
+   */
+  inline bool raycast(ray_t const& r, float t_max, hit_type& o_hit) const
+  {
+    using rayxn                   = vml::rayxn<lane>;
+    typename rayxn::type const rl = rayxn::set(r);
+    hit_type                   best{t_max, 0.0f, 0.0f, k_no_hit};
+    tree.raycast(r, t_max,
+                 [&](index_type b, float)
+                 {
+                   lane_type           t, u, v;
+                   block const&        blk  = blocks[b];
+                   std::uint32_t const hits = rayxn::intersect_triangles(rl, blk.v0, blk.e1, blk.e2, best.t, t, u, v);
+                   for (std::uint32_t m = hits; m; m &= m - 1)
+                   {
+                     std::uint32_t const k = std::countr_zero(m);
+                     if (lane::get(t, k) <= best.t)
+                       best = {lane::get(t, k), lane::get(u, k), lane::get(v, k), blk.triangle[k]};
+                   }
+                   // The tree skips blocks entered past the best hit
+                   return best.t;
+                 });
+    if (best.triangle == k_no_hit)
+      return false;
+    o_hit = best;
+    return true;
+  }
+
+  //! Number of triangles
+  inline std::uint32_t size() const noexcept
+  {
+    return count;
+  }
+
+  inline bool empty() const noexcept
+  {
+    return count == 0;
+  }
+
+  //! Packed triangles, for callers testing them without the tree
+  inline std::span<block const> get_blocks() const noexcept
+  {
+    return blocks;
+  }
+
+  //! Bounds of all triangles
+  inline aabb_t bounds() const
+  {
+    return tree.bounds();
+  }
+
+  inline void clear()
+  {
+    blocks.clear();
+    tree.clear();
+    count = 0;
+  }
+
+private:
+  std::vector<block> blocks;
+  bvhn<lane>         tree;
+  std::uint32_t      count = 0;
+};
+
+using triangle_mesh4 = triangle_meshn<quad>;
+using triangle_mesh8 = triangle_meshn<quad8>;
+using triangle_mesh  = triangle_meshn<detail::stream_lane>;
+
+} // namespace vml
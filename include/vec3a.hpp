@@ -185,15 +185,12 @@ inline vec3a::type vec3a::mul(pref v, mat4_t const& m)
 {
 #if VML_USE_SSE_AVX
   type ret;
-  ret         = _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
-  ret         = _mm_mul_ps(ret, m.r[0]);
+  ret         = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+  ret         = quad::madd(ret, m.r[2], m.r[3]);
   type v_temp = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
-  v_temp      = _mm_mul_ps(v_temp, m.r[1]);
-  ret         = _mm_add_ps(ret, v_temp);
-  v_temp      = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
-  v_temp      = _mm_mul_ps(v_temp, m.r[2]);
-  ret         = _mm_add_ps(ret, v_temp);
-  ret         = _mm_add_ps(ret, m.r[3]);
+  ret         = quad::madd(v_temp, m.r[1], ret);
+  v_temp      = _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
+  ret         = quad::madd(v_temp, m.r[0], ret);
   return from_vec4(ret);
 #else
   type r, x, y, z;
@@ -0,0 +1,261 @@
+#pragma once
+#include "quad8.hpp"
+
+namespace vml
+{
+namespace detail
+{
+//! Transpose lane::element_count quads into 4 lanes: lane k of o[c] is component c of q[k]
+template <typename lane>
+inline void lanes_from_quads(quad_t const* q, typename lane::type (&o)[4])
+{
+  if constexpr (lane::element_count == 4)
+  {
+    o[0] = q[0];
+    o[1] = q[1];
+    o[2] = q[2];
+    o[3] = q[3];
+    quad::transpose(o[0], o[1], o[2], o[3]);
+  }
+  else
+  {
+    quad_t lo[4] = {q[0], q[1], q[2], q[3]};
+    quad_t hi[4] = {q[4], q[5], q[6], q[7]};
+    quad::transpose(lo[0], lo[1], lo[2], lo[3]);
+    quad::transpose(hi[0], hi[1], hi[2], hi[3]);
+    for (std::uint32_t c = 0; c < 4; ++c)
+      o[c] = lane::set(lo[c], hi[c]);
+  }
+}
+
+//! Inverse of lanes_from_quads
+template <typename lane>
+inline void lanes_to_quads(typename lane::type const (&v)[4], quad_t* q)
+{
+  if constexpr (lane::element_count == 4)
+  {
+    q[0] = v[0];
+    q[1] = v[1];
+    q[2] = v[2];
+    q[3] = v[3];
+    quad::transpose(q[0], q[1], q[2], q[3]);
+  }
+  else
+  {
+    for (std::uint32_t c = 0; c < 4; ++c)
+    {
+      q[c]     = lane::lo(v[c]);
+      q[c + 4] = lane::hi(v[c]);
+    }
+    quad::transpose(q[0], q[1], q[2], q[3]);
+    quad::transpose(q[4], q[5], q[6], q[7]);
+  }
+}
+} // namespace detail
+
+//! Structure of arrays vec3 over quad (4 vectors) or quad8 (8 vectors). Every function works
+//! on all lanes at once and mirrors the vec3a function of the same name, with results that
+//! are scalar in vec3a returned as a lane.
+template <typename lane>
+struct vec3xn
+{
+  using lane_type   = typename lane::type;
+  using lane_pref   = typename lane::pref;
+  using type        = vec3xn_t<lane_type>;
+  using ref         = type&;
+  using pref        = type const&;
+  using cref        = type const&;
+  using scalar_type = float;
+  using row_type    = lane_type;
+
+  enum : unsigned int
+  {
+    element_count = lane::element_count
+  };
+
+  static inline type set(lane_pref x, lane_pref y, lane_pref z);
+  //! Broadcast v to all lanes
+  static inline type set(vec3a_t const& v);
+  static inline type zero();
+  //! Load element_count vectors, AoS to SoA
+  static inline type load(vec3a_t const* v);
+  static inline type load(vec3_t const* v);
+  //! Store element_count vectors, SoA to AoS
+  static inline void store(vec3a_t* o, pref v);
+  static inline void store(vec3_t* o, pref v);
+  //! Return the vector in lane i
+  static inline vec3a_t   get(pref v, std::uint32_t i);
+  static inline type      add(pref a, pref b);
+  static inline type      sub(pref a, pref b);
+  static inline type      mul(pref a, pref b);
+  static inline type      mul(pref a, lane_pref b);
+  static inline type      madd(pref v, pref m, pref a);
+  static inline type      negate(pref v);
+  static inline type      min(pref a, pref b);
+  static inline type      max(pref a, pref b);
+  static inline type      select(pref v1, pref v2, lane_pref control);
+  static inline lane_type dot(pref a, pref b);
+  static inline type      cross(pref a, pref b);
+  static inline lane_type sqlength(pref v);
+  static inline lane_type length(pref v);
+  static inline type      normalize(pref v);
+  static inline type      lerp(pref src, pref dst, lane_pref t);
+};
+
+using vec3x4 = vec3xn<quad>;
+using vec3x8 = vec3xn<quad8>;
+
+template <typename lane>
+inline typename vec3xn<lane>::type vec3xn<lane>::set(lane_pref x, lane_pref y, lane_pref z)
+{
+  return {x, y, z};
+}
+
+template <typename lane>
+inline typename vec3xn<lane>::type vec3xn<lane>::set(vec3a_t const& v)
+{
+  return {lane::set(quad::x(v)), lane::set(quad::y(v)), lane::set(quad::z(v))};
+}
+
+template <typename lane>
+inline typename vec3xn<lane>::type vec3xn<lane>::zero()
+{
+  return {lane::zero(), lane::zero(), lane::zero()};
+}
+
+template <typename lane>
+inline typename vec3xn<lane>::type vec3xn<lane>::load(vec3a_t const* v)
+{
+  lane_type o[4];
+  detail::lanes_from_quads<lane>(v, o);
+  return {o[0], o[1], o[2]};
+}
+
+template <typename lane>
+inline typename vec3xn<lane>::type vec3xn<lane>::load(vec3_t const* v)
+{
+  quad_t q[element_count];
+  for (std::uint32_t i = 0; i < element_count; ++i)
+    q[i] = quad::set(v[i][0], v[i][1], v[i][2]);
+  lane_type o[4];
+  detail::lanes_from_quads<lane>(q, o);
+  return {o[0], o[1], o[2]};
+}
+
+template <typename lane>
+inline void vec3xn<lane>::store(vec3a_t* o, pref v)
+{
+  lane_type const l[4] = {v.x, v.y, v.z, lane::zero()};
+  detail::lanes_to_quads<lane>(l, o);
+}
+
+template <typename lane>
+inline void vec3xn<lane>::store(vec3_t* o, pref v)
+{
+  quad_t          q[element_count];
+  lane_type const l[4] = {v.x, v.y, v.z, lane::zero()};
+  detail::lanes_to_quads<lane>(l, q);
+  for (std::uint32_t i = 0; i < element_count; ++i)
+    o[i] = {quad::x(q[i]), quad::y(q[i]), quad::z(q[i])};
+}
+
+template <typename lane>
+inline vec3a_t vec3xn<lane>::get(pref v, std::uint32_t i)
+{
+  return quad::set(lane::get(v.x, i), lane::get(v.y, i), lane::get(v.z, i));
+}
+
+template <typename lane>
+inline typename vec3xn<lane>::type vec3xn<lane>::add(pref a, pref b)
+{
+  return {lane::add(a.x, b.x), lane::add(a.y, b.y), lane::add(a.z, b.z)};
+}
+
+template <typename lane>
+inline typename vec3xn<lane>::type vec3xn<lane>::sub(pref a, pref b)
+{
+  return {lane::sub(a.x, b.x), lane::sub(a.y, b.y), lane::sub(a.z, b.z)};
+}
+
+template <typename lane>
+inline typename vec3xn<lane>::type vec3xn<lane>::mul(pref a, pref b)
+{
+  return {lane::mul(a.x, b.x), lane::mul(a.y, b.y), lane::mul(a.z, b.z)};
+}
+
+template <typename lane>
+inline typename vec3xn<lane>::type vec3xn<lane>::mul(pref a, lane_pref b)
+{
+  return {lane::mul(a.x, b), lane::mul(a.y, b), lane::mul(a.z, b)};
+}
+
+template <typename lane>
+inline typename vec3xn<lane>::type vec3xn<lane>::madd(pref v, pref m, pref a)
+{
+  return {lane::madd(v.x, m.x, a.x), lane::madd(v.y, m.y, a.y), lane::madd(v.z, m.z, a.z)};
+}
+
+template <typename lane>
+inline typename vec3xn<lane>::type vec3xn<lane>::negate(pref v)
+{
+  return {lane::negate(v.x), lane::negate(v.y), lane::negate(v.z)};
+}
+
+template <typename lane>
+inline typename vec3xn<lane>::type vec3xn<lane>::min(pref a, pref b)
+{
+  return {lane::min(a.x, b.x), lane::min(a.y, b.y), lane::min(a.z, b.z)};
+}
+
+template <typename lane>
+inline typename vec3xn<lane>::type vec3xn<lane>::max(pref a, pref b)
+{
+  return {lane::max(a.x, b.x), lane::max(a.y, b.y), lane::max(a.z, b.z)};
+}
+
+template <typename lane>
+inline typename vec3xn<lane>::type vec3xn<lane>::select(pref v1, pref v2, lane_pref control)
+{
+  return {lane::select(v1.x, v2.x, control), lane::select(v1.y, v2.y, control), lane::select(v1.z, v2.z, control)};
+}
+
+template <typename lane>
+inline typename vec3xn<lane>::lane_type vec3xn<lane>::dot(pref a, pref b)
+{
+  return lane::madd(a.z, b.z, lane::madd(a.y, b.y, lane::mul(a.x, b.x)));
+}
+
+template <typename lane>
+inline typename vec3xn<lane>::type vec3xn<lane>::cross(pref a, pref b)
+{
+  return {lane::sub(lane::mul(a.y, b.z), lane::mul(a.z, b.y)), lane::sub(lane::mul(a.z, b.x), lane::mul(a.x, b.z)),
+          lane::sub(lane::mul(a.x, b.y), lane::mul(a.y, b.x))};
+}
+
+template <typename lane>
+inline typename vec3xn<lane>::lane_type vec3xn<lane>::sqlength(pref v)
+{
+  return dot(v, v);
+}
+
+template <typename lane>
+inline typename vec3xn<lane>::lane_type vec3xn<lane>::length(pref v)
+{
+  return lane::sqrt(dot(v, v));
+}
+
+template <typename lane>
+inline typename vec3xn<lane>::type vec3xn<lane>::normalize(pref v)
+{
+  lane_type l = length(v);
+  return {lane::div(v.x, l), lane::div(v.y, l), lane::div(v.z, l)};
+}
+
+template <typename lane>
+inline typename vec3xn<lane>::type vec3xn<lane>::lerp(pref src, pref dst, lane_pref t)
+{
+  return {lane::madd(t, lane::sub(dst.x, src.x), src.x), lane::madd(t, lane::sub(dst.y, src.y), src.y),
+          lane::madd(t, lane::sub(dst.z, src.z), src.z)};
+}
+
+} // namespace vml
@@ -23,17 +23,14 @@ inline vec4::type vec4::mul(pref v, mat4_t const& m)
 {
 #if VML_USE_SSE_AVX
   quad_t ret, v_temp;
-  ret    = _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
-  ret    = _mm_mul_ps(ret, m.r[0]);
-  v_temp = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
-  v_temp = _mm_mul_ps(v_temp, m.r[1]);
-  ret    = _mm_add_ps(ret, v_temp);
+  ret    = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+  ret    = _mm_mul_ps(ret, m.r[3]);
   v_temp = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
-  v_temp = _mm_mul_ps(v_temp, m.r[2]);
-  ret    = _mm_add_ps(ret, v_temp);
-  v_temp = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
-  v_temp = _mm_mul_ps(v_temp, m.r[3]);
-  ret    = _mm_add_ps(ret, v_temp);
+  ret    = quad::madd(v_temp, m.r[2], ret);
+  v_temp = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
+  ret    = quad::madd(v_temp, m.r[1], ret);
+  v_temp = _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
+  ret    = quad::madd(v_temp, m.r[0], ret);
   return ret;
 #else
   quad_t r, x, y, z, w;
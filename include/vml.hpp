@@ -6,36 +6,54 @@
 #endif
 
 #include "aabb.hpp"
+#include "affine3x4.hpp"
 #include "axis_angle.hpp"
 #include "bounding_volume.hpp"
+#include "bounds_hierarchy.hpp"
+#include "bvh.hpp"
+#include "dynamic_aabb_tree.hpp"
 #include "euler_angles.hpp"
 #include "frustum.hpp"
+#include "grid_traversal.hpp"
 #include "intersect.hpp"
 #include "irect.hpp"
 #include "ivec2.hpp"
 #include "ivec3.hpp"
 #include "ivec4.hpp"
+#include "kd_tree.hpp"
 
 #include "mat_base.hpp"
 
 #include "mat3.hpp"
 #include "mat4.hpp"
+#include "mat4xn.hpp"
 
 #include "multi_dim.hpp"
+#include "obb.hpp"
 #include "plane.hpp"
 #include "polar_coord.hpp"
 #include "quad.hpp"
+#include "quad8.hpp"
 #include "quat.hpp"
+#include "quatxn.hpp"
+#include "ray.hpp"
+#include "ray_packet.hpp"
 #include "real.hpp"
 #include "rect.hpp"
+#include "soa_vector.hpp"
+#include "spatial_hash_grid.hpp"
 #include "sphere.hpp"
+#include "sweep_and_prune.hpp"
 #include "transform.hpp"
+#include "transform_hierarchy.hpp"
+#include "triangle_mesh.hpp"
 
 #include "vec_base.hpp"
 
 #include "vec2.hpp"
 #include "vec3.hpp"
 #include "vec3a.hpp"
+#include "vec3xn.hpp"
 #include "vec4.hpp"
 #include "vml_fcn.hpp"
 
@@ -0,0 +1,60 @@
+# Fails when two vml_kernels instruction set objects define the same weak symbol. The linker keeps a
+# single copy of such a symbol, which may be the one compiled for a wider instruction set than the cpu
+# dispatching to the narrower variant supports.
+#
+#   cmake -DVML_NM=<nm> -P check_isa_symbols.cmake <object>...
+
+if (NOT VML_NM)
+  message(FATAL_ERROR "VML_NM must name the nm tool")
+endif()
+
+set(objects)
+set(in_objects OFF)
+math(EXPR last_arg "${CMAKE_ARGC} - 1")
+foreach(i RANGE 0 ${last_arg})
+  if (in_objects)
+    list(APPEND objects "${CMAKE_ARGV${i}}")
+  elseif (CMAKE_ARGV${i} MATCHES "check_isa_symbols\\.cmake$")
+    set(in_objects ON)
+  endif()
+endforeach()
+
+list(LENGTH objects object_count)
+if (object_count LESS 2)
+  message(FATAL_ERROR "Expected the object files of at least two instruction set variants")
+endif()
+
+set(seen_symbols)
+set(seen_objects)
+set(shared_count 0)
+foreach(object ${objects})
+  execute_process(COMMAND ${VML_NM} --defined-only ${object} OUTPUT_VARIABLE symbols RESULT_VARIABLE result)
+  if (NOT result EQUAL 0)
+    message(FATAL_ERROR "${VML_NM} failed on ${object}")
+  endif()
+  string(REGEX MATCHALL "[^\n]+" lines "${symbols}")
+  set(weak_symbols)
+  foreach(line ${lines})
+    if (line MATCHES "^[0-9a-fA-F]* [WVu] (.+)$")
+      list(APPEND weak_symbols "${CMAKE_MATCH_1}")
+    endif()
+  endforeach()
+  if (weak_symbols)
+    list(REMOVE_DUPLICATES weak_symbols)
+  endif()
+  foreach(symbol ${weak_symbols})
+    list(FIND seen_symbols "${symbol}" index)
+    if (index GREATER -1)
+      list(GET seen_objects ${index} other)
+      message(SEND_ERROR "${symbol} is defined by both ${other} and ${object}")
+      math(EXPR shared_count "${shared_count} + 1")
+    else()
+      list(APPEND seen_symbols "${symbol}")
+      list(APPEND seen_objects "${object}")
+    endif()
+  endforeach()
+endforeach()
+
+if (shared_count GREATER 0)
+  message(FATAL_ERROR "${shared_count} weak symbols are shared between instruction set variants")
+endif()
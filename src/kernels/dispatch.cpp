@@ -0,0 +1,201 @@
+#include "kernel_table.hpp"
+#include <atomic>
+#include <kernels.hpp>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+#if !VML_USE_SSE_AVX
+#error "vml_kernels requires VML_USE_SSE_AVX"
+#endif
+
+namespace vml::kernels
+{
+namespace
+{
+
+struct cpuid_regs
+{
+  std::uint32_t eax = 0;
+  std::uint32_t ebx = 0;
+  std::uint32_t ecx = 0;
+  std::uint32_t edx = 0;
+};
+
+cpuid_regs cpuid(std::uint32_t i_leaf, std::uint32_t i_subleaf)
+{
+  cpuid_regs r;
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuidex(info, static_cast<int>(i_leaf), static_cast<int>(i_subleaf));
+  r.eax = static_cast<std::uint32_t>(info[0]);
+  r.ebx = static_cast<std::uint32_t>(info[1]);
+  r.ecx = static_cast<std::uint32_t>(info[2]);
+  r.edx = static_cast<std::uint32_t>(info[3]);
+#else
+  if (i_leaf > __get_cpuid_max(0, nullptr))
+    return r;
+  __cpuid_count(i_leaf, i_subleaf, r.eax, r.ebx, r.ecx, r.edx);
+#endif
+  return r;
+}
+
+//! Register state the OS saves on context switch (XCR0)
+std::uint64_t xgetbv()
+{
+#if defined(_MSC_VER)
+  return _xgetbv(0);
+#else
+  std::uint32_t eax, edx;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (static_cast<std::uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+isa_level detect_level()
+{
+  cpuid_regs const leaf1 = cpuid(1, 0);
+  if (!(leaf1.ecx & (1u << 19)))
+    return isa_level::k_sse2;
+
+  bool const osxsave = (leaf1.ecx & (1u << 27)) != 0;
+  bool const avx     = (leaf1.ecx & (1u << 28)) != 0;
+  bool const fma     = (leaf1.ecx & (1u << 12)) != 0;
+  if (!osxsave || !avx || !fma)
+    return isa_level::k_sse41;
+
+  std::uint64_t const xcr0 = xgetbv();
+  // xmm and ymm state
+  if ((xcr0 & 0x6) != 0x6)
+    return isa_level::k_sse41;
+
+  cpuid_regs const leaf7 = cpuid(7, 0);
+  if (!(leaf7.ebx & (1u << 5)))
+    return isa_level::k_sse41;
+
+  bool const avx512f  = (leaf7.ebx & (1u << 16)) != 0;
+  bool const avx512vl = (leaf7.ebx & (1u << 31)) != 0;
+  // opmask, upper zmm0-15 and zmm16-31 state
+  if (avx512f && avx512vl && (xcr0 & 0xe6) == 0xe6)
+    return isa_level::k_avx512;
+  return isa_level::k_avx2_fma;
+}
+
+detail::kernel_table const& table_for(isa_level i_level)
+{
+  switch (i_level)
+  {
+  case isa_level::k_avx512:
+    return detail::avx512_table();
+  case isa_level::k_avx2_fma:
+    return detail::avx2_fma_table();
+  case isa_level::k_sse41:
+    return detail::sse41_table();
+  default:
+    return detail::sse2_table();
+  }
+}
+
+struct dispatch_state
+{
+  isa_level                                 supported = detect_level();
+  std::atomic<isa_level>                    level{supported};
+  std::atomic<detail::kernel_table const*> table{&table_for(supported)};
+};
+
+dispatch_state& state()
+{
+  static dispatch_state s;
+  return s;
+}
+
+detail::kernel_table const& table()
+{
+  return *state().table.load(std::memory_order_relaxed);
+}
+
+} // namespace
+
+isa_level selected_level()
+{
+  return state().level.load(std::memory_order_relaxed);
+}
+
+isa_level supported_level()
+{
+  return state().supported;
+}
+
+bool select_level(isa_level i_level)
+{
+  dispatch_state& s = state();
+  if (static_cast<std::uint32_t>(i_level) > static_cast<std::uint32_t>(s.supported))
+    return false;
+  s.level.store(i_level, std::memory_order_relaxed);
+  s.table.store(&table_for(i_level), std::memory_order_relaxed);
+  return true;
+}
+
+char const* level_name(isa_level i_level)
+{
+  switch (i_level)
+  {
+  case isa_level::k_sse2:
+    return "sse2";
+  case isa_level::k_sse41:
+    return "sse41";
+  case isa_level::k_avx2_fma:
+    return "avx2_fma";
+  case isa_level::k_avx512:
+    return "avx512";
+  }
+  return "unknown";
+}
+
+void bounding_volumes_frustum(std::span<bounding_volume_t const> i_vols, frustum_t const& i_frustum,
+                              std::span<std::uint32_t> o_results)
+{
+  assert(o_results.size() >= (i_vols.size() + 15) / 16);
+  table().bounding_volumes_frustum(i_vols.data(), static_cast<std::uint32_t>(i_vols.size()), &i_frustum,
+                                   o_results.data());
+}
+
+void bounding_volumes_frustum_visibility(std::span<bounding_volume_t const> i_vols, frustum_t const& i_frustum,
+                                         std::span<std::uint32_t> o_visible)
+{
+  assert(o_visible.size() >= (i_vols.size() + 31) / 32);
+  table().bounding_volumes_frustum_visibility(i_vols.data(), static_cast<std::uint32_t>(i_vols.size()), &i_frustum,
+                                              o_visible.data());
+}
+
+void bounding_volumes_frustum(std::span<sphere_box_t const> i_vols, frustum_t const& i_frustum,
+                              std::span<std::uint32_t> o_results)
+{
+  assert(o_results.size() >= (i_vols.size() + 15) / 16);
+  table().sphere_boxes_frustum(i_vols.data(), static_cast<std::uint32_t>(i_vols.size()), &i_frustum, o_results.data());
+}
+
+void bounding_volumes_frustum_visibility(std::span<sphere_box_t const> i_vols, frustum_t const& i_frustum,
+                                         std::span<std::uint32_t> o_visible)
+{
+  assert(o_visible.size() >= (i_vols.size() + 31) / 32);
+  table().sphere_boxes_frustum_visibility(i_vols.data(), static_cast<std::uint32_t>(i_vols.size()), &i_frustum,
+                                          o_visible.data());
+}
+
+void transform_assume_ortho(mat4_t const& i_m, vec3_t const* i_stream, std::uint32_t i_stride, std::uint32_t i_count,
+                            vec3_t* o_stream, std::uint32_t i_output_stride)
+{
+  table().transform_assume_ortho(&i_m, i_stream, i_stride, i_count, o_stream, i_output_stride);
+}
+
+void transform_and_project(mat4_t const& i_m, vec3_t const* i_stream, std::uint32_t i_stride, std::uint32_t i_count,
+                           vec3_t* o_stream, std::uint32_t i_output_stride)
+{
+  table().transform_and_project(&i_m, i_stream, i_stride, i_count, o_stream, i_output_stride);
+}
+
+} // namespace vml::kernels
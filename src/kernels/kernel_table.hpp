@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+
+namespace vml::kernels::detail
+{
+
+//! Entry points of one instruction set variant. The variants are compiled against their own
+//! copy of the vml namespace, so vml types cross this boundary as untyped pointers; their
+//! layout is the same for every SSE level.
+struct kernel_table
+{
+  void (*bounding_volumes_frustum)(void const* i_vols, std::uint32_t i_count, void const* i_frustum,
+                                   std::uint32_t* o_results);
+  void (*bounding_volumes_frustum_visibility)(void const* i_vols, std::uint32_t i_count, void const* i_frustum,
+                                              std::uint32_t* o_visible);
+  void (*sphere_boxes_frustum)(void const* i_vols, std::uint32_t i_count, void const* i_frustum,
+                               std::uint32_t* o_results);
+  void (*sphere_boxes_frustum_visibility)(void const* i_vols, std::uint32_t i_count, void const* i_frustum,
+                                          std::uint32_t* o_visible);
+  void (*transform_assume_ortho)(void const* i_m, void const* i_stream, std::uint32_t i_stride, std::uint32_t i_count,
+                                 void* o_stream, std::uint32_t i_output_stride);
+  void (*transform_and_project)(void const* i_m, void const* i_stream, std::uint32_t i_stride, std::uint32_t i_count,
+                                void* o_stream, std::uint32_t i_output_stride);
+};
+
+kernel_table const& sse2_table();
+kernel_table const& sse41_table();
+kernel_table const& avx2_fma_table();
+kernel_table const& avx512_table();
+
+} // namespace vml::kernels::detail
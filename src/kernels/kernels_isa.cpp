@@ -0,0 +1,91 @@
+// Compiled once per instruction set with VML_KERNELS_ISA set to the variant name and
+// VML_USE_SSE_LEVEL plus the matching compiler flags. Every inline vml function ends up
+// in a namespace of its own (vml_sse2, vml_avx2_fma, ...) so the linker never mixes
+// definitions built for different instruction sets. std is not renamed, so the kernels
+// call the pointer based cores and must not instantiate std:: templates; the
+// kernels-isa-symbols test fails if two variants define the same weak symbol.
+
+#ifndef VML_KERNELS_ISA
+#error "VML_KERNELS_ISA must name the instruction set variant being compiled"
+#endif
+
+#if !VML_USE_SSE_AVX
+#error "vml_kernels variants require VML_USE_SSE_AVX"
+#endif
+
+#define VML_KERNELS_CAT_(a, b) a##b
+#define VML_KERNELS_CAT(a, b)  VML_KERNELS_CAT_(a, b)
+
+#define vml VML_KERNELS_CAT(vml_, VML_KERNELS_ISA)
+#include <vml.hpp>
+#include <impl/intersect_cull.hpp>
+namespace isa = vml;
+#undef vml
+
+#include "kernel_table.hpp"
+
+namespace
+{
+
+void bounding_volumes_frustum(void const* i_vols, std::uint32_t i_count, void const* i_frustum,
+                              std::uint32_t* o_results)
+{
+  isa::intersect::detail::cull_results(static_cast<isa::bounding_volume_t const*>(i_vols), i_count,
+                                       *static_cast<isa::frustum_t const*>(i_frustum), o_results, (i_count + 15) / 16);
+}
+
+void bounding_volumes_frustum_visibility(void const* i_vols, std::uint32_t i_count, void const* i_frustum,
+                                         std::uint32_t* o_visible)
+{
+  isa::intersect::detail::cull_visibility(static_cast<isa::bounding_volume_t const*>(i_vols), i_count,
+                                          *static_cast<isa::frustum_t const*>(i_frustum), o_visible,
+                                          (i_count + 31) / 32);
+}
+
+void sphere_boxes_frustum(void const* i_vols, std::uint32_t i_count, void const* i_frustum, std::uint32_t* o_results)
+{
+  isa::intersect::detail::cull_results(static_cast<isa::sphere_box_t const*>(i_vols), i_count,
+                                       *static_cast<isa::frustum_t const*>(i_frustum), o_results, (i_count + 15) / 16);
+}
+
+void sphere_boxes_frustum_visibility(void const* i_vols, std::uint32_t i_count, void const* i_frustum,
+                                     std::uint32_t* o_visible)
+{
+  isa::intersect::detail::cull_visibility(static_cast<isa::sphere_box_t const*>(i_vols), i_count,
+                                          *static_cast<isa::frustum_t const*>(i_frustum), o_visible,
+                                          (i_count + 31) / 32);
+}
+
+void transform_assume_ortho(void const* i_m, void const* i_stream, std::uint32_t i_stride, std::uint32_t i_count,
+                            void* o_stream, std::uint32_t i_output_stride)
+{
+  isa::mat4::transform_assume_ortho(*static_cast<isa::mat4_t const*>(i_m), static_cast<isa::vec3_t const*>(i_stream),
+                                    i_stride, i_count, static_cast<isa::vec3_t*>(o_stream), i_output_stride);
+}
+
+void transform_and_project(void const* i_m, void const* i_stream, std::uint32_t i_stride, std::uint32_t i_count,
+                           void* o_stream, std::uint32_t i_output_stride)
+{
+  isa::mat4::transform_and_project(*static_cast<isa::mat4_t const*>(i_m), static_cast<isa::vec3_t const*>(i_stream),
+                                   i_stride, i_count, static_cast<isa::vec3_t*>(o_stream), i_output_stride);
+}
+
+} // namespace
+
+namespace vml::kernels::detail
+{
+
+kernel_table const& VML_KERNELS_CAT(VML_KERNELS_ISA, _table)()
+{
+  static kernel_table const table = {
+    &bounding_volumes_frustum,
+    &bounding_volumes_frustum_visibility,
+    &sphere_boxes_frustum,
+    &sphere_boxes_frustum_visibility,
+    &transform_assume_ortho,
+    &transform_and_project,
+  };
+  return table;
+}
+
+} // namespace vml::kernels::detail
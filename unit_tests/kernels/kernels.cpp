@@ -0,0 +1,121 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <kernels.hpp>
+#include <string>
+#include <vector>
+#include <vml-impl.hpp>
+#include <vml.hpp>
+
+namespace
+{
+template <typename test_fn>
+void for_each_supported_level(test_fn&& test)
+{
+  vml::kernels::isa_level const supported = vml::kernels::supported_level();
+  for (std::uint32_t l = 0; l <= static_cast<std::uint32_t>(supported); ++l)
+  {
+    auto level = static_cast<vml::kernels::isa_level>(l);
+    REQUIRE(vml::kernels::select_level(level));
+    CHECK(vml::kernels::selected_level() == level);
+    INFO("level " << vml::kernels::level_name(level));
+    test();
+  }
+  REQUIRE(vml::kernels::select_level(supported));
+}
+} // namespace
+
+TEST_CASE("Validate kernels::selected_level", "[kernels::selected_level]")
+{
+  vml::kernels::isa_level const supported = vml::kernels::supported_level();
+  CHECK(vml::kernels::selected_level() == supported);
+  CHECK(vml::kernels::select_level(vml::kernels::isa_level::k_sse2));
+  CHECK(vml::kernels::selected_level() == vml::kernels::isa_level::k_sse2);
+  if (supported != vml::kernels::isa_level::k_avx512)
+    CHECK(vml::kernels::select_level(vml::kernels::isa_level::k_avx512) == false);
+  CHECK(vml::kernels::select_level(supported));
+  CHECK(std::string(vml::kernels::level_name(vml::kernels::isa_level::k_avx2_fma)) == "avx2_fma");
+}
+
+TEST_CASE("Validate kernels::bounding_volumes_frustum", "[kernels::bounding_volumes_frustum]")
+{
+  vml::mat4_t    m       = vml::mat4::from_orthographic_projection(-50.0f, 50.0f, -45.0f, 45.0f, 1.0f, 1000.0f);
+  vml::frustum_t frustum = vml::frustum::from_mat4_transpose(vml::mat4::transpose(m));
+
+  std::vector<vml::bounding_volume_t> vols;
+  for (int i = 0; i < 45; ++i)
+  {
+    float offset = static_cast<float>(i) * 3.5f - 70.0f;
+    vols.push_back(vml::bounding_volume::from_box(vml::vec3a::set(offset, 5.0f, 100.0f + offset),
+                                                  vml::vec3a::set(static_cast<float>(i % 3) + 1.0f)));
+  }
+
+  std::vector<vml::sphere_box_t> world(vols.size());
+  std::vector<vml::sphere_box_t> local(vols.size());
+  vml::bounding_volume::split(vols, world, local);
+
+  std::array<std::uint32_t, 3> expected_codes;
+  std::array<std::uint32_t, 2> expected_visible;
+  vml::intersect::bounding_volumes_frustum(vols, frustum, expected_codes);
+  vml::intersect::bounding_volumes_frustum_visibility(vols, frustum, expected_visible);
+
+  for_each_supported_level(
+    [&]()
+    {
+      std::array<std::uint32_t, 3> codes;
+      std::array<std::uint32_t, 2> visible;
+      codes.fill(0xffffffff);
+      visible.fill(0xffffffff);
+      vml::kernels::bounding_volumes_frustum(vols, frustum, codes);
+      vml::kernels::bounding_volumes_frustum_visibility(vols, frustum, visible);
+      CHECK(codes == expected_codes);
+      CHECK(visible == expected_visible);
+
+      codes.fill(0xffffffff);
+      visible.fill(0xffffffff);
+      vml::kernels::bounding_volumes_frustum(world, frustum, codes);
+      vml::kernels::bounding_volumes_frustum_visibility(world, frustum, visible);
+      CHECK(codes == expected_codes);
+      CHECK(visible == expected_visible);
+    });
+}
+
+TEST_CASE("Validate kernels::transform", "[kernels::transform]")
+{
+  vml::mat4_t m = vml::mat4::from_scale_rotation_translation(
+    2.0f, vml::quat::from_axis_angle(vml::vec3_t{0.0f, 1.0f, 0.0f}, vml::to_radians(30.0f)),
+    vml::vec3a::set(5.0f, -2.0f, 10.0f));
+  vml::mat4_t proj = vml::mat4::mul(m, vml::mat4::from_perspective_projection(1.0f, 1.5f, 1.0f, 100.0f));
+
+  std::vector<vml::vec3_t> points;
+  for (int i = 0; i < 19; ++i)
+    points.push_back({static_cast<float>(i), static_cast<float>(i % 5) - 2.0f, 20.0f + static_cast<float>(i)});
+
+  std::vector<vml::vec3_t> expected_ortho(points.size());
+  std::vector<vml::vec3_t> expected_project(points.size());
+  vml::mat4::transform_assume_ortho(m, points.data(), sizeof(vml::vec3_t), static_cast<std::uint32_t>(points.size()),
+                                    expected_ortho.data(), sizeof(vml::vec3_t));
+  vml::mat4::transform_and_project(proj, points.data(), sizeof(vml::vec3_t),
+                                   static_cast<std::uint32_t>(points.size()), expected_project.data(),
+                                   sizeof(vml::vec3_t));
+
+  for_each_supported_level(
+    [&]()
+    {
+      std::vector<vml::vec3_t> ortho(points.size());
+      std::vector<vml::vec3_t> project(points.size());
+      vml::kernels::transform_assume_ortho(m, points.data(), sizeof(vml::vec3_t),
+                                           static_cast<std::uint32_t>(points.size()), ortho.data(),
+                                           sizeof(vml::vec3_t));
+      vml::kernels::transform_and_project(proj, points.data(), sizeof(vml::vec3_t),
+                                          static_cast<std::uint32_t>(points.size()), project.data(),
+                                          sizeof(vml::vec3_t));
+      for (std::size_t i = 0; i < points.size(); ++i)
+      {
+        for (std::size_t c = 0; c < 3; ++c)
+        {
+          CHECK(ortho[i][c] == Approx(expected_ortho[i][c]));
+          CHECK(project[i][c] == Approx(expected_project[i][c]));
+        }
+      }
+    });
+}
@@ -0,0 +1,66 @@
+#include <catch2/catch.hpp>
+#include <vml.hpp>
+
+namespace
+{
+vml::mat4_t make_affine(float f)
+{
+  vml::mat4_t m = vml::mat4::mul(
+    vml::mat4::from_scale(vml::vec3a::set(2.0f + f, 0.5f, 3.0f)),
+    vml::mat4::from_rotation(vml::quat::from_axis_angle(vml::vec3_t{0.6f, 0.0f, 0.8f}, vml::to_radians(35.0f + f))));
+  m.r[3] = vml::quad::set(4.0f, -2.0f + f, 7.0f, 1.0f);
+  return m;
+}
+
+void check(vml::mat4_t const& r, vml::mat4_t const& expected)
+{
+  for (std::uint32_t j = 0; j < 16; ++j)
+    CHECK(r.m[j] == Approx(expected.m[j]).margin(1e-5f));
+}
+
+void check(vml::vec3a_t const& r, vml::vec3a_t const& expected)
+{
+  for (std::uint32_t j = 0; j < 3; ++j)
+    CHECK(vml::quad::get(r, j) == Approx(vml::quad::get(expected, j)).margin(1e-5f));
+  CHECK(vml::quad::get(r, 3) == 0.0f);
+}
+} // namespace
+
+TEST_CASE("Validate affine3x4::from_mat4", "[affine3x4::from_mat4]")
+{
+  static_assert(sizeof(vml::affine3x4_t) == 48);
+  vml::mat4_t      m = make_affine(0.0f);
+  vml::affine3x4_t a = vml::affine3x4::from_mat4(m);
+  CHECK(vml::affine3x4::to_mat4(a).m == m.m);
+  CHECK(vml::affine3x4::to_mat4(vml::affine3x4::identity()).m == vml::mat4::identity().m);
+  check(vml::affine3x4::translation(a), vml::vec3a::set(4.0f, -2.0f, 7.0f));
+}
+
+TEST_CASE("Validate affine3x4::mul", "[affine3x4::mul]")
+{
+  vml::mat4_t      m1 = make_affine(0.0f);
+  vml::mat4_t      m2 = make_affine(3.0f);
+  vml::affine3x4_t a1 = vml::affine3x4::from_mat4(m1);
+  vml::affine3x4_t a2 = vml::affine3x4::from_mat4(m2);
+  check(vml::affine3x4::to_mat4(vml::affine3x4::mul(a1, a2)), vml::mat4::mul(m1, m2));
+  check(vml::affine3x4::to_mat4(vml::affine3x4::inverse(a1)), vml::mat4::inverse(m1));
+  check(vml::affine3x4::to_mat4(vml::affine3x4::mul(a1, vml::affine3x4::inverse(a1))), vml::mat4::identity());
+}
+
+TEST_CASE("Validate affine3x4::transform", "[affine3x4::transform]")
+{
+  vml::mat4_t      m = make_affine(1.0f);
+  vml::affine3x4_t a = vml::affine3x4::from_mat4(m);
+  vml::vec3a_t     v = vml::vec3a::set(1.5f, -3.0f, 0.25f);
+  vml::vec3a_t     e = vml::vec3a::set(1.5f, 3.0f, 0.25f);
+
+  check(vml::affine3x4::transform_point(a, v), vml::vec3a::from_vec4(vml::mat4::transform_assume_ortho(m, v)));
+  check(vml::affine3x4::transform_vector(a, v), vml::mat4::mul(vml::quad::set_w(v, 0.0f), m));
+  check(vml::affine3x4::transform_bounds_extends(a, e), vml::mat4::transform_bounds_extends(m, e));
+
+  vml::aabb_t box      = vml::aabb::set(vml::vec3a::set(1.0f, 2.0f, -1.0f), vml::vec3a::set(0.5f, 2.0f, 1.0f));
+  vml::aabb_t r        = vml::affine3x4::transform_aabb(a, box);
+  vml::aabb_t expected = vml::mat4::transform_aabb(m, box);
+  check(r.r[0], expected.r[0]);
+  check(r.r[1], expected.r[1]);
+}
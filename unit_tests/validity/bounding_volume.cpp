@@ -1,4 +1,5 @@
 #include <catch2/catch.hpp>
+#include <vector>
 #include <vml.hpp>
 
 TEST_CASE("Validate bounds_info::update", "[bounds_info::update]")
@@ -205,6 +206,31 @@ TEST_CASE("Validate bounding_volume::update(transform)", "[bounding_volume::upda
   REQUIRE(vml::vec3a::z(vml::bounding_volume::half_extends(bounds1)) == Approx(5.65685));
 }
 
+TEST_CASE("Validate bounding_volume::update(srt) repeated", "[bounding_volume::update(srt)]")
+{
+  vml::bounding_volume_t bounds1 = vml::bounding_volume::set(vml::vec3a::set(1.0f, 0.0f, 0.0f),
+                                                             vml::vec3a::set(2.0f, 2.0f, 2.0f), 3.4641f);
+  vml::quat_t const      rot     = vml::quat::from_axis_angle(vml::vec3::set(0.0f, 1.0f, 0.0f), vml::to_radians(45.0f));
+
+  // The radius comes from the original volume, so updating again does not grow it
+  for (std::uint32_t i = 0; i < 3; ++i)
+  {
+    vml::bounding_volume::update(bounds1, 2.0f, rot, vml::vec3a::set(2.0f, 0.0f, 0.0f));
+    REQUIRE(vml::bounding_volume::radius(bounds1) == Approx(6.9282f));
+  }
+
+  // Same radius as the matrix overload for the same transform
+  vml::transform_t tf;
+  vml::transform::set_rotation(tf, rot);
+  vml::transform::set_scale(tf, 2.0f);
+  vml::transform::set_translation(tf, vml::vec3a::set(2.0f, 0.0f, 0.0f));
+  vml::mat4_t m;
+  vml::transform::matrix(tf, m);
+  vml::bounding_volume_t bounds2 = bounds1;
+  vml::bounding_volume::update(bounds2, m);
+  REQUIRE(vml::bounding_volume::radius(bounds2) == Approx(vml::bounding_volume::radius(bounds1)));
+}
+
 TEST_CASE("Validate bounding_volume::update(bounding_volume)", "[bounding_volume::update(bounding_volume)]")
 {
   vml::bounding_volume_t bounds1 = {
@@ -252,3 +278,57 @@ TEST_CASE("Validate bounding_volume::update(points)", "[bounding_volume::update(
   REQUIRE(vml::vec3a::y(vml::bounding_volume::half_extends(bounds1)) == Approx(10.0f));
   REQUIRE(vml::vec3a::z(vml::bounding_volume::half_extends(bounds1)) == Approx(10.0f));
 }
+
+TEST_CASE("Validate bounding_volume::update batch", "[bounding_volume::update batch]")
+{
+  constexpr std::uint32_t             k_count = 11;
+  std::vector<vml::bounding_volume_t> volumes(k_count);
+  std::vector<vml::sphere_box_t>      local(k_count);
+  std::vector<vml::mat4_t>            m(k_count);
+  std::vector<vml::transform_t>       tf(k_count);
+  for (std::uint32_t i = 0; i < k_count; ++i)
+  {
+    float f    = static_cast<float>(i);
+    volumes[i] = vml::bounding_volume::set(vml::vec3a::set(f, 1.0f, -f), vml::vec3a::set(1.0f + f, 2.0f, 0.5f),
+                                           2.0f + f);
+    local[i]   = {volumes[i].orig_spherical_vol, volumes[i].orig_half_extends};
+    vml::transform::set_rotation(
+      tf[i], vml::quat::from_axis_angle(vml::vec3::set(0.48f, 0.6f, 0.64f), vml::to_radians(23.0f * f)));
+    vml::transform::set_scale(tf[i], 0.5f + 0.5f * f);
+    vml::transform::set_translation(tf[i], vml::vec3a::set(2.0f, -f, 1.0f));
+    vml::transform::matrix(tf[i], m[i]);
+  }
+
+  auto check = [](vml::sphere_t const& sphere, vml::vec3a_t const& extends, vml::bounding_volume_t const& expected)
+  {
+    for (std::uint32_t j = 0; j < 3; ++j)
+    {
+      CHECK(sphere[j] == Approx(expected.spherical_vol[j]).margin(1e-4f));
+      CHECK(extends[j] == Approx(expected.half_extends[j]).margin(1e-4f));
+    }
+    CHECK(sphere[3] == Approx(expected.spherical_vol[3]).margin(1e-4f));
+  };
+
+  std::vector<vml::bounding_volume_t> batch = volumes;
+  std::vector<vml::sphere_box_t>      world(k_count);
+  vml::bounding_volume::update(batch, m);
+  vml::bounding_volume::update(world, local, m);
+  for (std::uint32_t i = 0; i < k_count; ++i)
+  {
+    vml::bounding_volume_t expected = volumes[i];
+    vml::bounding_volume::update(expected, m[i]);
+    check(batch[i].spherical_vol, batch[i].half_extends, expected);
+    check(world[i].spherical_vol, world[i].half_extends, expected);
+  }
+
+  batch = volumes;
+  vml::bounding_volume::update(batch, tf);
+  vml::bounding_volume::update(world, local, tf);
+  for (std::uint32_t i = 0; i < k_count; ++i)
+  {
+    vml::bounding_volume_t expected = volumes[i];
+    vml::bounding_volume::update(expected, tf[i]);
+    check(batch[i].spherical_vol, batch[i].half_extends, expected);
+    check(world[i].spherical_vol, world[i].half_extends, expected);
+  }
+}
@@ -0,0 +1,83 @@
+#include <catch2/catch.hpp>
+#include <vml.hpp>
+
+namespace
+{
+void check_box(vml::aabb_t const& r, vml::aabb_t const& expected)
+{
+  for (std::uint32_t i = 0; i < 2; ++i)
+    for (std::uint32_t j = 0; j < 3; ++j)
+      CHECK(vml::quad::get(r.r[i], j) == Approx(vml::quad::get(expected.r[i], j)));
+}
+} // namespace
+
+TEST_CASE("Validate bounds_hierarchy aabb", "[bounds_hierarchy]")
+{
+  vml::bounds_hierarchy<vml::aabb_t> h;
+
+  auto root  = h.insert();
+  auto group = h.insert(root);
+  auto a     = h.insert(group);
+  auto b     = h.insert(group);
+  auto c     = h.insert(root);
+  auto other = h.insert();
+
+  h.set_bounds(a, vml::aabb::set(vml::vec3a::set(1.0f, 0.0f, 0.0f), vml::vec3a::set(1.0f)));
+  h.set_bounds(b, vml::aabb::set(vml::vec3a::set(-4.0f, 2.0f, 0.0f), vml::vec3a::set(0.5f)));
+  h.set_bounds(c, vml::aabb::set(vml::vec3a::set(0.0f, 0.0f, 10.0f), vml::vec3a::set(1.0f)));
+  h.set_bounds(other, vml::aabb::set(vml::vec3a::set(100.0f), vml::vec3a::set(1.0f)));
+  // a, b, c, other, group and root, each once
+  CHECK(h.pending() == 6);
+  h.refit();
+  CHECK(h.pending() == 0);
+
+  vml::aabb_t expected_group =
+    vml::aabb::set_min_max(vml::vec3a::set(-4.5f, -1.0f, -1.0f), vml::vec3a::set(2.0f, 2.5f, 1.0f));
+  vml::aabb_t expected_root =
+    vml::aabb::set_min_max(vml::vec3a::set(-4.5f, -1.0f, -1.0f), vml::vec3a::set(2.0f, 2.5f, 11.0f));
+  check_box(h.bounds(group), expected_group);
+  check_box(h.bounds(root), expected_root);
+  check_box(h.bounds(other), h.local_bounds(other));
+
+  // Moving a only touches a, group and root
+  h.set_bounds(a, vml::aabb::set(vml::vec3a::set(0.0f, -5.0f, 0.0f), vml::vec3a::set(1.0f)));
+  CHECK(h.pending() == 3);
+  h.refit();
+  check_box(h.bounds(group),
+            vml::aabb::set_min_max(vml::vec3a::set(-4.5f, -6.0f, -1.0f), vml::vec3a::set(1.0f, 2.5f, 1.0f)));
+  check_box(h.bounds(root),
+            vml::aabb::set_min_max(vml::vec3a::set(-4.5f, -6.0f, -1.0f), vml::vec3a::set(1.0f, 2.5f, 11.0f)));
+
+  // Erasing c shrinks root, the index is reused after refit
+  h.erase(c);
+  CHECK(!h.contains(c));
+  h.refit();
+  check_box(h.bounds(root), h.bounds(group));
+  CHECK(h.insert(group) == c);
+  CHECK(h.size() == 6);
+}
+
+TEST_CASE("Validate bounds_hierarchy bounding_volume", "[bounds_hierarchy]")
+{
+  vml::bounds_hierarchy<vml::bounding_volume_t> h;
+
+  auto root  = h.insert();
+  auto a     = h.insert(root);
+  auto b     = h.insert(root);
+  auto empty = h.insert(root);
+
+  vml::bounding_volume_t va = vml::bounding_volume::from_box(vml::vec3a::set(2.0f, 0.0f, 0.0f), vml::vec3a::set(1.0f));
+  vml::bounding_volume_t vb = vml::bounding_volume::from_box(vml::vec3a::set(-2.0f, 0.0f, 0.0f), vml::vec3a::set(1.0f));
+  h.set_bounds(a, va);
+  h.set_bounds(b, vb);
+  h.refit();
+
+  // The empty child does not pull the bounds to the origin
+  vml::bounding_volume_t expected = va;
+  vml::bounding_volume::update(expected, vb);
+  CHECK(vml::bounding_volume::radius(h.bounds(empty)) == 0.0f);
+  CHECK(vml::vec3a::equals(vml::bounding_volume::center(h.bounds(root)), vml::bounding_volume::center(expected)));
+  CHECK(vml::vec3a::equals(vml::bounding_volume::half_extends(h.bounds(root)),
+                           vml::bounding_volume::half_extends(expected)));
+  CHECK(vml::bounding_volume::radius(h.bounds(root)) == Approx(vml::bounding_volume::radius(expected)));
+}
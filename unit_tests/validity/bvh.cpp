@@ -0,0 +1,295 @@
+#include "test_common.hpp"
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <thread>
+#include <vector>
+#include <vml.hpp>
+
+namespace
+{
+std::vector<vml::aabb_t> bvh_test_boxes(std::uint32_t count)
+{
+  vml_test::rng            rng{7};
+  std::vector<vml::aabb_t> boxes(count);
+  for (auto& b : boxes)
+  {
+    vml::vec3a_t c =
+      vml::vec3a::set(rng.next() * 200.0f - 100.0f, rng.next() * 200.0f - 100.0f, rng.next() * 200.0f - 100.0f);
+    vml::vec3a_t e = vml::vec3a::set(rng.next() * 4.0f + 0.1f, rng.next() * 4.0f + 0.1f, rng.next() * 4.0f + 0.1f);
+    b              = vml::aabb::set(c, e);
+  }
+  return boxes;
+}
+
+template <typename bvh_t, typename query_t>
+std::vector<std::uint32_t> bvh_test_collect(bvh_t const& tree, query_t const& q)
+{
+  std::vector<std::uint32_t> found;
+  tree.query(q,
+             [&found](std::uint32_t i)
+             {
+               found.push_back(i);
+             });
+  std::sort(found.begin(), found.end());
+  return found;
+}
+
+template <typename bvh_t>
+void bvh_test_queries(bvh_t const& tree, std::vector<vml::aabb_t> const& boxes)
+{
+  REQUIRE(tree.size() == boxes.size());
+
+  vml::aabb_t query_box = vml::aabb::set(vml::vec3a::set(10.0f, -5.0f, 20.0f), vml::vec3a::set(30.0f, 25.0f, 15.0f));
+  std::vector<std::uint32_t> expected;
+  for (std::uint32_t i = 0; i < boxes.size(); ++i)
+  {
+    if (!vml::vec3a::greater_any(boxes[i].r[0], query_box.r[1]) &&
+        !vml::vec3a::lesser_any(boxes[i].r[1], query_box.r[0]))
+      expected.push_back(i);
+  }
+  CHECK(!expected.empty());
+  CHECK(bvh_test_collect(tree, query_box) == expected);
+
+  vml::sphere_t sphere = vml::sphere::set(vml::vec3a::set(-20.0f, 10.0f, 5.0f), 35.0f);
+  expected.clear();
+  for (std::uint32_t i = 0; i < boxes.size(); ++i)
+  {
+    vml::vec3a_t c = vml::sphere::center(sphere);
+    vml::vec3a_t d = vml::vec3a::sub(vml::vec3a::min(vml::vec3a::max(c, boxes[i].r[0]), boxes[i].r[1]), c);
+    if (vml::vec3a::dot(d, d) <= 35.0f * 35.0f)
+      expected.push_back(i);
+  }
+  CHECK(!expected.empty());
+  CHECK(bvh_test_collect(tree, sphere) == expected);
+
+  vml::mat4_t    m       = vml::mat4::from_orthographic_projection(-40.0f, 40.0f, -30.0f, 30.0f, 1.0f, 60.0f);
+  vml::frustum_t frustum = vml::frustum::from_mat4_transpose(vml::mat4::transpose(m));
+  auto const     planes  = vml::frustum::get_planes(frustum);
+  expected.clear();
+  for (std::uint32_t i = 0; i < boxes.size(); ++i)
+  {
+    // bounding_volume_frustum stops at the first straddled plane, the tree tests all of them
+    vml::vec3a_t c       = vml::aabb::center(boxes[i]);
+    vml::vec3a_t e       = vml::aabb::half_size(boxes[i]);
+    bool         outside = false;
+    for (std::uint32_t p = 0; p < planes.second && !outside; ++p)
+    {
+      float m = vml::plane::dot(planes.first[p], c);
+      float n = vml::vec3a::dot(vml::plane::abs_normal(planes.first[p]), e);
+      outside = m + n < 0.0f;
+    }
+    if (!outside)
+      expected.push_back(i);
+  }
+  CHECK(!expected.empty());
+  CHECK(expected.size() < boxes.size());
+  CHECK(bvh_test_collect(tree, frustum) == expected);
+
+  // Aim at a box so the ray hits at least one
+  vml::vec3a_t origin    = vml::vec3a::set(-120.0f, 3.0f, -2.0f);
+  vml::vec3a_t direction = vml::vec3a::normalize(vml::vec3a::sub(vml::aabb::center(boxes[5]), origin));
+  expected.clear();
+  for (std::uint32_t i = 0; i < boxes.size(); ++i)
+  {
+    if (vml_test::ray_box_entry(boxes[i], origin, direction, 250.0f) >= 0.0f)
+      expected.push_back(i);
+  }
+  std::vector<std::uint32_t> found;
+  tree.raycast(origin, direction, 250.0f,
+               [&](std::uint32_t i, float t)
+               {
+                 CHECK(t >= 0.0f);
+                 found.push_back(i);
+               });
+  std::sort(found.begin(), found.end());
+  CHECK(!expected.empty());
+  CHECK(found == expected);
+}
+
+template <typename bvh_t>
+void bvh_test_median_leaves(std::vector<vml::aabb_t> const& boxes, std::vector<std::uint32_t> const& rank)
+{
+  bvh_t tree;
+  tree.build(boxes);
+  std::vector<std::uint32_t> found;
+  tree.query(vml::aabb::set(vml::vec3a::zero(), vml::vec3a::set(1.0f)),
+             [&found](std::uint32_t i)
+             {
+               found.push_back(i);
+             });
+  REQUIRE(found.size() == boxes.size());
+  // Leaves are visited one after the other, each holds k_leaf_size boxes of consecutive ranks
+  for (std::uint32_t l = 0; l < found.size(); l += bvh_t::k_leaf_size)
+  {
+    for (std::uint32_t k = 1; k < bvh_t::k_leaf_size; ++k)
+      CHECK(rank[found[l + k]] / bvh_t::k_leaf_size == rank[found[l]] / bvh_t::k_leaf_size);
+  }
+}
+
+template <typename bvh_t>
+void bvh_test_nearest(std::vector<vml::aabb_t> const& boxes)
+{
+  bvh_t tree;
+  tree.build(boxes);
+  vml_test::rng rng{61};
+  std::uint32_t full_visits    = 0;
+  std::uint32_t nearest_visits = 0;
+  for (std::uint32_t q = 0; q < 100; ++q)
+  {
+    vml::vec3a_t const origin    = vml::vec3a::set(-10.0f, rng.next() * 16.0f, rng.next() * 16.0f);
+    vml::vec3a_t const direction = vml::vec3a::set(1.0f, rng.next() * 0.2f - 0.1f, rng.next() * 0.2f - 0.1f);
+    float              expected  = -1.0f;
+    for (auto const& b : boxes)
+    {
+      float const t = vml_test::ray_box_entry(b, origin, direction, 100.0f);
+      if (t >= 0.0f && (expected < 0.0f || t < expected))
+        expected = t;
+    }
+
+    tree.raycast(origin, direction, 100.0f, [&](std::uint32_t, float) { full_visits++; });
+    float nearest = -1.0f;
+    tree.raycast(origin, direction, 100.0f,
+                 [&](std::uint32_t, float t)
+                 {
+                   nearest_visits++;
+                   if (nearest < 0.0f || t < nearest)
+                     nearest = t;
+                   return nearest;
+                 });
+    CHECK(nearest == Approx(expected).margin(1e-4f));
+  }
+  // Returning the nearest hit so far shortens the ray, the layers behind the first are skipped
+  CHECK(nearest_visits * 4 < full_visits);
+}
+} // namespace
+
+TEST_CASE("Validate bvh queries", "[bvh]")
+{
+  std::vector<vml::aabb_t> boxes = bvh_test_boxes(1000);
+
+  vml::bvh4 tree4;
+  tree4.build(boxes);
+  bvh_test_queries(tree4, boxes);
+
+  vml::bvh8 tree8;
+  tree8.build(boxes);
+  bvh_test_queries(tree8, boxes);
+  CHECK(tree8.node_count() < tree4.node_count());
+
+  vml::aabb_t all = tree4.bounds();
+  for (auto const& b : boxes)
+  {
+    CHECK(!vml::vec3a::lesser_any(b.r[0], all.r[0]));
+    CHECK(!vml::vec3a::greater_any(b.r[1], all.r[1]));
+  }
+
+  // Small inputs end up in a single leaf
+  vml::bvh4 small;
+  small.build(std::span<vml::aabb_t const>(boxes.data(), 3));
+  CHECK(small.node_count() == 1);
+  CHECK(bvh_test_collect(small, tree4.bounds()) == std::vector<std::uint32_t>{0, 1, 2});
+
+  small.build(std::span<vml::aabb_t const>());
+  CHECK(small.empty());
+  CHECK(bvh_test_collect(small, tree4.bounds()).empty());
+}
+
+TEST_CASE("Validate bvh parallel build", "[bvh]")
+{
+  std::vector<vml::aabb_t> boxes = bvh_test_boxes(vml::bvh::k_parallel_build_size + 1000);
+
+  std::uint32_t tasks = 0;
+  vml::bvh      tree;
+  tree.build(boxes,
+             [&tasks](std::uint32_t task_count, auto const& task)
+             {
+               tasks = std::max(tasks, task_count);
+               std::vector<std::thread> threads;
+               for (std::uint32_t t = 0; t < task_count; ++t)
+                 threads.emplace_back(task, t);
+               for (auto& t : threads)
+                 t.join();
+             });
+  CHECK(tasks == vml::bvh::width);
+  bvh_test_queries(tree, boxes);
+
+  std::vector<vml::bounding_volume_t> vols;
+  for (auto const& b : boxes)
+    vols.push_back(vml::bounding_volume::from_box(vml::aabb::center(b), vml::aabb::half_size(b)));
+  vml::bvh from_vols;
+  from_vols.build(vols);
+  CHECK(from_vols.node_count() == tree.node_count());
+}
+
+TEST_CASE("Validate bvh overlapping boxes", "[bvh]")
+{
+  // Boxes all overlap, so no SAH split beats a leaf and ranges split at the median center. The box
+  // ranked last is far from the others, SAH alone would put it in a leaf of its own.
+  std::vector<vml::aabb_t>   boxes(64);
+  std::vector<std::uint32_t> rank(boxes.size());
+  for (std::uint32_t i = 0; i < boxes.size(); ++i)
+  {
+    rank[i]       = (i * 37) % 64;
+    float const x = rank[i] == 63 ? 1.0f : static_cast<float>(rank[i]) * 1e-3f;
+    boxes[i]      = vml::aabb::set(vml::vec3a::set(x, 0.0f, 0.0f), vml::vec3a::set(100.0f));
+  }
+  bvh_test_median_leaves<vml::bvh4>(boxes, rank);
+  bvh_test_median_leaves<vml::bvh8>(boxes, rank);
+}
+
+TEST_CASE("Validate bvh linear build", "[bvh]")
+{
+  std::vector<vml::aabb_t> boxes = bvh_test_boxes(1000);
+
+  vml::bvh4 tree4;
+  tree4.build_linear(boxes);
+  bvh_test_queries(tree4, boxes);
+
+  vml::bvh8 tree8;
+  tree8.build_linear<std::uint64_t>(boxes);
+  bvh_test_queries(tree8, boxes);
+
+  // Equal codes split at the middle of the range
+  std::vector<vml::aabb_t> same(100, boxes[0]);
+  tree4.build_linear(same);
+  CHECK(bvh_test_collect(tree4, boxes[0]).size() == same.size());
+
+  std::vector<vml::aabb_t> many = bvh_test_boxes(vml::bvh::k_parallel_build_size * 3 + 100);
+  vml::bvh                 serial;
+  serial.build_linear(many);
+  bvh_test_queries(serial, many);
+
+  std::vector<vml::bounding_volume_t> vols;
+  for (auto const& b : many)
+    vols.push_back(vml::bounding_volume::from_box(vml::aabb::center(b), vml::aabb::half_size(b)));
+  vml::bvh parallel;
+  parallel.build_linear<std::uint64_t>(vols,
+                                       [](std::uint32_t task_count, auto const& task)
+                                       {
+                                         std::vector<std::thread> threads;
+                                         for (std::uint32_t t = 0; t < task_count; ++t)
+                                           threads.emplace_back(task, t);
+                                         for (auto& t : threads)
+                                           t.join();
+                                       });
+  bvh_test_queries(parallel, many);
+}
+
+TEST_CASE("Validate bvh nearest raycast", "[bvh]")
+{
+  // Layers of boxes along x, rays along x hit one box per layer
+  std::vector<vml::aabb_t> boxes;
+  for (std::uint32_t x = 0; x < 32; ++x)
+  {
+    for (std::uint32_t y = 0; y < 16; ++y)
+    {
+      for (std::uint32_t z = 0; z < 16; ++z)
+      {
+        vml::vec3a_t const c = vml::vec3a::set(x * 2.0f, static_cast<float>(y), static_cast<float>(z));
+        boxes.push_back(vml::aabb::set(c, vml::vec3a::set(0.5f)));
+      }
+    }
+  }
+  bvh_test_nearest<vml::bvh4>(boxes);
+  bvh_test_nearest<vml::bvh8>(boxes);
+}
@@ -0,0 +1,176 @@
+#include "test_common.hpp"
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <utility>
+#include <vector>
+#include <vml.hpp>
+
+namespace
+{
+vml::aabb_t dyn_tree_box(vml_test::rng& rng)
+{
+  vml::vec3a_t c = vml::vec3a::set(rng.next() * 100.0f, rng.next() * 100.0f, rng.next() * 100.0f);
+  vml::vec3a_t e = vml::vec3a::set(rng.next() * 2.0f + 0.5f, rng.next() * 2.0f + 0.5f, rng.next() * 2.0f + 0.5f);
+  return vml::aabb::set(c, e);
+}
+
+bool dyn_tree_overlap(vml::aabb_t const& a, vml::aabb_t const& b)
+{
+  return !vml::vec3a::greater_any(a.r[0], b.r[1]) && !vml::vec3a::greater_any(b.r[0], a.r[1]);
+}
+
+bool dyn_tree_inside(vml::aabb_t const& inner, vml::aabb_t const& outer)
+{
+  return !vml::vec3a::lesser_any(inner.r[0], outer.r[0]) && !vml::vec3a::greater_any(inner.r[1], outer.r[1]);
+}
+
+vml::aabb_t dyn_tree_shift(vml::aabb_t const& box, vml::vec3a_t const& d)
+{
+  return vml::aabb::set_min_max(vml::vec3a::add(box.r[0], d), vml::vec3a::add(box.r[1], d));
+}
+
+//! Compare queries with brute force tests over the fat boxes of live proxies
+void dyn_tree_check(vml::dynamic_aabb_tree const& tree, std::vector<std::uint32_t> const& proxies,
+                    std::vector<vml::aabb_t> const& boxes)
+{
+  REQUIRE(tree.size() == proxies.size());
+  for (std::size_t i = 0; i < proxies.size(); ++i)
+    CHECK(dyn_tree_inside(boxes[i], tree.fat_bounds(proxies[i])));
+
+  vml::aabb_t                query = vml::aabb::set(vml::vec3a::set(40.0f, 50.0f, 60.0f), vml::vec3a::set(20.0f));
+  std::vector<std::uint32_t> expected;
+  for (std::uint32_t p : proxies)
+  {
+    if (dyn_tree_overlap(tree.fat_bounds(p), query))
+      expected.push_back(p);
+  }
+  std::vector<std::uint32_t> found;
+  tree.query(query,
+             [&found](std::uint32_t p)
+             {
+               found.push_back(p);
+             });
+  std::sort(expected.begin(), expected.end());
+  std::sort(found.begin(), found.end());
+  CHECK(!expected.empty());
+  CHECK(found == expected);
+
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> expected_pairs;
+  for (std::size_t i = 0; i < proxies.size(); ++i)
+  {
+    for (std::size_t j = i + 1; j < proxies.size(); ++j)
+    {
+      if (dyn_tree_overlap(tree.fat_bounds(proxies[i]), tree.fat_bounds(proxies[j])))
+        expected_pairs.emplace_back(std::min(proxies[i], proxies[j]), std::max(proxies[i], proxies[j]));
+    }
+  }
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> found_pairs;
+  tree.query_pairs(
+    [&found_pairs](std::uint32_t a, std::uint32_t b)
+    {
+      CHECK(a < b);
+      found_pairs.emplace_back(a, b);
+    });
+  std::sort(expected_pairs.begin(), expected_pairs.end());
+  std::sort(found_pairs.begin(), found_pairs.end());
+  CHECK(!expected_pairs.empty());
+  CHECK(found_pairs == expected_pairs);
+}
+} // namespace
+
+TEST_CASE("Validate dynamic_aabb_tree", "[dynamic_aabb_tree]")
+{
+  vml_test::rng              rng{11};
+  vml::dynamic_aabb_tree     tree(0.2f);
+  std::vector<std::uint32_t> proxies;
+  std::vector<vml::aabb_t>   boxes;
+  for (std::uint32_t i = 0; i < 1000; ++i)
+  {
+    boxes.push_back(dyn_tree_box(rng));
+    proxies.push_back(tree.insert(boxes.back()));
+  }
+  dyn_tree_check(tree, proxies, boxes);
+  // Rotations keep the tree close to log2(1000) deep
+  CHECK(tree.height() <= 20);
+  CHECK(dyn_tree_inside(boxes[0], tree.bounds()));
+
+  // Moves within the margin do not touch the tree
+  vml::aabb_t const moved = dyn_tree_shift(boxes[0], vml::vec3a::set(0.1f, 0.0f, -0.1f));
+  CHECK(!tree.move(proxies[0], moved, vml::vec3a::zero()));
+  boxes[0] = moved;
+
+  // Larger moves reinsert, the fat box extends along the displacement
+  for (std::size_t i = 0; i < proxies.size(); i += 3)
+  {
+    vml::vec3a_t const d = vml::vec3a::set(rng.next() * 10.0f - 5.0f, rng.next() * 10.0f - 5.0f, 3.0f);
+    boxes[i]             = dyn_tree_shift(boxes[i], d);
+    CHECK(tree.move(proxies[i], boxes[i], d));
+    CHECK(dyn_tree_inside(dyn_tree_shift(boxes[i], d), tree.fat_bounds(proxies[i])));
+  }
+  dyn_tree_check(tree, proxies, boxes);
+
+  // Erase every other proxy, then insert into the freed nodes
+  std::vector<std::uint32_t> kept_proxies;
+  std::vector<vml::aabb_t>   kept_boxes;
+  for (std::size_t i = 0; i < proxies.size(); ++i)
+  {
+    if (i % 2)
+    {
+      tree.erase(proxies[i]);
+      CHECK(!tree.contains(proxies[i]));
+    }
+    else
+    {
+      kept_proxies.push_back(proxies[i]);
+      kept_boxes.push_back(boxes[i]);
+    }
+  }
+  dyn_tree_check(tree, kept_proxies, kept_boxes);
+  CHECK(tree.height() <= 18);
+
+  kept_boxes.push_back(dyn_tree_box(rng));
+  kept_proxies.push_back(tree.insert(kept_boxes.back()));
+  CHECK(tree.contains(kept_proxies.back()));
+  dyn_tree_check(tree, kept_proxies, kept_boxes);
+
+  for (std::uint32_t p : kept_proxies)
+    tree.erase(p);
+  CHECK(tree.size() == 0);
+  CHECK(tree.height() == 0);
+  tree.query(tree.bounds(),
+             [](std::uint32_t)
+             {
+               FAIL("empty tree reported a proxy");
+             });
+}
+
+TEST_CASE("Benchmark dynamic_aabb_tree pairs", "[.benchmark][dynamic_aabb_tree]")
+{
+  vml_test::rng              rng{11};
+  vml::dynamic_aabb_tree     tree(0.2f);
+  std::vector<std::uint32_t> proxies;
+  for (std::uint32_t i = 0; i < 4000; ++i)
+    proxies.push_back(tree.insert(dyn_tree_box(rng)));
+
+  BENCHMARK("dynamic_aabb_tree::query_pairs")
+  {
+    std::uint32_t pairs = 0;
+    tree.query_pairs(
+      [&pairs](std::uint32_t, std::uint32_t)
+      {
+        pairs++;
+      });
+    return pairs;
+  };
+
+  BENCHMARK("brute force pairs")
+  {
+    std::uint32_t pairs = 0;
+    for (std::size_t i = 0; i < proxies.size(); ++i)
+    {
+      for (std::size_t j = i + 1; j < proxies.size(); ++j)
+        pairs += dyn_tree_overlap(tree.fat_bounds(proxies[i]), tree.fat_bounds(proxies[j]));
+    }
+    return pairs;
+  };
+}
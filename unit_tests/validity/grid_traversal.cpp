@@ -0,0 +1,222 @@
+#include "test_common.hpp"
+#include <catch2/catch.hpp>
+#include <vector>
+#include <vml.hpp>
+
+namespace
+{
+struct grid_traversal_test_step
+{
+  vml::ivec3_t cell;
+  float        enter;
+  float        exit;
+};
+
+std::vector<grid_traversal_test_step> grid_traversal_test_walk(vml::voxel_grid_t const& grid, vml::ray_t const& r,
+                                                               float t_max)
+{
+  std::vector<grid_traversal_test_step> steps;
+  for (vml::grid_traversal it(grid, r, t_max); it.valid(); it.next())
+    steps.push_back({it.cell(), it.enter(), it.exit()});
+  return steps;
+}
+
+vml::aabb_t grid_traversal_test_box(vml::voxel_grid_t const& grid, vml::ivec3_t const& c)
+{
+  vml::vec3a_t const lo = vml::vec3a::add(
+    grid.origin, vml::vec3a::mul(vml::vec3a::set(static_cast<float>(c[0]), static_cast<float>(c[1]),
+                                                 static_cast<float>(c[2])),
+                                 grid.cell_size));
+  return vml::aabb::set_min_max(lo, vml::vec3a::add(lo, vml::vec3a::set(grid.cell_size)));
+}
+
+template <typename lane>
+void grid_traversal_test_lockstep(vml::voxel_grid_t const& grid, vml_test::rng& rng)
+{
+  constexpr std::uint32_t n = lane::element_count;
+  vml::ray_t              rays[n];
+  for (vml::ray_t& r : rays)
+    r = vml::ray::from_points(rng.point(40.0f), rng.point(10.0f));
+  // One ray misses the grid
+  rays[1] = vml::ray::set(vml::vec3a::set(100.0f, 100.0f, 100.0f), vml::vec3a::set(1.0f, 0.0f, 0.0f));
+
+  std::vector<grid_traversal_test_step> expected[n];
+  for (std::uint32_t k = 0; k < n; ++k)
+    expected[k] = grid_traversal_test_walk(grid, rays[k], 3.0f);
+
+  vml::grid_traversaln<lane> it(grid, rays, 3.0f);
+  for (std::uint32_t s = 0; it.active(); ++s, it.next())
+  {
+    for (std::uint32_t k = 0; k < n; ++k)
+    {
+      CHECK(((it.active() >> k) & 1) == (s < expected[k].size() ? 1u : 0u));
+      if (!((it.active() >> k) & 1))
+        continue;
+      CHECK(it.cell(k) == expected[k][s].cell);
+      CHECK(lane::get(it.enter(), k) == Approx(expected[k][s].enter));
+      CHECK(lane::get(it.exit(), k) == Approx(expected[k][s].exit));
+    }
+    // Stopped rays stay stopped
+    if (s == 3)
+    {
+      it.stop(1);
+      expected[0].resize(std::min<std::size_t>(expected[0].size(), 4));
+    }
+  }
+}
+} // namespace
+
+TEST_CASE("Validate grid_traversal", "[grid_traversal]")
+{
+  vml::voxel_grid_t const grid = {vml::vec3a::set(-8.0f, -4.0f, -6.0f), 0.5f, {32, 16, 24}};
+  vml::aabb_t const       bounds =
+    vml::aabb::set_min_max(grid.origin, vml::vec3a::add(grid.origin, vml::vec3a::set(16.0f, 8.0f, 12.0f)));
+
+  // Along +x through the middle of row (y 3, z 5)
+  vml::ray_t const row = vml::ray::set(vml::vec3a::set(-10.0f, -2.25f, -3.25f), vml::vec3a::set(2.0f, 0.0f, 0.0f));
+  auto const       steps = grid_traversal_test_walk(grid, row, 100.0f);
+  REQUIRE(steps.size() == 32);
+  for (std::uint32_t i = 0; i < steps.size(); ++i)
+  {
+    CHECK(steps[i].cell == vml::ivec3_t{static_cast<int>(i), 3, 5});
+    CHECK(steps[i].enter == Approx(1.0f + i * 0.25f));
+    CHECK(steps[i].exit == Approx(1.25f + i * 0.25f));
+  }
+  // t_max ends the walk inside the grid
+  CHECK(grid_traversal_test_walk(grid, row, 2.1f).size() == 5);
+  // Parallel to x outside the grid
+  CHECK(grid_traversal_test_walk(grid, vml::ray::set(vml::vec3a::set(-10.0f, 5.0f, 0.0f),
+                                                     vml::vec3a::set(1.0f, 0.0f, 0.0f)),
+                                 100.0f)
+          .empty());
+
+  vml_test::rng rng{53};
+  for (std::uint32_t q = 0; q < 200; ++q)
+  {
+    // From inside and outside the grid, some ending inside it
+    vml::ray_t const r     = vml::ray::from_points(rng.point(q % 2 ? 10.0f : 40.0f), rng.point(10.0f));
+    float const      t_max = q % 3 ? 4.0f : 0.5f;
+    auto const       walk  = grid_traversal_test_walk(grid, r, t_max);
+    float const      t     = vml::ray::intersect_box(r, bounds, t_max);
+    CHECK(walk.empty() == (t < 0.0f));
+    if (walk.empty())
+      continue;
+    CHECK(walk.front().enter == Approx(t).margin(1e-5f));
+    for (std::uint32_t i = 0; i < walk.size(); ++i)
+    {
+      // The middle of each step lies in its cell
+      vml::aabb_t const  box = grid_traversal_test_box(grid, walk[i].cell);
+      vml::vec3a_t const mid = vml::ray::at(r, (walk[i].enter + walk[i].exit) * 0.5f);
+      CHECK(!vml::vec3a::lesser_any(mid, vml::vec3a::sub(box.r[0], vml::vec3a::set(1e-3f))));
+      CHECK(!vml::vec3a::greater_any(mid, vml::vec3a::add(box.r[1], vml::vec3a::set(1e-3f))));
+      CHECK(walk[i].enter <= walk[i].exit);
+      if (i == 0)
+        continue;
+      // Steps go to a face neighbour and are contiguous
+      int const moved = std::abs(walk[i].cell[0] - walk[i - 1].cell[0]) +
+                        std::abs(walk[i].cell[1] - walk[i - 1].cell[1]) +
+                        std::abs(walk[i].cell[2] - walk[i - 1].cell[2]);
+      CHECK(moved == 1);
+      CHECK(walk[i].enter == Approx(walk[i - 1].exit));
+    }
+  }
+
+  for (std::uint32_t q = 0; q < 40; ++q)
+  {
+    grid_traversal_test_lockstep<vml::quad>(grid, rng);
+    grid_traversal_test_lockstep<vml::quad8>(grid, rng);
+  }
+}
+
+TEST_CASE("Validate occupancy_mip", "[grid_traversal]")
+{
+  vml::voxel_grid_t const   grid = {vml::vec3a::set(-8.0f, -4.0f, -6.0f), 0.5f, {32, 16, 24}};
+  vml_test::rng             rng{53};
+  std::vector<std::uint8_t> occupied(32 * 16 * 24, 0);
+  for (auto& o : occupied)
+    o = rng.next() < 0.01f;
+  // A dense blob so some rays stop early
+  for (int z = 10; z < 14; ++z)
+  {
+    for (int y = 6; y < 10; ++y)
+    {
+      for (int x = 14; x < 18; ++x)
+        occupied[(z * 16 + y) * 32 + x] = 1;
+    }
+  }
+
+  vml::occupancy_mip mip;
+  mip.build(grid.dims, occupied);
+  CHECK(mip.level_count() == 6);
+  CHECK(mip.occupied(5, {0, 0, 0}));
+  CHECK(mip.occupied(2, {3, 1, 2}));
+
+  std::uint32_t visited = 0;
+  for (std::uint32_t q = 0; q < 300; ++q)
+  {
+    vml::ray_t const r = vml::ray::from_points(rng.point(40.0f), rng.point(q % 2 ? 4.0f : 12.0f));
+    std::vector<grid_traversal_test_step> expected;
+    for (auto const& s : grid_traversal_test_walk(grid, r, 3.0f))
+    {
+      if (mip.occupied(0, s.cell))
+        expected.push_back(s);
+    }
+
+    std::vector<grid_traversal_test_step> found;
+    bool const                            stopped =
+      mip.raymarch(grid, r, 3.0f,
+                   [&](vml::ivec3_t const& c, float enter, float exit)
+                   {
+                     found.push_back({c, enter, exit});
+                     return q % 3 == 0;
+                   });
+    CHECK(stopped == (q % 3 == 0 && !expected.empty()));
+    if (stopped)
+      expected.resize(1);
+    REQUIRE(found.size() == expected.size());
+    for (std::uint32_t i = 0; i < found.size(); ++i)
+    {
+      CHECK(found[i].cell == expected[i].cell);
+      CHECK(found[i].enter == Approx(expected[i].enter).margin(1e-5f));
+      CHECK(found[i].exit == Approx(expected[i].exit).margin(1e-5f));
+    }
+    visited += static_cast<std::uint32_t>(found.size());
+  }
+  CHECK(visited > 0);
+}
+
+TEST_CASE("Validate occupancy_mip skip through a grid edge", "[grid_traversal]")
+{
+  // Level 2 blocks of a 5x5x5 grid reach past its far faces
+  vml::voxel_grid_t const   grid = {vml::vec3a::set(-1.3f, 0.7f, 0.1f), 0.37f, {5, 5, 5}};
+  vml_test::rng             rng{59};
+  std::vector<std::uint8_t> occupied(5 * 5 * 5, 0);
+  occupied[(4 * 5 + 0) * 5 + 0] = 1;
+  vml::occupancy_mip mip;
+  mip.build(grid.dims, occupied);
+
+  auto const in_grid = [&grid](vml::ivec3_t const& c)
+  { return c[0] >= 0 && c[1] >= 0 && c[2] >= 0 && c[0] < grid.dims[0] && c[1] < grid.dims[1] && c[2] < grid.dims[2]; };
+  for (std::uint32_t q = 0; q < 2000; ++q)
+  {
+    // From cell (3, 4, z) of the empty block x in [0, 3], y in [4, 7] to near the edge x = 4, y = 5
+    float const ox = 3.0f + rng.next();
+    float const oy = 4.0f + rng.next();
+    float const oz = 5.0f * rng.next();
+    float const t  = 0.1f + rng.next();
+    vml::vec3a_t const origin =
+      vml::vec3a::add(grid.origin, vml::vec3a::mul(vml::vec3a::set(ox, oy, oz), grid.cell_size));
+    vml::vec3a_t const direction =
+      vml::vec3a::mul(vml::vec3a::set((4.0f - ox) / t, (5.0f - oy) / t, rng.next() - 0.5f), grid.cell_size);
+
+    vml::grid_traversal it(grid, origin, direction, 100.0f);
+    REQUIRE(it.valid());
+    it.skip(2);
+    if (it.valid())
+      CHECK(in_grid(it.cell()));
+
+    bool const hit = mip.raymarch(grid, vml::ray::set(origin, direction), 100.0f,
+                                  [](vml::ivec3_t const&, float, float) { return true; });
+    CHECK(!hit);
+  }
+}
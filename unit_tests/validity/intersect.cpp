@@ -1,21 +1,22 @@
 #include <catch2/catch.hpp>
 #include <cstring>
+#include <vector>
 #include <vml.hpp>
 
 TEST_CASE("Validate intersect::bounding_volume_frustum_coherent", "[intersect::bounding_volume_frustum_coherent]")
 {
   // define a custom prism
-  vml::mat4_t                 m = vml::mat4::from_orthographic_projection(-50.0f, 50.0f, -45.0f, 45.0f, 1.0f, 1000.0f);
-  vml::frustum_t              frustum_orig = vml::frustum::from_mat4_transpose(vml::mat4::transpose(m));
-  auto                        planes       = vml::frustum::get_planes(frustum_orig);
-  std::array<vml::plane_t, 8> custom_planes;
-  std::memcpy(custom_planes.data(), planes.first, planes.second * sizeof(vml::plane_t));
+  vml::mat4_t    m            = vml::mat4::from_orthographic_projection(-50.0f, 50.0f, -45.0f, 45.0f, 1.0f, 1000.0f);
+  vml::frustum_t frustum_orig = vml::frustum::from_mat4_transpose(vml::mat4::transpose(m));
+  auto           planes       = vml::frustum::get_planes(frustum_orig);
+  vml::plane_t   custom_planes[8];
+  std::memcpy(custom_planes, planes.first, planes.second * sizeof(vml::plane_t));
   custom_planes[6] = vml::plane::set(vml::frustum::get_plane(frustum_orig, vml::frustum::plane_type::k_far), 900.0f);
 
   custom_planes[7] = vml::plane::set(vml::frustum::get_plane(frustum_orig, vml::frustum::plane_type::k_near), -10.0f);
 
-  vml::frustum_t custom = vml::frustum::from_planes(nullptr, static_cast<std::uint32_t>(custom_planes.size()));
-  vml::frustum_t unused = vml::frustum::from_planes(custom_planes.data(), 6);
+  vml::frustum_t custom = vml::frustum::from_planes(nullptr, static_cast<std::uint32_t>(std::size(custom_planes)));
+  vml::frustum_t unused = vml::frustum::from_planes(custom_planes, 6);
 
   vml::frustum_t unused_copy(unused);
   CHECK(vml::frustum::count(unused_copy) == 6);
@@ -59,16 +60,16 @@ TEST_CASE("Validate intersect::bounding_volume_frustum_coherent", "[intersect::b
 TEST_CASE("Validate intersect::bounding_volume_frustum", "[intersect::bounding_volume_frustum]")
 {
   // define a custom prism
-  vml::mat4_t                 m = vml::mat4::from_orthographic_projection(-50.0f, 50.0f, -45.0f, 45.0f, 1.0f, 1000.0f);
-  vml::frustum_t              frustum_orig = vml::frustum::from_mat4_transpose(vml::mat4::transpose(m));
-  auto                        planes       = vml::frustum::get_planes(frustum_orig);
-  std::array<vml::plane_t, 8> custom_planes;
-  std::memcpy(custom_planes.data(), planes.first, planes.second * sizeof(vml::plane_t));
+  vml::mat4_t    m            = vml::mat4::from_orthographic_projection(-50.0f, 50.0f, -45.0f, 45.0f, 1.0f, 1000.0f);
+  vml::frustum_t frustum_orig = vml::frustum::from_mat4_transpose(vml::mat4::transpose(m));
+  auto           planes       = vml::frustum::get_planes(frustum_orig);
+  vml::plane_t   custom_planes[8];
+  std::memcpy(custom_planes, planes.first, planes.second * sizeof(vml::plane_t));
   custom_planes[6] = vml::plane::set(vml::frustum::get_plane(frustum_orig, vml::frustum::plane_type::k_far), 900.0f);
   custom_planes[7] = vml::plane::set(vml::frustum::get_plane(frustum_orig, vml::frustum::plane_type::k_near), -10.0f);
 
   vml::frustum_t custom =
-    vml::frustum::from_planes(custom_planes.data(), static_cast<std::uint32_t>(custom_planes.size()));
+    vml::frustum::from_planes(custom_planes, static_cast<std::uint32_t>(std::size(custom_planes)));
 
   vml::bounding_volume_t vol = vml::bounding_volume::from_box(vml::vec3a::set(5, 5, 5), vml::vec3a::set(2, 2, 2));
 
@@ -96,16 +97,16 @@ TEST_CASE("Validate intersect::bounding_volumes", "[intersect::bounding_volumes]
 TEST_CASE("Validate intersect::bounding_sphere_frustum", "[intersect::bounding_sphere_frustum]")
 {
   // define a custom prism
-  vml::mat4_t                 m = vml::mat4::from_orthographic_projection(-50.0f, 50.0f, -45.0f, 45.0f, 1.0f, 1000.0f);
-  vml::frustum_t              frustum_orig = vml::frustum::from_mat4_transpose(vml::mat4::transpose(m));
-  auto                        planes       = vml::frustum::get_planes(frustum_orig);
-  std::array<vml::plane_t, 8> custom_planes;
-  std::memcpy(custom_planes.data(), planes.first, planes.second * sizeof(vml::plane_t));
+  vml::mat4_t    m            = vml::mat4::from_orthographic_projection(-50.0f, 50.0f, -45.0f, 45.0f, 1.0f, 1000.0f);
+  vml::frustum_t frustum_orig = vml::frustum::from_mat4_transpose(vml::mat4::transpose(m));
+  auto           planes       = vml::frustum::get_planes(frustum_orig);
+  vml::plane_t   custom_planes[8];
+  std::memcpy(custom_planes, planes.first, planes.second * sizeof(vml::plane_t));
   custom_planes[6] = vml::plane::set(vml::frustum::get_plane(frustum_orig, vml::frustum::plane_type::k_far), 900.0f);
   custom_planes[7] = vml::plane::set(vml::frustum::get_plane(frustum_orig, vml::frustum::plane_type::k_near), -10.0f);
 
   vml::frustum_t custom =
-    vml::frustum::from_planes(custom_planes.data(), static_cast<std::uint32_t>(custom_planes.size()));
+    vml::frustum::from_planes(custom_planes, static_cast<std::uint32_t>(std::size(custom_planes)));
 
   vml::sphere_t vol = vml::sphere::set(vml::vec3a::set(5, 5, 5), 2);
 
@@ -116,3 +117,91 @@ TEST_CASE("Validate intersect::bounding_sphere_frustum", "[intersect::bounding_s
 
   CHECK(vml::intersect::bounding_sphere_frustum(vol, custom) == vml::intersect::result_t::k_intersecting);
 }
+
+TEST_CASE("Validate intersect::bounding_volumes_frustum", "[intersect::bounding_volumes_frustum]")
+{
+  vml::mat4_t    m       = vml::mat4::from_orthographic_projection(-50.0f, 50.0f, -45.0f, 45.0f, 1.0f, 1000.0f);
+  vml::frustum_t frustum = vml::frustum::from_mat4_transpose(vml::mat4::transpose(m));
+
+  std::vector<vml::bounding_volume_t> vols;
+  for (int i = 0; i < 37; ++i)
+  {
+    float offset = static_cast<float>(i) * 4.0f - 70.0f;
+    vols.push_back(vml::bounding_volume::from_box(vml::vec3a::set(offset, 5.0f, 100.0f + offset),
+                                                  vml::vec3a::set(static_cast<float>(i % 3) + 1.0f)));
+  }
+
+  std::array<std::uint32_t, 3> codes;
+  std::array<std::uint32_t, 2> visible;
+  codes.fill(0xffffffff);
+  visible.fill(0xffffffff);
+  vml::intersect::bounding_volumes_frustum(vols, frustum, codes);
+  vml::intersect::bounding_volumes_frustum_visibility(vols, frustum, visible);
+
+  std::uint32_t counts[3] = {};
+  for (std::uint32_t i = 0; i < vols.size(); ++i)
+  {
+    vml::frustum::coherency state    = vml::frustum::default_coherency(vml::frustum::count(frustum));
+    auto                    expected = vml::intersect::bounding_volume_frustum_coherent(vols[i], frustum, state);
+    auto                    result   = static_cast<vml::intersect::result_t>((codes[i / 16] >> ((i % 16) * 2)) & 3);
+    CHECK(result == expected);
+    CHECK(((visible[i / 32] >> (i % 32)) & 1) == (expected != vml::intersect::result_t::k_outside));
+    counts[static_cast<std::uint32_t>(expected)]++;
+  }
+  CHECK(counts[0] > 0);
+  CHECK(counts[1] > 0);
+  CHECK(counts[2] > 0);
+  CHECK((codes[2] >> 10) == 0);
+  CHECK((visible[1] >> 5) == 0);
+}
+
+TEST_CASE("Validate intersect::bounding_volumes_frustum split", "[intersect::bounding_volumes_frustum split]")
+{
+  vml::mat4_t    m       = vml::mat4::from_orthographic_projection(-50.0f, 50.0f, -45.0f, 45.0f, 1.0f, 1000.0f);
+  vml::frustum_t frustum = vml::frustum::from_mat4_transpose(vml::mat4::transpose(m));
+
+  std::vector<vml::bounding_volume_t> vols;
+  std::vector<vml::transform_t>       tf;
+  for (int i = 0; i < 37; ++i)
+  {
+    float offset = static_cast<float>(i) * 4.0f - 70.0f;
+    vols.push_back(
+      vml::bounding_volume::from_box(vml::vec3a::set(0.0f), vml::vec3a::set(static_cast<float>(i % 3) + 1.0f)));
+    vml::transform_t t = vml::transform::identity();
+    vml::transform::set_rotation(t, vml::quat::from_axis_angle(vml::vec3::set(0.0f, 0.0f, 1.0f),
+                                                               vml::to_radians(static_cast<float>(i) * 10.0f)));
+    vml::transform::set_translation(t, vml::vec3a::set(offset, 5.0f, 100.0f + offset));
+    tf.push_back(t);
+  }
+
+  std::vector<vml::sphere_box_t> world(vols.size());
+  std::vector<vml::sphere_box_t> local(vols.size());
+  vml::bounding_volume::split(vols, world, local);
+  vml::bounding_volume::update(vols, tf);
+  vml::bounding_volume::update(world, local, tf);
+
+  std::vector<vml::bounding_volume_t> joined(vols.size());
+  vml::bounding_volume::join(world, local, joined);
+  for (std::uint32_t i = 0; i < vols.size(); ++i)
+  {
+    for (std::uint32_t j = 0; j < 4; ++j)
+    {
+      CHECK(joined[i].spherical_vol[j] == Approx(vols[i].spherical_vol[j]));
+      CHECK(joined[i].orig_spherical_vol[j] == vols[i].orig_spherical_vol[j]);
+    }
+    for (std::uint32_t j = 0; j < 3; ++j)
+      CHECK(joined[i].half_extends[j] == Approx(vols[i].half_extends[j]));
+  }
+
+  std::array<std::uint32_t, 3> expected_codes;
+  std::array<std::uint32_t, 2> expected_visible;
+  std::array<std::uint32_t, 3> codes;
+  std::array<std::uint32_t, 2> visible;
+  vml::intersect::bounding_volumes_frustum(vols, frustum, expected_codes);
+  vml::intersect::bounding_volumes_frustum_visibility(vols, frustum, expected_visible);
+  vml::intersect::bounding_volumes_frustum(world, frustum, codes);
+  vml::intersect::bounding_volumes_frustum_visibility(world, frustum, visible);
+  CHECK(codes == expected_codes);
+  CHECK(visible == expected_visible);
+  CHECK(expected_visible[0] != 0);
+}
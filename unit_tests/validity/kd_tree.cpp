@@ -0,0 +1,164 @@
+#include "test_common.hpp"
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <thread>
+#include <vector>
+#include <vml.hpp>
+
+namespace
+{
+vml_test::quad_vector kd_tree_test_points(std::uint32_t count)
+{
+  vml_test::rng         rng{5};
+  vml_test::quad_vector points(count);
+  for (auto& p : points)
+    p = vml::vec3a::set(rng.next() * 100.0f - 50.0f, rng.next() * 100.0f - 50.0f, rng.next() * 10.0f);
+  return points;
+}
+
+std::vector<std::uint32_t> kd_tree_test_nearest(vml_test::quad_vector const& points, vml::vec3a_t const& p,
+                                                std::uint32_t k)
+{
+  std::vector<std::uint32_t> order(points.size());
+  for (std::uint32_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+  std::sort(order.begin(), order.end(),
+            [&](std::uint32_t a, std::uint32_t b)
+            {
+              float const da = vml::vec3a::sqdistance(p, points[a]);
+              float const db = vml::vec3a::sqdistance(p, points[b]);
+              return da < db || (da == db && a < b);
+            });
+  order.resize(std::min<std::size_t>(k, order.size()));
+  return order;
+}
+
+template <typename tree_t>
+void kd_tree_test_check(tree_t const& tree, vml_test::quad_vector const& points)
+{
+  REQUIRE(tree.size() == points.size());
+  for (vml::vec3a_t const& b : points)
+  {
+    CHECK(!vml::vec3a::lesser_any(b, tree.bounds().r[0]));
+    CHECK(!vml::vec3a::greater_any(b, tree.bounds().r[1]));
+  }
+
+  for (vml::sphere_t const& s : {vml::sphere::set(vml::vec3a::set(3.0f, -7.5f, 5.0f), 6.0f),
+                                 vml::sphere::set(vml::vec3a::set(50.0f, 50.0f, 0.0f), 9.0f),
+                                 vml::sphere::set(vml::vec3a::zero(), 1000.0f)})
+  {
+    std::vector<std::uint32_t> expected;
+    float const                r = vml::sphere::radius(s);
+    for (std::uint32_t i = 0; i < points.size(); ++i)
+    {
+      if (vml::vec3a::sqdistance(vml::sphere::center(s), points[i]) <= r * r)
+        expected.push_back(i);
+    }
+    std::vector<std::uint32_t> found;
+    tree.query(s,
+               [&found](std::uint32_t i)
+               {
+                 found.push_back(i);
+               });
+    std::sort(found.begin(), found.end());
+    CHECK((points.size() < 100 || !expected.empty()));
+    CHECK(found == expected);
+  }
+
+  vml::vec3a_t const                point    = vml::vec3a::set(-3.5f, 7.25f, 2.0f);
+  std::vector<std::uint32_t> const expected = kd_tree_test_nearest(points, point, 12);
+  std::uint32_t                    nearest[12];
+  REQUIRE(tree.nearest(point, nearest) == expected.size());
+  CHECK(std::vector<std::uint32_t>(nearest, nearest + expected.size()) == expected);
+
+  // Queries on the points themselves, between them and outside the bounds
+  constexpr std::uint32_t k = 5;
+  vml_test::quad_vector   queries;
+  for (std::uint32_t i = 0; i < points.size(); i += 7)
+  {
+    queries.push_back(points[i]);
+    queries.push_back(vml::vec3a::add(points[i], vml::vec3a::set(0.3f, -0.2f, 0.1f)));
+  }
+  queries.push_back(vml::vec3a::set(500.0f, -400.0f, 30.0f));
+  std::vector<std::uint32_t> indices(queries.size() * k);
+  std::vector<std::uint32_t> counts(queries.size());
+  tree.nearest(queries, k, indices, counts);
+  for (std::uint32_t q = 0; q < queries.size(); ++q)
+  {
+    REQUIRE(counts[q] == std::min<std::size_t>(k, points.size()));
+    std::vector<std::uint32_t> const expected = kd_tree_test_nearest(points, queries[q], k);
+    for (std::uint32_t i = 0; i < counts[q]; ++i)
+    {
+      // Ties may come in any order, compare distances
+      CHECK(vml::vec3a::sqdistance(queries[q], points[indices[q * k + i]]) ==
+            vml::vec3a::sqdistance(queries[q], points[expected[i]]));
+    }
+  }
+}
+} // namespace
+
+TEST_CASE("Validate kd_tree queries", "[kd_tree]")
+{
+  vml_test::quad_vector points = kd_tree_test_points(3000);
+
+  vml::kd_tree4 tree4;
+  tree4.build(points);
+  kd_tree_test_check(tree4, points);
+  // 3000 points in leaves of 8 to 16
+  CHECK(tree4.height() == 8);
+
+  vml::kd_tree8 tree8;
+  tree8.build(points);
+  kd_tree_test_check(tree8, points);
+
+  // Duplicates straddle splits
+  vml_test::quad_vector same(100, points[0]);
+  same.push_back(points[1]);
+  tree4.build(same);
+  std::uint32_t nearest[101];
+  REQUIRE(tree4.nearest(points[0], nearest) == 101);
+  CHECK(nearest[100] == 100);
+
+  vml_test::quad_vector small(points.begin(), points.begin() + 3);
+  tree8.build(small);
+  CHECK(tree8.height() == 0);
+  kd_tree_test_check(tree8, vml_test::quad_vector(points.begin(), points.begin() + 3));
+
+  tree8.build(vml_test::quad_vector());
+  CHECK(tree8.empty());
+  CHECK(tree8.nearest(vml::vec3a::zero(), nearest) == 0);
+}
+
+TEST_CASE("Validate kd_tree parallel build", "[kd_tree]")
+{
+  vml_test::quad_vector points = kd_tree_test_points(vml::kd_tree::k_parallel_task_size * 2 + 500);
+
+  std::uint32_t tasks    = 0;
+  auto const    parallel = [&tasks](std::uint32_t task_count, auto const& task)
+  {
+    tasks = std::max(tasks, task_count);
+    std::vector<std::thread> threads;
+    for (std::uint32_t t = 0; t < task_count; ++t)
+      threads.emplace_back(task, t);
+    for (auto& t : threads)
+      t.join();
+  };
+  vml::kd_tree tree;
+  tree.build(points, parallel);
+  CHECK(tasks == 3);
+
+  vml::kd_tree serial;
+  serial.build(points);
+  vml_test::quad_vector      queries(points.begin(), points.begin() + 20000);
+  std::vector<std::uint32_t> indices(queries.size() * 3);
+  std::vector<std::uint32_t> counts(queries.size());
+  std::vector<std::uint32_t> serial_indices(queries.size() * 3);
+  std::vector<std::uint32_t> serial_counts(queries.size());
+  tree.nearest(queries, 3, indices, counts, parallel);
+  serial.nearest(queries, 3, serial_indices, serial_counts);
+  CHECK(counts == serial_counts);
+  CHECK(indices == serial_indices);
+  for (std::uint32_t q = 0; q < queries.size(); q += 97)
+    CHECK(vml::vec3a::sqdistance(queries[q], points[indices[q * 3 + 2]]) ==
+          vml::vec3a::sqdistance(queries[q], points[kd_tree_test_nearest(points, queries[q], 3)[2]]));
+}
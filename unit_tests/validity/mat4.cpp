@@ -1,5 +1,6 @@
 #include <catch2/catch.hpp>
 #include <cstring>
+#include <vector>
 #include <vml.hpp>
 
 TEST_CASE("Validate mat4::mul", "[mat4::mul]")
@@ -35,6 +36,55 @@ TEST_CASE("Validate mat4::mul", "[mat4::mul]")
   CHECK(vml::vec4::equals(vml::mat4::mul(vml::mat4::row(m1, 0), m2), vml::mat4::row(m1m2, 0)));
 }
 
+TEST_CASE("Validate mat4::mul batch", "[mat4::mul batch]")
+{
+  constexpr std::uint32_t  k_count = 13;
+  std::vector<vml::mat4_t> a(k_count);
+  std::vector<vml::mat4_t> b(k_count);
+  for (std::uint32_t i = 0; i < k_count; ++i)
+  {
+    float f = static_cast<float>(i);
+    a[i]    = vml::mat4::from_scale_rotation_translation(
+      1.0f + 0.1f * f, vml::quat::from_axis_angle(vml::vec3_t{0.0f, 1.0f, 0.0f}, vml::to_radians(7.0f * f)),
+      vml::vec3a::set(f, 2.0f, -f));
+    b[i] = vml::mat4::from_perspective_projection(0.5f + 0.05f * f, 1.5f, 1.0f, 100.0f + f);
+  }
+  vml::mat4_t view = vml::mat4::from_look_at(vml::vec3a::set(0.0f, 5.0f, -10.0f), vml::vec3a::set(0.0f),
+                                             vml::vec3a::set(0.0f, 1.0f, 0.0f));
+
+  auto check = [](vml::mat4_t const& r, vml::mat4_t const& expected)
+  {
+    for (std::uint32_t j = 0; j < 16; ++j)
+      CHECK(r.m[j] == Approx(expected.m[j]).margin(1e-5f));
+  };
+
+  for (bool non_temporal : {false, true})
+  {
+    std::vector<vml::mat4_t> broadcast(k_count);
+    std::vector<vml::mat4_t> mirror(k_count);
+    std::vector<vml::mat4_t> element(k_count);
+    vml::mat4::mul(view, a, broadcast, non_temporal);
+    vml::mat4::mul(a, view, mirror, non_temporal);
+    vml::mat4::mul(a, b, element, non_temporal);
+    for (std::uint32_t i = 0; i < k_count; ++i)
+    {
+      check(broadcast[i], vml::mat4::mul(view, a[i]));
+      check(mirror[i], vml::mat4::mul(a[i], view));
+      check(element[i], vml::mat4::mul(a[i], b[i]));
+    }
+  }
+
+  // in place
+  std::vector<vml::mat4_t> in_place = a;
+  vml::mat4::mul(in_place, b, in_place);
+  for (std::uint32_t i = 0; i < k_count; ++i)
+    check(in_place[i], vml::mat4::mul(a[i], b[i]));
+  in_place = b;
+  vml::mat4::mul(view, in_place, in_place);
+  for (std::uint32_t i = 0; i < k_count; ++i)
+    check(in_place[i], vml::mat4::mul(view, b[i]));
+}
+
 TEST_CASE("Validate mat4::transform_assume_ortho", "[mat4::transform_assume_ortho]")
 {
   vml::mat4_t m = {
@@ -111,6 +161,62 @@ TEST_CASE("Validate mat4::transform_and_project", "[mat4::transform_and_project]
                            vml::vec4::set(0.87012987013f, 1.12987012987f, 0.55194805194f, 1.0f)));
 }
 
+TEST_CASE("Validate mat4::transform_stream", "[mat4::transform_stream]")
+{
+  vml::mat4_t m = vml::mat4::from_scale_rotation_translation(
+    1.5f, vml::quat::from_axis_angle(vml::vec3_t{0.0f, 0.6f, 0.8f}, vml::to_radians(40.0f)),
+    vml::vec3a::set(1.0f, -3.0f, 20.0f));
+  vml::mat4_t proj = vml::mat4::mul(m, vml::mat4::from_perspective_projection(1.0f, 1.5f, 1.0f, 100.0f));
+
+  // packed and padded layouts, the padding must survive
+  struct padded
+  {
+    vml::vec3_t p;
+    float       guard[5];
+  };
+  constexpr std::uint32_t  k_count = 37;
+  std::vector<vml::vec3_t> packed(k_count);
+  std::vector<padded>      strided(k_count);
+  for (std::uint32_t i = 0; i < k_count; ++i)
+  {
+    float f    = static_cast<float>(i);
+    packed[i]  = {f - 10.0f, 0.5f * f, 30.0f + f};
+    strided[i] = {packed[i], {-1.0f, -2.0f, -3.0f, -4.0f, -5.0f}};
+  }
+
+  std::vector<vml::vec3_t> out_ortho(k_count);
+  std::vector<vml::vec3_t> out_project(k_count);
+  std::vector<padded>      out_strided = strided;
+  std::vector<padded>      in_place    = strided;
+  vml::mat4::transform_assume_ortho(m, packed.data(), sizeof(vml::vec3_t), k_count, out_ortho.data(),
+                                    sizeof(vml::vec3_t));
+  vml::mat4::transform_and_project(proj, packed.data(), sizeof(vml::vec3_t), k_count, out_project.data(),
+                                   sizeof(vml::vec3_t));
+  vml::mat4::transform_and_project(proj, &strided[0].p, sizeof(padded), k_count, &out_strided[0].p, sizeof(padded));
+  vml::mat4::transform_assume_ortho(m, &in_place[0].p, sizeof(padded), k_count);
+  vml::mat4::transform_assume_ortho(m, packed.data(), sizeof(vml::vec3_t), k_count);
+
+  for (std::uint32_t i = 0; i < k_count; ++i)
+  {
+    vml::vec3a_t v       = vml::vec3a::set(strided[i].p[0], strided[i].p[1], strided[i].p[2]);
+    vml::vec4_t  ortho   = vml::mat4::transform_assume_ortho(m, v);
+    vml::vec4_t  project = vml::mat4::transform_and_project(proj, v);
+    for (std::uint32_t c = 0; c < 3; ++c)
+    {
+      CHECK(out_ortho[i][c] == Approx(vml::quad::get(ortho, c)));
+      CHECK(packed[i][c] == Approx(vml::quad::get(ortho, c)));
+      CHECK(in_place[i].p[c] == Approx(vml::quad::get(ortho, c)));
+      CHECK(out_project[i][c] == Approx(vml::quad::get(project, c)));
+      CHECK(out_strided[i].p[c] == Approx(vml::quad::get(project, c)));
+    }
+    for (std::uint32_t g = 0; g < 5; ++g)
+    {
+      CHECK(out_strided[i].guard[g] == strided[i].guard[g]);
+      CHECK(in_place[i].guard[g] == strided[i].guard[g]);
+    }
+  }
+}
+
 TEST_CASE("Validate mat4::transform_aabb", "[mat4::transform_aabb]")
 {
   vml::aabb_t aabb      = vml::aabb::set(vml::vec3a::zero(), vml::vec3a::set(4, 2, 2));
@@ -165,4 +271,88 @@ TEST_CASE("Validate mat4::inverse", "[mat4::inverse]")
   vml::mat4_t oi = {0, -0.8f, -0.6f, 0, 0.8f, -0.36, 0.48f, 0, 0.6f, 0.48f, -0.64f, 0, -17.8f, 15.3600016f, -0.48f, 1};
 
   CHECK(vml::mat4::equals(vml::mat4::inverse_assume_ortho(o), oi));
-}
\ No newline at end of file
+}
+
+TEST_CASE("Validate mat4::inverse_affine", "[mat4::inverse_affine]")
+{
+  vml::mat4_t m = vml::mat4::mul(
+    vml::mat4::from_scale(vml::vec3a::set(2.0f, 0.5f, 3.0f)),
+    vml::mat4::from_rotation(vml::quat::from_axis_angle(vml::vec3_t{0.6f, 0.0f, 0.8f}, vml::to_radians(35.0f))));
+  m.r[3] = vml::quad::set(4.0f, -2.0f, 7.0f, 1.0f);
+
+  vml::mat4_t r        = vml::mat4::inverse_affine(m);
+  vml::mat4_t expected = vml::mat4::inverse(m);
+  vml::mat4_t identity = vml::mat4::mul(m, r);
+  for (std::uint32_t j = 0; j < 16; ++j)
+  {
+    CHECK(r.m[j] == Approx(expected.m[j]).margin(1e-5f));
+    CHECK(identity.m[j] == Approx(j % 5 == 0 ? 1.0f : 0.0f).margin(1e-5f));
+  }
+}
+
+TEST_CASE("Validate mat4::inverse batch", "[mat4::inverse batch]")
+{
+  constexpr std::uint32_t  k_count = 13;
+  std::vector<vml::mat4_t> ortho(k_count);
+  std::vector<vml::mat4_t> affine(k_count);
+  std::vector<vml::mat4_t> general(k_count);
+  for (std::uint32_t i = 0; i < k_count; ++i)
+  {
+    float        f   = static_cast<float>(i);
+    vml::quat_t  rot = vml::quat::from_axis_angle(vml::vec3_t{0.0f, 1.0f, 0.0f}, vml::to_radians(11.0f * f));
+    vml::vec3a_t pos = vml::vec3a::set(f, 2.0f, -f);
+    ortho[i]         = vml::mat4::from_scale_rotation_translation(1.0f, rot, pos);
+    affine[i]        = vml::mat4::mul(vml::mat4::from_scale(vml::vec3a::set(1.0f + f, 2.0f, 0.5f)), ortho[i]);
+    general[i] =
+      vml::mat4::mul(affine[i], vml::mat4::from_perspective_projection(0.5f + 0.05f * f, 1.5f, 1.0f, 100.0f + f));
+  }
+
+  auto check = [](vml::mat4_t const& r, vml::mat4_t const& expected)
+  {
+    for (std::uint32_t j = 0; j < 16; ++j)
+      CHECK(r.m[j] == Approx(expected.m[j]).epsilon(1e-4f).margin(1e-4f));
+  };
+
+  std::vector<vml::mat4_t> r(k_count);
+  vml::mat4::inverse_assume_ortho(ortho, r);
+  for (std::uint32_t i = 0; i < k_count; ++i)
+    check(r[i], vml::mat4::inverse_assume_ortho(ortho[i]));
+  vml::mat4::inverse_affine(affine, r);
+  for (std::uint32_t i = 0; i < k_count; ++i)
+    check(r[i], vml::mat4::inverse(affine[i]));
+  vml::mat4::inverse(general, r);
+  for (std::uint32_t i = 0; i < k_count; ++i)
+    check(r[i], vml::mat4::inverse(general[i]));
+
+  // in place
+  std::vector<vml::mat4_t> in_place = affine;
+  vml::mat4::inverse_affine(in_place, in_place);
+  for (std::uint32_t i = 0; i < k_count; ++i)
+    check(in_place[i], vml::mat4::inverse_affine(affine[i]));
+}
+
+TEST_CASE("Validate mat4::transform_aabb batch", "[mat4::transform_aabb batch]")
+{
+  constexpr std::uint32_t  k_count = 13;
+  std::vector<vml::mat4_t> m(k_count);
+  std::vector<vml::aabb_t> boxes(k_count);
+  for (std::uint32_t i = 0; i < k_count; ++i)
+  {
+    float       f   = static_cast<float>(i);
+    vml::quat_t rot = vml::quat::from_axis_angle(vml::vec3_t{0.0f, 1.0f, 0.0f}, vml::to_radians(17.0f * f));
+    m[i]     = vml::mat4::from_scale_rotation_translation(1.0f + 0.25f * f, rot, vml::vec3a::set(f, -2.0f, 0.5f * f));
+    boxes[i] = vml::aabb::set_min_max(vml::vec3a::set(-1.0f - f, -2.0f, 0.5f), vml::vec3a::set(1.0f, f, 3.0f + f));
+  }
+
+  std::vector<vml::aabb_t> r(k_count);
+  vml::mat4::transform_aabb(m, boxes, r);
+  for (std::uint32_t i = 0; i < k_count; ++i)
+  {
+    vml::aabb_t expected = vml::mat4::transform_aabb(m[i], boxes[i]);
+    for (std::uint32_t j = 0; j < 3; ++j)
+    {
+      CHECK(r[i].r[0][j] == Approx(expected.r[0][j]).margin(1e-4f));
+      CHECK(r[i].r[1][j] == Approx(expected.r[1][j]).margin(1e-4f));
+    }
+  }
+}
@@ -0,0 +1,126 @@
+#include <catch2/catch.hpp>
+#include <vml.hpp>
+
+namespace
+{
+template <typename mat4xn>
+void make_matrices(vml::mat4_t* o)
+{
+  for (std::uint32_t i = 0; i < mat4xn::element_count; ++i)
+  {
+    float f = static_cast<float>(i);
+    o[i]    = vml::mat4::from_scale_rotation_translation(
+      1.0f + f * 0.5f, vml::quat::from_axis_angle(vml::vec3_t{0.0f, 0.0f, 1.0f}, vml::to_radians(20.0f * f)),
+      vml::vec3a::set(f, -f, 2.0f * f));
+  }
+}
+} // namespace
+
+TEMPLATE_TEST_CASE("Validate mat4xn::mul", "[mat4xn::mul]", vml::mat4x4, vml::mat4x8)
+{
+  using mat4xn = TestType;
+  vml::mat4_t a[mat4xn::element_count];
+  vml::mat4_t stored[mat4xn::element_count];
+  make_matrices<mat4xn>(a);
+  vml::mat4_t b = vml::mat4::from_perspective_projection(1.0f, 1.5f, 1.0f, 100.0f);
+
+  typename mat4xn::type ma = mat4xn::load(a);
+  mat4xn::store(stored, ma);
+
+  auto product   = mat4xn::mul(ma, mat4xn::set(b));
+  auto broadcast = mat4xn::mul(ma, b);
+  auto transpose = mat4xn::transpose(ma);
+  auto identity  = mat4xn::mul(mat4xn::identity(), ma);
+  for (std::uint32_t i = 0; i < mat4xn::element_count; ++i)
+  {
+    vml::mat4_t expected = vml::mat4::mul(a[i], b);
+    vml::mat4_t r        = mat4xn::get(product, i);
+    vml::mat4_t rb       = mat4xn::get(broadcast, i);
+    vml::mat4_t rt       = mat4xn::get(transpose, i);
+    vml::mat4_t ri       = mat4xn::get(identity, i);
+    vml::mat4_t t        = vml::mat4::transpose(a[i]);
+    for (std::uint32_t j = 0; j < 16; ++j)
+    {
+      CHECK(stored[i].m[j] == a[i].m[j]);
+      CHECK(r.m[j] == Approx(expected.m[j]));
+      CHECK(rb.m[j] == Approx(expected.m[j]));
+      CHECK(rt.m[j] == Approx(t.m[j]));
+      CHECK(ri.m[j] == Approx(a[i].m[j]));
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("Validate mat4xn::transform", "[mat4xn::transform]", vml::mat4x4, vml::mat4x8)
+{
+  using mat4xn = TestType;
+  using vec3xn = std::conditional_t<mat4xn::element_count == 4, vml::vec3x4, vml::vec3x8>;
+  vml::mat4_t  a[mat4xn::element_count];
+  vml::vec3a_t v[mat4xn::element_count];
+  make_matrices<mat4xn>(a);
+  vml::mat4_t proj = vml::mat4::from_perspective_projection(1.0f, 1.5f, 1.0f, 100.0f);
+  for (std::uint32_t i = 0; i < mat4xn::element_count; ++i)
+  {
+    float f = static_cast<float>(i);
+    v[i]    = vml::vec3a::set(f, 3.0f - f, 10.0f + f);
+  }
+
+  typename mat4xn::type ma      = mat4xn::load(a);
+  typename vec3xn::type vv      = vec3xn::load(v);
+  auto                  ortho   = mat4xn::transform_assume_ortho(ma, vv);
+  auto                  project = mat4xn::transform_and_project(mat4xn::mul(ma, proj), vv);
+  for (std::uint32_t i = 0; i < mat4xn::element_count; ++i)
+  {
+    vml::vec4_t  eo = vml::mat4::transform_assume_ortho(a[i], v[i]);
+    vml::vec4_t  ep = vml::mat4::transform_and_project(vml::mat4::mul(a[i], proj), v[i]);
+    vml::vec3a_t ro = vec3xn::get(ortho, i);
+    vml::vec3a_t rp = vec3xn::get(project, i);
+    for (std::uint32_t c = 0; c < 3; ++c)
+    {
+      CHECK(vml::quad::get(ro, c) == Approx(vml::quad::get(eo, c)));
+      CHECK(vml::quad::get(rp, c) == Approx(vml::quad::get(ep, c)));
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("Validate mat4xn::inverse", "[mat4xn::inverse]", vml::mat4x4, vml::mat4x8)
+{
+  using mat4xn = TestType;
+  vml::mat4_t a[mat4xn::element_count];
+  vml::mat4_t s[mat4xn::element_count];
+  make_matrices<mat4xn>(a);
+  for (std::uint32_t i = 0; i < mat4xn::element_count; ++i)
+    s[i] = vml::mat4::mul(vml::mat4::from_scale(vml::vec3a::set(1.0f, 2.0f + i, 0.5f)), a[i]);
+
+  typename mat4xn::type ma      = mat4xn::load(a);
+  typename mat4xn::type ms      = mat4xn::load(s);
+  auto                  general = mat4xn::inverse(ma);
+  auto                  affine  = mat4xn::inverse_affine(ms);
+  for (std::uint32_t i = 0; i < mat4xn::element_count; ++i)
+  {
+    vml::mat4_t eg = vml::mat4::inverse(a[i]);
+    vml::mat4_t ea = vml::mat4::inverse(s[i]);
+    vml::mat4_t rg = mat4xn::get(general, i);
+    vml::mat4_t ra = mat4xn::get(affine, i);
+    vml::mat4_t rs = mat4xn::get(mat4xn::mul(ms, affine), i);
+    for (std::uint32_t j = 0; j < 16; ++j)
+    {
+      CHECK(rg.m[j] == Approx(eg.m[j]).margin(1e-5f));
+      CHECK(ra.m[j] == Approx(ea.m[j]).margin(1e-5f));
+      CHECK(rs.m[j] == Approx(j % 5 == 0 ? 1.0f : 0.0f).margin(1e-5f));
+    }
+  }
+  // make_matrices scales, inverse_assume_ortho needs rotation and translation only
+  vml::mat4_t o[mat4xn::element_count];
+  for (std::uint32_t i = 0; i < mat4xn::element_count; ++i)
+    o[i] = vml::mat4::from_scale_rotation_translation(
+      1.0f, vml::quat::from_axis_angle(vml::vec3_t{0.0f, 0.0f, 1.0f}, vml::to_radians(20.0f * i)),
+      vml::vec3a::set(1.0f, 2.0f, 3.0f * i));
+  auto ortho = mat4xn::inverse_assume_ortho(mat4xn::load(o));
+  for (std::uint32_t i = 0; i < mat4xn::element_count; ++i)
+  {
+    vml::mat4_t e = vml::mat4::inverse_assume_ortho(o[i]);
+    vml::mat4_t r = mat4xn::get(ortho, i);
+    for (std::uint32_t j = 0; j < 16; ++j)
+      CHECK(r.m[j] == Approx(e.m[j]).margin(1e-5f));
+  }
+}
@@ -0,0 +1,210 @@
+#include "test_common.hpp"
+#include <catch2/catch.hpp>
+#include <vector>
+#include <vml.hpp>
+
+namespace
+{
+vml::obb_t obb_test_box(vml_test::rng& rng, float spread)
+{
+  vml::quat_t const rotation = vml::quat::from_axis_angle(
+    vml::vec3::normalize(vml::vec3::set(rng.next() - 0.5f, rng.next() - 0.5f, rng.next() + 0.1f)), rng.next() * 6.0f);
+  vml::vec3a_t const half =
+    vml::vec3a::set(rng.next() * 4.0f + 0.2f, rng.next() * 1.0f + 0.2f, rng.next() * 0.5f + 0.2f);
+  return vml::obb::set(rng.point(spread), rotation, half);
+}
+
+void obb_test_corners(vml::obb_t const& b, vml::vec3a_t (&o_corners)[8])
+{
+  for (std::uint32_t c = 0; c < 8; ++c)
+  {
+    vml::vec3a_t p = b.center;
+    for (std::uint32_t a = 0; a < 3; ++a)
+    {
+      float const e = vml::quad::get(b.half_extents, a);
+      p             = vml::vec3a::madd(b.axes[a], vml::vec3a::set((c >> a) & 1 ? e : -e), p);
+    }
+    o_corners[c] = p;
+  }
+}
+
+//! Largest gap between the projections of the corners on the 15 SAT axes, positive if separated
+float obb_test_gap(vml::obb_t const& a, vml::obb_t const& b)
+{
+  vml::vec3a_t ca[8];
+  vml::vec3a_t cb[8];
+  obb_test_corners(a, ca);
+  obb_test_corners(b, cb);
+  vml::vec3a_t  axes[15] = {a.axes[0], a.axes[1], a.axes[2], b.axes[0], b.axes[1], b.axes[2]};
+  std::uint32_t count    = 6;
+  for (auto const& i : a.axes)
+  {
+    for (auto const& j : b.axes)
+    {
+      vml::vec3a_t const c = vml::vec3a::cross(i, j);
+      if (vml::vec3a::length(c) > 1e-3f)
+        axes[count++] = vml::vec3a::normalize(c);
+    }
+  }
+  float gap = std::numeric_limits<float>::lowest();
+  for (std::uint32_t n = 0; n < count; ++n)
+  {
+    vml::vec3a_t const& axis = axes[n];
+
+    float lo_a = std::numeric_limits<float>::max(), hi_a = std::numeric_limits<float>::lowest();
+    float lo_b = lo_a, hi_b = hi_a;
+    for (std::uint32_t c = 0; c < 8; ++c)
+    {
+      lo_a = std::min(lo_a, vml::vec3a::dot(ca[c], axis));
+      hi_a = std::max(hi_a, vml::vec3a::dot(ca[c], axis));
+      lo_b = std::min(lo_b, vml::vec3a::dot(cb[c], axis));
+      hi_b = std::max(hi_b, vml::vec3a::dot(cb[c], axis));
+    }
+    gap = std::max(gap, std::max(lo_b - hi_a, lo_a - hi_b));
+  }
+  return gap;
+}
+
+//! Outside if all corners are behind one plane, inside if all are in front of every plane
+vml::intersect::result_t obb_test_frustum(vml::obb_t const& b, vml::frustum_t const& f)
+{
+  vml::vec3a_t corners[8];
+  obb_test_corners(b, corners);
+  auto const planes = vml::frustum::get_planes(f);
+  bool       inside = true;
+  for (std::uint32_t p = 0; p < planes.second; ++p)
+  {
+    std::uint32_t behind = 0;
+    for (auto const& c : corners)
+      behind += vml::plane::dot(planes.first[p], c) < 0.0f;
+    if (behind == 8)
+      return vml::intersect::result_t::k_outside;
+    inside = inside && behind == 0;
+  }
+  return inside ? vml::intersect::result_t::k_inside : vml::intersect::result_t::k_intersecting;
+}
+
+template <typename lane>
+void obb_test_batches(std::vector<vml::obb_t> const& boxes, vml::obb_t const& other, vml::aabb_t const& box,
+                      vml::sphere_t const& sphere, vml::frustum_t const& f)
+{
+  using obbxn               = vml::obbxn<lane>;
+  constexpr std::uint32_t n = obbxn::element_count;
+  for (std::uint32_t i = 0; i + n <= boxes.size(); i += n)
+  {
+    typename obbxn::type const batch      = obbxn::load(&boxes[i]);
+    std::uint32_t const        obbs       = obbxn::intersect_obb(batch, other);
+    std::uint32_t const        aabbs      = obbxn::intersect_aabb(batch, box);
+    std::uint32_t const        spheres    = obbxn::intersect_sphere(batch, sphere);
+    std::uint32_t const        visibility = obbxn::intersect_frustum(batch, f);
+    for (std::uint32_t k = 0; k < n; ++k)
+    {
+      CHECK(((obbs >> k) & 1) == (vml::obb::intersect_obb(boxes[i + k], other) ? 1u : 0u));
+      CHECK(((aabbs >> k) & 1) == (vml::obb::intersect_aabb(boxes[i + k], box) ? 1u : 0u));
+      CHECK(((spheres >> k) & 1) == (vml::obb::intersect_sphere(boxes[i + k], sphere) ? 1u : 0u));
+      CHECK(((visibility >> k) & 1) ==
+            (vml::obb::intersect_frustum(boxes[i + k], f) != vml::intersect::result_t::k_outside ? 1u : 0u));
+    }
+  }
+}
+} // namespace
+
+TEST_CASE("Validate obb", "[obb]")
+{
+  vml::quat_t const  q = vml::quat::from_axis_angle(vml::vec3::set(0.0f, 0.0f, 1.0f), vml::to_radians(90.0f));
+  vml::obb_t const   b = vml::obb::set(vml::vec3a::set(1.0f, 2.0f, 3.0f), q, vml::vec3a::set(4.0f, 1.0f, 0.5f));
+  vml::aabb_t const  bounds = vml::obb::to_aabb(b);
+  CHECK(vml::vec3a::equals(b.axes[0], vml::quat::transform(q, vml::vec3a::set(1.0f, 0.0f, 0.0f))));
+  CHECK(vml::vec3a::equals(b.axes[1], vml::quat::transform(q, vml::vec3a::set(0.0f, 1.0f, 0.0f))));
+  CHECK(vml::vec3a::equals(bounds.r[0], vml::vec3a::set(0.0f, -2.0f, 2.5f)));
+  CHECK(vml::vec3a::equals(bounds.r[1], vml::vec3a::set(2.0f, 6.0f, 3.5f)));
+
+  // The box from a transform holds the transformed local corners
+  vml::transform_t t;
+  vml::vec3_t const axis = vml::vec3::normalize(vml::vec3::set(1.0f, 1.0f, 0.0f));
+  vml::transform::set_rotation(t, vml::quat::from_axis_angle(axis, 0.7f));
+  vml::transform::set_translation(t, vml::vec3a::set(-3.0f, 5.0f, 2.0f));
+  vml::transform::set_scale(t, 2.0f);
+  vml::aabb_t const local =
+    vml::aabb::set_min_max(vml::vec3a::set(-1.0f, 0.0f, 2.0f), vml::vec3a::set(3.0f, 1.0f, 2.5f));
+  vml::obb_t const moved = vml::obb::from_transform(t, local);
+  CHECK(vml::vec3a::equals(moved.half_extents, vml::vec3a::set(4.0f, 1.0f, 0.5f)));
+  for (std::uint32_t c = 0; c < 8; ++c)
+  {
+    vml::vec3a_t const p =
+      vml::transform::mul(vml::vec3a::set(vml::quad::get(local.r[c & 1], 0), vml::quad::get(local.r[(c >> 1) & 1], 1),
+                                          vml::quad::get(local.r[c >> 2], 2)),
+                          t);
+    vml::vec3a_t const d = vml::vec3a::sub(p, moved.center);
+    for (std::uint32_t a = 0; a < 3; ++a)
+      CHECK(std::abs(vml::vec3a::dot(d, moved.axes[a])) == Approx(vml::quad::get(moved.half_extents, a)));
+  }
+
+  // Spheres off a corner at a distance of sqrt(2), within and beyond reach
+  vml::vec3a_t const corner = vml::vec3a::madd(b.axes[0], vml::vec3a::set(5.0f),
+                                               vml::vec3a::madd(b.axes[1], vml::vec3a::set(2.0f), b.center));
+  CHECK(vml::obb::intersect_sphere(b, vml::sphere::set(corner, 1.5f)));
+  CHECK(!vml::obb::intersect_sphere(b, vml::sphere::set(corner, 1.4f)));
+  CHECK(vml::obb::intersect_sphere(b, vml::sphere::set(b.center, 0.1f)));
+}
+
+TEST_CASE("Validate obb intersections", "[obb]")
+{
+  vml_test::rng           rng{83};
+  std::vector<vml::obb_t> boxes(400);
+  for (auto& b : boxes)
+    b = obb_test_box(rng, 16.0f);
+  // Parallel edges make the cross product axes vanish
+  boxes[1]        = boxes[0];
+  boxes[1].center = vml::vec3a::add(boxes[0].center, vml::vec3a::mul(boxes[0].axes[0], 1.0f));
+
+  std::uint32_t overlaps = 0;
+  for (std::uint32_t i = 0; i < boxes.size(); ++i)
+  {
+    for (std::uint32_t j = i + 1; j < boxes.size(); j += 7)
+    {
+      float const gap = obb_test_gap(boxes[i], boxes[j]);
+      if (std::abs(gap) < 1e-3f)
+        continue;
+      CHECK(vml::obb::intersect_obb(boxes[i], boxes[j]) == (gap < 0.0f));
+      CHECK(vml::obb::intersect_obb(boxes[j], boxes[i]) == (gap < 0.0f));
+      overlaps += gap < 0.0f;
+    }
+    vml::aabb_t const box = vml::aabb::set(rng.point(16.0f), vml::vec3a::set(2.0f, 0.5f, 1.0f));
+    float const       gap = obb_test_gap(boxes[i], vml::obb::from_aabb(box));
+    if (std::abs(gap) >= 1e-3f)
+      CHECK(vml::obb::intersect_aabb(boxes[i], box) == (gap < 0.0f));
+  }
+  CHECK(overlaps > 0);
+  CHECK(vml::obb::intersect_obb(boxes[0], boxes[1]));
+
+  vml::mat4_t const view = vml::mat4::from_look_at(vml::vec3a::set(0.0f, 2.0f, -20.0f), vml::vec3a::zero(),
+                                                   vml::vec3a::set(0.0f, 1.0f, 0.0f));
+  vml::mat4_t const proj = vml::mat4::from_perspective_projection(0.6f, 1.0f, 1.0f, 30.0f);
+  vml::frustum_t    f    = vml::frustum::from_mat4_transpose(vml::mat4::transpose(vml::mat4::mul(view, proj)));
+  std::uint32_t     counts[3] = {};
+  for (auto const& b : boxes)
+  {
+    vml::intersect::result_t const r = vml::obb::intersect_frustum(b, f);
+    CHECK(r == obb_test_frustum(b, f));
+    counts[static_cast<std::uint32_t>(r)]++;
+  }
+  CHECK(counts[0] > 0);
+  CHECK(counts[1] > 0);
+  CHECK(counts[2] > 0);
+
+  std::vector<std::uint32_t> visible(boxes.size() / 32 + 1, 0xffffffff);
+  vml::obb::intersect_frustum(boxes, f, visible);
+  for (std::uint32_t i = 0; i < boxes.size(); ++i)
+    CHECK(((visible[i / 32] >> (i % 32)) & 1) ==
+          (vml::obb::intersect_frustum(boxes[i], f) != vml::intersect::result_t::k_outside ? 1u : 0u));
+
+  for (std::uint32_t q = 0; q < 16; ++q)
+  {
+    vml::obb_t const    other  = obb_test_box(rng, 16.0f);
+    vml::aabb_t const   box    = vml::aabb::set(rng.point(16.0f), vml::vec3a::set(3.0f, 0.5f, 1.0f));
+    vml::sphere_t const sphere = vml::sphere::set(rng.point(16.0f), rng.next() * 4.0f);
+    obb_test_batches<vml::quad>(boxes, other, box, sphere, f);
+    obb_test_batches<vml::quad8>(boxes, other, box, sphere, f);
+  }
+}
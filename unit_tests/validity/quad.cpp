@@ -183,3 +183,18 @@ TEST_CASE("Validate quad::arithmetic", "[quad::arithmetic]")
   CHECK(vml::quad::z(r) == Approx(1.0f));
   CHECK(vml::quad::w(r) == Approx(8.0f));
 }
+
+TEST_CASE("Validate quad::transpose", "[quad::transpose]")
+{
+  vml::quad_t r0 = vml::quad::set(1.0f, 2.0f, 3.0f, 4.0f);
+  vml::quad_t r1 = vml::quad::set(5.0f, 6.0f, 7.0f, 8.0f);
+  vml::quad_t r2 = vml::quad::set(9.0f, 10.0f, 11.0f, 12.0f);
+  vml::quad_t r3 = vml::quad::set(13.0f, 14.0f, 15.0f, 16.0f);
+  vml::quad::transpose(r0, r1, r2, r3);
+  CHECK(vml::quad::equals(r0, vml::quad::set(1.0f, 5.0f, 9.0f, 13.0f)));
+  CHECK(vml::quad::equals(r1, vml::quad::set(2.0f, 6.0f, 10.0f, 14.0f)));
+  CHECK(vml::quad::equals(r2, vml::quad::set(3.0f, 7.0f, 11.0f, 15.0f)));
+  CHECK(vml::quad::equals(r3, vml::quad::set(4.0f, 8.0f, 12.0f, 16.0f)));
+  CHECK(vml::quad::equals(vml::quad::sqrt(vml::quad::set(4.0f, 9.0f, 16.0f, 0.25f)),
+                          vml::quad::set(2.0f, 3.0f, 4.0f, 0.5f)));
+}
@@ -0,0 +1,101 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <vml.hpp>
+
+TEST_CASE("Validate quad8::set", "[quad8::set]")
+{
+  alignas(32) float val[8] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f};
+  vml::quad8_t      p      = vml::quad8::set(val);
+  for (std::uint32_t i = 0; i < 8; ++i)
+    CHECK(vml::quad8::get(p, i) == Approx(val[i]));
+  p = vml::quad8::set_unaligned(val + 0);
+  CHECK(vml::quad8::get(p, 7) == Approx(8.0f));
+  p = vml::quad8::set(3.0f);
+  for (std::uint32_t i = 0; i < 8; ++i)
+    CHECK(vml::quad8::get(p, i) == Approx(3.0f));
+  p = vml::quad8::zero();
+  CHECK(vml::quad8::hadd(p) == Approx(0.0f));
+
+  p = vml::quad8::set(vml::quad::set(1.0f, 2.0f, 3.0f, 4.0f), vml::quad::set(5.0f, 6.0f, 7.0f, 8.0f));
+  for (std::uint32_t i = 0; i < 8; ++i)
+    CHECK(vml::quad8::get(p, i) == Approx(val[i]));
+  CHECK(vml::quad::equals(vml::quad8::lo(p), vml::quad::set(1.0f, 2.0f, 3.0f, 4.0f)));
+  CHECK(vml::quad::equals(vml::quad8::hi(p), vml::quad::set(5.0f, 6.0f, 7.0f, 8.0f)));
+
+  alignas(32) float out[8] = {};
+  vml::quad8::store(out, vml::quad8::mul(p, 2.0f));
+  for (std::uint32_t i = 0; i < 8; ++i)
+    CHECK(out[i] == Approx(2.0f * val[i]));
+  float uout[9] = {};
+  vml::quad8::store_unaligned(uout + 1, p);
+  CHECK(uout[0] == 0.0f);
+  CHECK(uout[8] == Approx(8.0f));
+}
+
+TEST_CASE("Validate quad8::arithmetic", "[quad8::arithmetic]")
+{
+  float        a[8] = {10.0f, 23.0f, -1.0f, 10.0f, 4.0f, -8.0f, 0.5f, 100.0f};
+  float        b[8] = {441.3f, 5.0f, 51.0f, 10.0f, 2.0f, 3.0f, -0.25f, 16.0f};
+  vml::quad8_t p    = vml::quad8::set_unaligned(a);
+  vml::quad8_t q    = vml::quad8::set_unaligned(b);
+  vml::quad8_t add  = vml::quad8::add(p, q);
+  vml::quad8_t sub  = vml::quad8::sub(p, q);
+  vml::quad8_t mul  = vml::quad8::mul(p, q);
+  vml::quad8_t div  = vml::quad8::div(p, q);
+  vml::quad8_t madd = vml::quad8::madd(p, q, p);
+  vml::quad8_t min  = vml::quad8::min(p, q);
+  vml::quad8_t max  = vml::quad8::max(p, q);
+  vml::quad8_t abs  = vml::quad8::abs(p);
+  vml::quad8_t neg  = vml::quad8::negate(p);
+  vml::quad8_t sqrt = vml::quad8::sqrt(abs);
+  vml::quad8_t rsq  = vml::quad8::recip_sqrt(abs);
+  float        sum  = 0.0f;
+  for (std::uint32_t i = 0; i < 8; ++i)
+  {
+    CHECK(vml::quad8::get(add, i) == Approx(a[i] + b[i]));
+    CHECK(vml::quad8::get(sub, i) == Approx(a[i] - b[i]));
+    CHECK(vml::quad8::get(mul, i) == Approx(a[i] * b[i]));
+    CHECK(vml::quad8::get(div, i) == Approx(a[i] / b[i]));
+    CHECK(vml::quad8::get(madd, i) == Approx(a[i] * b[i] + a[i]));
+    CHECK(vml::quad8::get(min, i) == Approx(std::min(a[i], b[i])));
+    CHECK(vml::quad8::get(max, i) == Approx(std::max(a[i], b[i])));
+    CHECK(vml::quad8::get(abs, i) == Approx(std::abs(a[i])));
+    CHECK(vml::quad8::get(neg, i) == Approx(-a[i]));
+    CHECK(vml::quad8::get(sqrt, i) == Approx(std::sqrt(std::abs(a[i]))));
+    CHECK(vml::quad8::get(rsq, i) == Approx(1.0f / std::sqrt(std::abs(a[i]))).epsilon(0.001));
+    sum += a[i];
+  }
+  CHECK(vml::quad8::hadd(p) == Approx(sum));
+}
+
+TEST_CASE("Validate quad8::compare", "[quad8::compare]")
+{
+  float        a[8] = {-441.3f, 23.0f, -1.0f, 10.0f, 4.0f, 4.0f, 0.5f, 100.0f};
+  float        b[8] = {441.3f, 5.0f, 51.0f, 10.0f, 2.0f, 4.0f, -0.25f, 160.0f};
+  vml::quad8_t p    = vml::quad8::set_unaligned(a);
+  vml::quad8_t q    = vml::quad8::set_unaligned(b);
+  CHECK(vml::quad8::mask(vml::quad8::lesserv(p, q)) == 0b10000101u);
+  CHECK(vml::quad8::mask(vml::quad8::lesser_equalv(p, q)) == 0b10101101u);
+  CHECK(vml::quad8::mask(vml::quad8::greaterv(p, q)) == 0b01010010u);
+  CHECK(vml::quad8::mask(vml::quad8::greater_equalv(p, q)) == 0b01111010u);
+  CHECK(vml::quad8::mask(vml::quad8::equalv(p, q)) == 0b00101000u);
+  CHECK(vml::quad8::mask(p) == 0b00000101u);
+  CHECK(vml::quad8::any(vml::quad8::equalv(p, q)));
+  CHECK(vml::quad8::all(vml::quad8::equalv(p, p)));
+  CHECK(vml::quad8::all(vml::quad8::equalv(p, q)) == false);
+  CHECK(vml::quad8::greater_any(p, q));
+  CHECK(vml::quad8::greater_all(p, q) == false);
+  CHECK(vml::quad8::lesser_any(p, q));
+  CHECK(vml::quad8::lesser_all(p, q) == false);
+  CHECK(vml::quad8::greater_all(vml::quad8::add(q, vml::quad8::abs(q)), vml::quad8::sub(q, vml::quad8::set(1.0f))));
+  CHECK(vml::quad8::lesser_any(p, p) == false);
+
+  vml::quad8_t lt  = vml::quad8::lesserv(p, q);
+  vml::quad8_t eq  = vml::quad8::equalv(p, q);
+  vml::quad8_t sel = vml::quad8::select(p, q, lt);
+  for (std::uint32_t i = 0; i < 8; ++i)
+    CHECK(vml::quad8::get(sel, i) == Approx(a[i] < b[i] ? b[i] : a[i]));
+  CHECK(vml::quad8::mask(vml::quad8::bit_or(lt, eq)) == 0b10101101u);
+  CHECK(vml::quad8::mask(vml::quad8::bit_and(lt, eq)) == 0u);
+  CHECK(vml::quad8::mask(vml::quad8::bit_andnot(eq, vml::quad8::lesser_equalv(p, q))) == 0b10000101u);
+}
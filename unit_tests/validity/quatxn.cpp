@@ -0,0 +1,44 @@
+#include <catch2/catch.hpp>
+#include <vml.hpp>
+
+TEMPLATE_TEST_CASE("Validate quatxn::mul", "[quatxn::mul]", vml::quatx4, vml::quatx8)
+{
+  using quatxn = TestType;
+  using vec3xn = std::conditional_t<quatxn::element_count == 4, vml::vec3x4, vml::vec3x8>;
+  using lane   = std::conditional_t<quatxn::element_count == 4, vml::quad, vml::quad8>;
+  vml::quat_t  a[quatxn::element_count];
+  vml::quat_t  b[quatxn::element_count];
+  vml::vec3a_t v[quatxn::element_count];
+  for (std::uint32_t i = 0; i < quatxn::element_count; ++i)
+  {
+    float f = static_cast<float>(i);
+    a[i]    = vml::quat::from_axis_angle(vml::vec3_t{0.0f, 1.0f, 0.0f}, vml::to_radians(10.0f + 15.0f * f));
+    b[i]    = vml::quat::from_axis_angle(vml::vec3_t{0.6f, 0.0f, 0.8f}, vml::to_radians(70.0f - 9.0f * f));
+    v[i]    = vml::vec3a::set(f, 1.0f - f, 2.0f);
+  }
+
+  typename quatxn::type qa = quatxn::load(a);
+  typename quatxn::type qb = quatxn::load(b);
+  vml::quat_t           stored[quatxn::element_count];
+  quatxn::store(stored, qa);
+
+
+  auto product   = quatxn::mul(qa, qb);
+  auto conjugate = quatxn::conjugate(qa);
+  auto normal    = quatxn::normalize(quatxn::mul(qb, qa));
+  auto dot       = quatxn::dot(qa, qb);
+  auto rotated   = quatxn::transform(qa, vec3xn::load(v));
+  for (std::uint32_t i = 0; i < quatxn::element_count; ++i)
+  {
+    CHECK(vml::quad::equals(stored[i], a[i]));
+    CHECK(vml::quad::equals(quatxn::get(product, i), vml::quat::mul(a[i], b[i])));
+    CHECK(vml::quad::equals(quatxn::get(conjugate, i), vml::quat::conjugate(a[i])));
+    CHECK(vml::quad::equals(quatxn::get(normal, i), vml::quad::normalize(vml::quat::mul(b[i], a[i]))));
+    CHECK(lane::get(dot, i) == Approx(vml::quad::dot(a[i], b[i])));
+    CHECK(vml::vec3a::equals(vec3xn::get(rotated, i), vml::quat::transform(a[i], v[i])));
+  }
+
+  auto identity = quatxn::mul(quatxn::identity(), quatxn::set(a[1]));
+  for (std::uint32_t i = 0; i < quatxn::element_count; ++i)
+    CHECK(vml::quad::equals(quatxn::get(identity, i), a[1]));
+}
@@ -0,0 +1,138 @@
+#include "test_common.hpp"
+#include <catch2/catch.hpp>
+#include <vector>
+#include <vml.hpp>
+
+namespace
+{
+template <typename lane>
+void ray_test_batches(vml::ray_t const& r, std::vector<vml::aabb_t> const& boxes,
+                      vml_test::quad_vector const& spheres, vml_test::quad_vector const& planes, float t_max)
+{
+  using rayxn                   = vml::rayxn<lane>;
+  constexpr std::uint32_t    n  = rayxn::element_count;
+  typename rayxn::type const rl = rayxn::set(r);
+  for (std::uint32_t i = 0; i + n <= boxes.size(); i += n)
+  {
+    typename lane::type t;
+    std::uint32_t const box_hits = rayxn::intersect_boxes(rl, &boxes[i], t_max, t);
+    for (std::uint32_t k = 0; k < n; ++k)
+    {
+      float const expected = vml::ray::intersect_box(r, boxes[i + k], t_max);
+      CHECK(((box_hits >> k) & 1) == (expected >= 0.0f ? 1u : 0u));
+      if (expected >= 0.0f)
+        CHECK(lane::get(t, k) == Approx(expected).margin(1e-4f));
+    }
+
+    std::uint32_t const sphere_hits = rayxn::intersect_spheres(rl, &spheres[i], t_max, t);
+    for (std::uint32_t k = 0; k < n; ++k)
+    {
+      float const expected = vml::ray::intersect_sphere(r, spheres[i + k], t_max);
+      CHECK(((sphere_hits >> k) & 1) == (expected >= 0.0f ? 1u : 0u));
+      if (expected >= 0.0f)
+        CHECK(lane::get(t, k) == Approx(expected).margin(1e-3f));
+    }
+
+    std::uint32_t const plane_hits = rayxn::intersect_planes(rl, &planes[i], t_max, t);
+    for (std::uint32_t k = 0; k < n; ++k)
+    {
+      float const expected = vml::ray::intersect_plane(r, planes[i + k], t_max);
+      CHECK(((plane_hits >> k) & 1) == (expected >= 0.0f ? 1u : 0u));
+      if (expected >= 0.0f)
+        CHECK(lane::get(t, k) == Approx(expected).margin(1e-3f));
+    }
+  }
+}
+} // namespace
+
+TEST_CASE("Validate ray", "[ray]")
+{
+  vml::ray_t r = vml::ray::set(vml::vec3a::set(1.0f, 2.0f, 3.0f), vml::vec3a::set(-2.0f, 0.0f, 4.0f));
+  CHECK(r.sign == 1);
+  CHECK(vml::vec3a::x(r.inv_direction) == Approx(-0.5f));
+  CHECK(vml::vec3a::z(r.inv_direction) == Approx(0.25f));
+  CHECK(vml::vec3a::equals(vml::ray::at(r, 0.5f), vml::vec3a::set(0.0f, 2.0f, 5.0f)));
+
+  vml::aabb_t box = vml::aabb::set(vml::vec3a::set(-1.0f, 2.0f, 7.0f), vml::vec3a::set(0.5f));
+  CHECK(vml::ray::intersect_box(r, box, 10.0f) == Approx(0.875f));
+  CHECK(vml::ray::intersect_box(r, box, 0.5f) < 0.0f);
+  // The ray is parallel to y and starts outside the box on y
+  box = vml::aabb::set(vml::vec3a::set(-1.0f, 3.0f, 7.0f), vml::vec3a::set(0.5f));
+  CHECK(vml::ray::intersect_box(r, box, 10.0f) < 0.0f);
+
+  vml::sphere_t s = vml::sphere::set(vml::vec3a::set(1.0f, 2.0f, 13.0f), 2.0f);
+  r               = vml::ray::from_points(vml::vec3a::set(1.0f, 2.0f, 3.0f), vml::vec3a::set(1.0f, 2.0f, 8.0f));
+  CHECK(vml::ray::intersect_sphere(r, s, 10.0f) == Approx(1.6f));
+  CHECK(vml::ray::intersect_sphere(r, vml::sphere::set(vml::vec3a::set(1.0f, 2.0f, 3.0f), 1.0f), 10.0f) == 0.0f);
+  CHECK(vml::ray::intersect_sphere(r, vml::sphere::set(vml::vec3a::set(1.0f, 2.0f, -3.0f), 1.0f), 10.0f) < 0.0f);
+
+  vml::plane_t p = vml::plane::set(vml::vec3a::set(0.0f, 0.0f, 1.0f), -6.0f);
+  CHECK(vml::ray::intersect_plane(r, p, 10.0f) == Approx(0.6f));
+  CHECK(vml::ray::intersect_plane(r, vml::plane::set(vml::vec3a::set(1.0f, 0.0f, 0.0f), -6.0f), 10.0f) < 0.0f);
+}
+
+TEST_CASE("Validate rayxn", "[ray]")
+{
+  vml_test::rng            rng{17};
+  std::vector<vml::aabb_t> boxes(256);
+  vml_test::quad_vector    spheres(256);
+  vml_test::quad_vector    planes(256);
+  for (std::uint32_t i = 0; i < boxes.size(); ++i)
+  {
+    vml::vec3a_t const e = vml::vec3a::set(rng.next() * 4.0f + 0.5f, rng.next() * 4.0f + 0.5f, rng.next() * 4.0f);
+    boxes[i]             = vml::aabb::set(rng.point(40.0f), e);
+    spheres[i]           = vml::sphere::set(rng.point(40.0f), rng.next() * 5.0f + 0.5f);
+    planes[i]            = vml::plane::set(vml::vec3a::normalize(rng.point(2.0f)), (rng.next() - 0.5f) * 40.0f);
+  }
+  // Boxes and spheres around the origin so rays from inside them are tested too
+  boxes[3]   = vml::aabb::set(vml::vec3a::zero(), vml::vec3a::set(1.0f));
+  spheres[5] = vml::sphere::set(vml::vec3a::zero(), 1.0f);
+
+  std::uint32_t box_hits = 0;
+  for (std::uint32_t i = 0; i < 64; ++i)
+  {
+    vml::vec3a_t direction = rng.point(2.0f);
+    // Axis aligned rays take the parallel slab path
+    if (i % 8 == 0)
+      direction = vml::vec3a::set(0.0f, i % 16 ? 1.0f : -1.0f, 0.0f);
+    vml::vec3a_t const origin = i % 4 ? rng.point(60.0f) : vml::vec3a::zero();
+    vml::ray_t const   r      = vml::ray::set(origin, direction);
+    for (auto const& b : boxes)
+    {
+      float const t = vml::ray::intersect_box(r, b, 100.0f);
+      CHECK(t == Approx(vml_test::ray_box_entry(b, origin, direction, 100.0f)).margin(1e-4f));
+      box_hits += t >= 0.0f;
+    }
+    ray_test_batches<vml::quad>(r, boxes, spheres, planes, 100.0f);
+    ray_test_batches<vml::quad8>(r, boxes, spheres, planes, 100.0f);
+  }
+  CHECK(box_hits > 0);
+}
+
+TEST_CASE("Validate ray from screen", "[ray]")
+{
+  vml::mat4_t view = vml::mat4::from_look_at(vml::vec3a::set(3.0f, 4.0f, -10.0f), vml::vec3a::zero(),
+                                             vml::vec3a::set(0.0f, 1.0f, 0.0f));
+  vml::mat4_t proj = vml::mat4::from_perspective_projection(1.0f, 1.5f, 0.5f, 100.0f);
+  vml::mat4_t vp   = vml::mat4::mul(view, proj);
+  vml::mat4_t inv  = vml::mat4::inverse(vp);
+
+  vml::vec3a_t const target = vml::vec3a::set(1.0f, -0.5f, 2.0f);
+  vml::vec4_t const  ndc    = vml::mat4::transform_and_project(vp, target);
+  vml::ray_t const   r      = vml::ray::from_ndc(inv, vml::vec4::x(ndc), vml::vec4::y(ndc));
+  // The ray starts on the near plane, ends on the far plane and passes through target
+  CHECK(vml::vec4::z(vml::mat4::transform_and_project(vp, r.origin)) == Approx(0.0f).margin(1e-4f));
+  CHECK(vml::vec4::z(vml::mat4::transform_and_project(vp, vml::ray::at(r, 1.0f))) == Approx(1.0f).margin(1e-4f));
+  vml::vec3a_t const to_target = vml::vec3a::sub(target, r.origin);
+  float const        t         = vml::vec3a::dot(to_target, r.direction) / vml::vec3a::dot(r.direction, r.direction);
+  CHECK(vml::vec3a::distance(vml::ray::at(r, t), target) == Approx(0.0f).margin(1e-3f));
+
+  // The viewport center maps to the middle of the screen
+  vml::ray_t const center = vml::ray::from_screen(inv, 400.0f, 300.0f, 800.0f, 600.0f);
+  vml::ray_t const mid    = vml::ray::from_ndc(inv, 0.0f, 0.0f);
+  CHECK(vml::vec3a::distance(center.origin, mid.origin) == Approx(0.0f).margin(1e-4f));
+  vml::ray_t const  corner   = vml::ray::from_screen(inv, 0.0f, 0.0f, 800.0f, 600.0f);
+  vml::vec4_t const top_left = vml::mat4::transform_and_project(vp, vml::ray::at(corner, 0.5f));
+  CHECK(vml::vec4::x(top_left) == Approx(-1.0f));
+  CHECK(vml::vec4::y(top_left) == Approx(1.0f));
+}
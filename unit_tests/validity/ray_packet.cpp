@@ -0,0 +1,273 @@
+#include "test_common.hpp"
+#include <bit>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <vector>
+#include <vml.hpp>
+
+namespace
+{
+//! Rays from around (0, 0, -40) spreading over a small cone along +z
+template <typename lane>
+typename vml::ray_packetn<lane>::type ray_packet_test_rays(vml_test::rng& rng, float t_max,
+                                                           vml::ray_t (&o_rays)[lane::element_count])
+{
+  vml::vec3a_t const center = vml::vec3a::set((rng.next() - 0.5f) * 20.0f, (rng.next() - 0.5f) * 20.0f, 40.0f);
+  for (vml::ray_t& r : o_rays)
+  {
+    vml::vec3a_t const origin = vml::vec3a::add(vml::vec3a::set(0.0f, 0.0f, -40.0f), rng.point(0.5f));
+    r                         = vml::ray::from_points(origin, vml::vec3a::add(center, rng.point(6.0f)));
+  }
+  return vml::ray_packetn<lane>::set(o_rays, t_max);
+}
+
+//! Rays per second of trace, which casts ray_count rays and returns its hit count, over runs of at least 200 ms
+template <typename trace_fn>
+double ray_packet_test_rays_per_second(std::uint32_t ray_count, trace_fn const& trace)
+{
+  using clock              = std::chrono::steady_clock;
+  std::uint32_t    runs    = 0;
+  std::uint64_t    hits    = 0;
+  clock::time_point start  = clock::now();
+  clock::duration   passed = {};
+  for (; passed < std::chrono::milliseconds(200); passed = clock::now() - start, ++runs)
+    hits += trace();
+  CHECK(hits > 0);
+  return static_cast<double>(ray_count) * runs / std::chrono::duration<double>(passed).count();
+}
+
+template <typename lane>
+void ray_packet_test_boxes(std::vector<vml::aabb_t> const& boxes, vml_test::quad_vector const& triangles)
+{
+  using ray_packetn         = vml::ray_packetn<lane>;
+  constexpr std::uint32_t n = ray_packetn::element_count;
+  vml_test::rng           rng{29};
+  std::uint32_t           hits = 0;
+  for (std::uint32_t r = 0; r < 32; ++r)
+  {
+    vml::ray_t                 rays[n];
+    typename ray_packetn::type p = ray_packet_test_rays<lane>(rng, 2.0f, rays);
+    for (std::uint32_t k = 0; k < n; ++k)
+      CHECK(vml::vec3a::equals(ray_packetn::get(p, k).direction, rays[k].direction));
+
+    // Some rays are inactive, they never hit
+    std::uint32_t const active = r % 4 ? ray_packetn::all_active : 0x5;
+    for (auto const& b : boxes)
+    {
+      typename lane::type t;
+      std::uint32_t const mask = ray_packetn::intersect_box(p, b, active, t);
+      for (std::uint32_t k = 0; k < n; ++k)
+      {
+        float const expected = (active >> k) & 1 ? vml::ray::intersect_box(rays[k], b, 2.0f) : -1.0f;
+        CHECK(((mask >> k) & 1) == (expected >= 0.0f ? 1u : 0u));
+        if (expected >= 0.0f)
+          CHECK(lane::get(t, k) == Approx(expected).margin(1e-4f));
+      }
+      hits += mask != 0;
+    }
+
+    // Planes contain every ray, boxes outside them are missed by all rays
+    vml::plane_t        planes[6];
+    std::uint32_t const plane_count = ray_packetn::bounding_planes(p, planes);
+    REQUIRE(plane_count == 6);
+    for (std::uint32_t k = 0; k < n; ++k)
+    {
+      for (float t : {0.0f, 0.5f, 1.0f, 2.0f})
+      {
+        for (std::uint32_t i = 0; i < plane_count; ++i)
+          CHECK(vml::plane::dot(planes[i], vml::ray::at(rays[k], t)) >= -1e-3f);
+      }
+    }
+    for (auto const& b : boxes)
+    {
+      if (!ray_packetn::outside(planes, plane_count, b))
+        continue;
+      for (std::uint32_t k = 0; k < n; ++k)
+        CHECK(vml::ray::intersect_box(rays[k], b, 2.0f) < 0.0f);
+    }
+
+    // Nearest hit among all triangles against each hit on its own
+    typename ray_packetn::hit_type hit;
+    std::uint32_t const            mask = ray_packetn::intersect_triangles(p, triangles, active, hit);
+    for (std::uint32_t k = 0; k < n; ++k)
+    {
+      float         nearest = 2.0f;
+      std::uint32_t index   = ray_packetn::k_no_hit;
+      for (std::uint32_t i = 0; i < triangles.size() / 3; ++i)
+      {
+        typename ray_packetn::type single = ray_packetn::set(rays, nearest);
+        typename lane::type        t, u, v;
+        if ((ray_packetn::intersect_triangle(single, triangles[i * 3], triangles[i * 3 + 1], triangles[i * 3 + 2],
+                                             active, t, u, v) >>
+             k) &
+            1)
+        {
+          nearest = lane::get(t, k);
+          index   = i;
+        }
+      }
+      CHECK(hit.triangle[k] == index);
+      CHECK(((mask >> k) & 1) == (index != ray_packetn::k_no_hit ? 1u : 0u));
+      if (index == ray_packetn::k_no_hit)
+        continue;
+      CHECK(lane::get(p.t_max, k) == Approx(nearest));
+      // The barycentrics give back the hit point
+      vml::vec3a_t const v0    = triangles[index * 3];
+      vml::vec3a_t const point = vml::vec3a::madd(
+        vml::vec3a::sub(triangles[index * 3 + 1], v0), vml::vec3a::set(lane::get(hit.u, k)),
+        vml::vec3a::madd(vml::vec3a::sub(triangles[index * 3 + 2], v0), vml::vec3a::set(lane::get(hit.v, k)), v0));
+      CHECK(vml::vec3a::distance(point, vml::ray::at(rays[k], nearest)) == Approx(0.0f).margin(1e-3f));
+    }
+  }
+  CHECK(hits > 0);
+}
+
+template <typename lane>
+void ray_packet_test_bvh(vml::bvh const& tree, std::vector<vml::aabb_t> const& boxes,
+                         vml_test::quad_vector const& triangles)
+{
+  using ray_packetn         = vml::ray_packetn<lane>;
+  constexpr std::uint32_t n = ray_packetn::element_count;
+  vml_test::rng           rng{41};
+  std::uint32_t           found = 0;
+  for (std::uint32_t r = 0; r < 32; ++r)
+  {
+    vml::ray_t                 rays[n];
+    typename ray_packetn::type p      = ray_packet_test_rays<lane>(rng, 2.0f, rays);
+    std::uint32_t const        active = r % 4 ? ray_packetn::all_active : 0x6;
+
+    // Every box hit is reported once with the rays hitting it
+    std::vector<std::uint32_t> masks(boxes.size());
+    tree.raycast(p, active,
+                 [&](std::uint32_t index, std::uint32_t mask)
+                 {
+                   CHECK(masks[index] == 0);
+                   masks[index] = mask;
+                 });
+    for (std::uint32_t i = 0; i < boxes.size(); ++i)
+    {
+      std::uint32_t expected = 0;
+      for (std::uint32_t k = 0; k < n; ++k)
+        expected |= (active >> k) & 1 && vml::ray::intersect_box(rays[k], boxes[i], 2.0f) >= 0.0f ? 1u << k : 0u;
+      CHECK(masks[i] == expected);
+      found += expected != 0;
+    }
+
+    // Closest triangle, t_max drops with every hit so farther boxes are skipped
+    std::uint32_t nearest[n];
+    std::fill_n(nearest, n, ray_packetn::k_no_hit);
+    tree.raycast(p, active,
+                 [&](std::uint32_t index, std::uint32_t mask)
+                 {
+                   typename ray_packetn::hit_type hit;
+                   std::uint32_t const            m =
+                     ray_packetn::intersect_triangles(p, {&triangles[index * 3], 3}, mask, hit);
+                   for (std::uint32_t k = 0; k < n; ++k)
+                   {
+                     if ((m >> k) & 1)
+                       nearest[k] = index;
+                   }
+                 });
+    typename ray_packetn::type     all = ray_packetn::set(rays, 2.0f);
+    typename ray_packetn::hit_type hit;
+    ray_packetn::intersect_triangles(all, triangles, active, hit);
+    for (std::uint32_t k = 0; k < n; ++k)
+      CHECK(nearest[k] == hit.triangle[k]);
+  }
+  CHECK(found > 0);
+}
+} // namespace
+
+TEST_CASE("Validate ray_packet", "[ray_packet]")
+{
+  vml_test::rng            rng{29};
+  std::vector<vml::aabb_t> boxes(300);
+  vml_test::quad_vector    triangles(boxes.size() * 3);
+  for (std::uint32_t i = 0; i < boxes.size(); ++i)
+  {
+    vml::vec3a_t const c = rng.point(60.0f);
+    for (std::uint32_t v = 0; v < 3; ++v)
+      triangles[i * 3 + v] = vml::vec3a::add(c, rng.point(8.0f));
+    boxes[i] = vml::aabb::set_min_max(vml::vec3a::min(triangles[i * 3], vml::vec3a::min(triangles[i * 3 + 1],
+                                                                                       triangles[i * 3 + 2])),
+                                      vml::vec3a::max(triangles[i * 3], vml::vec3a::max(triangles[i * 3 + 1],
+                                                                                       triangles[i * 3 + 2])));
+  }
+  ray_packet_test_boxes<vml::quad>(boxes, triangles);
+  ray_packet_test_boxes<vml::quad8>(boxes, triangles);
+
+  vml::bvh tree;
+  tree.build(boxes);
+  ray_packet_test_bvh<vml::quad>(tree, boxes, triangles);
+  ray_packet_test_bvh<vml::quad8>(tree, boxes, triangles);
+
+  // Rays spreading over more than a half space have no bounding planes
+  vml::ray_t rays[4];
+  for (std::uint32_t k = 0; k < 4; ++k)
+    rays[k] = vml::ray::set(vml::vec3a::zero(), vml::vec3a::set(k & 1 ? 1.0f : -1.0f, k & 2 ? 0.5f : -0.5f, 0.0f));
+  vml::plane_t planes[6];
+  CHECK(vml::ray_packet4::bounding_planes(vml::ray_packet4::set(rays, 10.0f), planes) == 0);
+  CHECK(vml::ray_packet4::bounding_planes(
+          vml::ray_packet4::set(rays, std::numeric_limits<float>::infinity()), planes) == 0);
+  rays[1] = rays[2] = rays[3] = rays[0];
+  CHECK(vml::ray_packet4::bounding_planes(
+          vml::ray_packet4::set(rays, std::numeric_limits<float>::infinity()), planes) == 5);
+}
+
+TEST_CASE("Benchmark bvh packet raycast", "[.benchmark][ray_packet]")
+{
+  vml_test::rng            rng{29};
+  std::vector<vml::aabb_t> boxes(20000);
+  for (auto& b : boxes)
+    b = vml::aabb::set(rng.point(60.0f), vml::vec3a::set(rng.next() + 0.2f, rng.next() + 0.2f, rng.next() + 0.2f));
+  vml::bvh tree;
+  tree.build(boxes);
+
+  // Coherent packets, as from neighbouring pixels
+  std::vector<vml::ray_t>             rays;
+  std::vector<vml::ray_packet8::type> packets(256);
+  for (auto& p : packets)
+  {
+    vml::ray_t group[8];
+    p = ray_packet_test_rays<vml::quad8>(rng, 100.0f, group);
+    rays.insert(rays.end(), group, group + 8);
+  }
+
+  auto const per_ray = [&]
+  {
+    std::uint32_t hits = 0;
+    for (vml::ray_t const& r : rays)
+      tree.raycast(r, 100.0f,
+                   [&hits](std::uint32_t, float)
+                   {
+                     hits++;
+                   });
+    return hits;
+  };
+  auto const per_packet = [&]
+  {
+    std::uint32_t hits = 0;
+    for (vml::ray_packet8::type& p : packets)
+      tree.raycast(p, vml::ray_packet8::all_active,
+                   [&hits](std::uint32_t, std::uint32_t mask)
+                   {
+                     hits += std::popcount(mask);
+                   });
+    return hits;
+  };
+  CHECK(per_ray() == per_packet());
+
+  BENCHMARK("bvh::raycast 2048 rays one by one")
+  {
+    return per_ray();
+  };
+  BENCHMARK("bvh::raycast 2048 rays in packets of 8")
+  {
+    return per_packet();
+  };
+  // Catch reports times only
+  std::uint32_t const ray_count = static_cast<std::uint32_t>(rays.size());
+  WARN("bvh::raycast one by one: " << ray_packet_test_rays_per_second(ray_count, per_ray) / 1e6 << " Mrays/s");
+  WARN("bvh::raycast in packets of 8: " << ray_packet_test_rays_per_second(ray_count, per_packet) / 1e6
+                                         << " Mrays/s");
+}
@@ -0,0 +1,140 @@
+#include <catch2/catch.hpp>
+#include <vector>
+#include <vml.hpp>
+
+namespace
+{
+// The value types are template parameters: naming soa_vector<vml::vec3a_t> in a test warns under
+// -Wignored-attributes in SSE builds, explicit arguments of a function template do not
+template <typename value_t, typename lane>
+void soa_vector_test_insert()
+{
+  vml::soa_vector<value_t, lane> v;
+  std::vector<std::uint32_t>     indices;
+  for (std::uint32_t i = 0; i < 19; ++i)
+  {
+    float f = static_cast<float>(i);
+    indices.push_back(v.insert(vml::vec3a::set(f, 2.0f * f, -f)));
+  }
+  CHECK(v.size() == 19);
+  CHECK(v.block_count() == (19 + lane::element_count - 1) / lane::element_count);
+  CHECK(v.full_block_count() == 19 / lane::element_count);
+
+  // erase a few, the rest keep their index
+  v.erase(indices[0]);
+  v.erase(indices[7]);
+  v.erase(indices[18]);
+  CHECK(v.size() == 16);
+  CHECK(!v.contains(indices[7]));
+  for (std::uint32_t i = 0; i < 19; ++i)
+  {
+    if (i == 0 || i == 7 || i == 18)
+      continue;
+    float f = static_cast<float>(i);
+    CHECK(vml::vec3a::equals(v.get(indices[i]), vml::vec3a::set(f, 2.0f * f, -f)));
+    CHECK(v.index_at(v.position(indices[i])) == indices[i]);
+  }
+
+  // freed indices are reused
+  std::uint32_t reused = v.insert(vml::vec3a::set(100.0f));
+  CHECK(v.contains(reused));
+  CHECK(vml::vec3a::equals(v.get(reused), vml::vec3a::set(100.0f)));
+  v.set(reused, vml::vec3a::set(1.0f, 2.0f, 3.0f));
+  CHECK(vml::vec3a::equals(v.get(reused), vml::vec3a::set(1.0f, 2.0f, 3.0f)));
+
+  vml::soa_vector<value_t, lane> copy = v;
+  CHECK(copy.size() == v.size());
+  CHECK(vml::vec3a::equals(copy.get(reused), vml::vec3a::set(1.0f, 2.0f, 3.0f)));
+  vml::soa_vector<value_t, lane> moved = std::move(copy);
+  CHECK(moved.size() == v.size());
+  CHECK(copy.size() == 0);
+  moved.clear();
+  CHECK(moved.empty());
+}
+
+template <typename value_t, typename lane>
+void soa_vector_test_block()
+{
+  vml::soa_vector<value_t, lane> v;
+  std::uint32_t const            n = 2 * lane::element_count + 3;
+  for (std::uint32_t i = 0; i < n; ++i)
+    v.insert(vml::vec3a::set(static_cast<float>(i), 1.0f, 2.0f));
+
+  std::uint32_t blocks = 0;
+  std::uint32_t total  = 0;
+  float         sum    = 0.0f;
+  v.for_each_block(
+    [&](auto b)
+    {
+      CHECK(reinterpret_cast<std::uintptr_t>(b.data) % alignof(typename lane::type) == 0);
+      blocks++;
+      total += b.count;
+      auto x = lane::select(lane::zero(), b.load(0), b.lane_mask());
+      auto y = lane::select(lane::zero(), b.load(1), b.lane_mask());
+      b.store(2, lane::add(x, y));
+      sum += lane::hadd(x);
+      CHECK(b.mask() == (1u << b.count) - 1);
+    });
+  CHECK(blocks == 3);
+  CHECK(total == n);
+  CHECK(sum == Approx(static_cast<float>(n * (n - 1) / 2)));
+  CHECK(v.block_at(2).count == 3);
+  for (std::uint32_t p = 0; p < n; ++p)
+    CHECK(vml::vec3a::z(v.at_position(p)) == Approx(static_cast<float>(p) + 1.0f));
+}
+
+//! value and its w survive the round trip, w is the fourth component
+template <typename value_t, typename lane>
+void soa_vector_test_round_trip(value_t const& value)
+{
+  static_assert(vml::soa_vector<value_t, lane>::component_count == 4);
+  vml::soa_vector<value_t, lane> v;
+  auto const                     i = v.insert(value);
+  CHECK(vml::quad::equals(v.get(i), value));
+  CHECK(vml::quad::w(v.get(i)) == Approx(vml::quad::w(value)));
+  CHECK(lane::get(v.block_at(0).load(3), 0) == Approx(vml::quad::w(value)));
+}
+} // namespace
+
+TEMPLATE_TEST_CASE("Validate soa_vector::insert", "[soa_vector::insert]", vml::quad, vml::quad8)
+{
+  soa_vector_test_insert<vml::vec3a_t, TestType>();
+}
+
+TEMPLATE_TEST_CASE("Validate soa_vector::block", "[soa_vector::block]", vml::quad, vml::quad8)
+{
+  soa_vector_test_block<vml::vec3a_t, TestType>();
+}
+
+TEST_CASE("Validate soa_vector::types", "[soa_vector::types]")
+{
+  vml::aabb_t            box = vml::aabb::set(vml::vec3a::set(1.0f, 2.0f, 3.0f), vml::vec3a::set(0.5f));
+  vml::bounding_volume_t bv  = vml::bounding_volume::from_box(vml::vec3a::set(4.0f), vml::vec3a::set(2.0f));
+  vml::transform_t       t   = vml::transform::identity();
+  vml::transform::set_translation(t, vml::vec3a::set(7.0f, 8.0f, 9.0f));
+  vml::transform::set_scale(t, 3.0f);
+
+  vml::soa_vector<vml::aabb_t, vml::quad8> boxes;
+  vml::soa_vector<vml::transform_t>        transforms;
+  vml::soa_vector<vml::bounding_volume_t>  volumes;
+
+  auto ib = boxes.insert(box);
+  auto it = transforms.insert(t);
+  auto iv = volumes.insert(bv);
+  CHECK(vml::vec3a::equals(vml::aabb::center(boxes.get(ib)), vml::vec3a::set(1.0f, 2.0f, 3.0f)));
+  CHECK(vml::vec3a::equals(vml::aabb::half_size(boxes.get(ib)), vml::vec3a::set(0.5f)));
+  CHECK(vml::transform::scale(transforms.get(it)) == Approx(3.0f));
+  CHECK(vml::vec3a::equals(vml::transform::translation(transforms.get(it)), vml::vec3a::set(7.0f, 8.0f, 9.0f)));
+  CHECK(vml::quad::equals(transforms.get(it).rotation, vml::quat::identity()));
+  CHECK(vml::quad::equals(volumes.get(iv).spherical_vol, bv.spherical_vol));
+  CHECK(vml::vec3a::equals(volumes.get(iv).half_extends, bv.half_extends));
+  CHECK(vml::quad::equals(volumes.get(iv).orig_spherical_vol, bv.orig_spherical_vol));
+}
+
+TEST_CASE("Validate soa_vector::quad types", "[soa_vector::types]")
+{
+  // quat_t, sphere_t and plane_t share the vec3a_t type, their w must survive the round trip
+  soa_vector_test_round_trip<vml::quat_t, vml::quad8>(
+    vml::quat::from_axis_angle(vml::vec3::set(0.0f, 1.0f, 0.0f), 0.5f));
+  soa_vector_test_round_trip<vml::sphere_t, vml::quad>(vml::sphere::set(vml::vec3a::set(1.0f, 2.0f, 3.0f), 4.0f));
+}
@@ -0,0 +1,129 @@
+#include "test_common.hpp"
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <utility>
+#include <vector>
+#include <vml.hpp>
+
+namespace
+{
+vml_test::quad_vector hash_grid_test_spheres(std::uint32_t count, float max_radius)
+{
+  vml_test::rng         rng{3};
+  vml_test::quad_vector spheres(count);
+  for (auto& s : spheres)
+  {
+    vml::vec3a_t c =
+      vml::vec3a::set(rng.next() * 60.0f - 30.0f, rng.next() * 60.0f - 30.0f, rng.next() * 20.0f - 10.0f);
+    s              = vml::sphere::set(c, rng.next() * max_radius);
+  }
+  return spheres;
+}
+
+bool hash_grid_test_overlap(vml::sphere_t const& a, vml::sphere_t const& b, float distance)
+{
+  float const reach = distance + vml::sphere::radius(a) + vml::sphere::radius(b);
+  return vml::vec3a::sqdistance(vml::sphere::center(a), vml::sphere::center(b)) <= reach * reach;
+}
+
+std::vector<std::uint32_t> hash_grid_test_query(vml::spatial_hash_grid const& grid, vml::sphere_t const& s)
+{
+  std::vector<std::uint32_t> found;
+  grid.query(s,
+             [&found](std::uint32_t i)
+             {
+               found.push_back(i);
+             });
+  std::sort(found.begin(), found.end());
+  return found;
+}
+
+void hash_grid_test_check(vml::spatial_hash_grid const& grid, vml_test::quad_vector const& spheres)
+{
+  REQUIRE(grid.size() == spheres.size());
+  for (vml::sphere_t const& q : {vml::sphere::set(vml::vec3a::set(1.0f, -2.0f, 0.5f), 4.0f),
+                                 vml::sphere::set(vml::vec3a::set(-29.0f, 29.0f, 9.0f), 5.0f),
+                                 vml::sphere::set(vml::vec3a::zero(), 500.0f)})
+  {
+    std::vector<std::uint32_t> expected;
+    for (std::uint32_t i = 0; i < spheres.size(); ++i)
+    {
+      if (hash_grid_test_overlap(q, spheres[i], 0.0f))
+        expected.push_back(i);
+    }
+    CHECK(!expected.empty());
+    CHECK(hash_grid_test_query(grid, q) == expected);
+  }
+
+  vml::vec3a_t const         point = vml::vec3a::set(-3.5f, 7.25f, 2.0f);
+  std::vector<std::uint32_t> by_distance(spheres.size());
+  for (std::uint32_t i = 0; i < spheres.size(); ++i)
+    by_distance[i] = i;
+  std::sort(by_distance.begin(), by_distance.end(),
+            [&](std::uint32_t a, std::uint32_t b)
+            {
+              return vml::vec3a::sqdistance(point, vml::sphere::center(spheres[a])) <
+                     vml::vec3a::sqdistance(point, vml::sphere::center(spheres[b]));
+            });
+  // More than k_nearest_local_size results take the allocating path
+  for (std::uint32_t k : {10u, vml::spatial_hash_grid::k_nearest_local_size + 36})
+  {
+    std::vector<std::uint32_t> nearest(k);
+    REQUIRE(grid.nearest(point, nearest) == k);
+    CHECK(nearest == std::vector<std::uint32_t>(by_distance.begin(), by_distance.begin() + k));
+  }
+
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> expected_pairs;
+  for (std::uint32_t i = 0; i < spheres.size(); ++i)
+  {
+    for (std::uint32_t j = i + 1; j < spheres.size(); ++j)
+    {
+      if (hash_grid_test_overlap(spheres[i], spheres[j], 1.0f))
+        expected_pairs.emplace_back(i, j);
+    }
+  }
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> found_pairs;
+  grid.query_pairs(1.0f,
+                   [&found_pairs](std::uint32_t a, std::uint32_t b)
+                   {
+                     CHECK(a < b);
+                     found_pairs.emplace_back(a, b);
+                   });
+  std::sort(found_pairs.begin(), found_pairs.end());
+  CHECK(!expected_pairs.empty());
+  CHECK(found_pairs == expected_pairs);
+}
+} // namespace
+
+TEST_CASE("Validate spatial_hash_grid", "[spatial_hash_grid]")
+{
+  vml::spatial_hash_grid grid(2.0f);
+  CHECK(grid.cell(vml::vec3a::set(-0.5f, 3.9f, 4.0f)) == vml::ivec3_t{-1, 1, 2});
+
+  vml_test::quad_vector spheres = hash_grid_test_spheres(1500, 1.0f);
+  grid.build(spheres);
+  hash_grid_test_check(grid, spheres);
+
+  vml_test::quad_vector points(spheres.size());
+  for (std::size_t i = 0; i < spheres.size(); ++i)
+  {
+    points[i]  = vml::sphere::center(spheres[i]);
+    spheres[i] = vml::sphere::set(points[i], 0.0f);
+  }
+  grid.build_points(points);
+  hash_grid_test_check(grid, spheres);
+
+  // Two far clusters make the rings sparse
+  vml_test::quad_vector sparse = hash_grid_test_spheres(40, 0.5f);
+  for (std::size_t i = 0; i < sparse.size(); i += 2)
+    sparse[i] = vml::quad::add(sparse[i], vml::vec3a::set(4000.0f, 0.0f, 0.0f));
+  grid.build(sparse);
+  std::uint32_t nearest[3];
+  REQUIRE(grid.nearest(vml::vec3a::set(5000.0f, 0.0f, 0.0f), nearest) == 3);
+  for (std::uint32_t i : nearest)
+    CHECK(i % 2 == 0);
+
+  grid.build(vml_test::quad_vector());
+  CHECK(grid.nearest(vml::vec3a::zero(), nearest) == 0);
+  CHECK(hash_grid_test_query(grid, vml::sphere::set(vml::vec3a::zero(), 10.0f)).empty());
+}
@@ -0,0 +1,105 @@
+#include "test_common.hpp"
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <utility>
+#include <vector>
+#include <vml.hpp>
+
+namespace
+{
+std::vector<std::pair<std::uint32_t, std::uint32_t>> sap_test_pairs(vml::sweep_and_prune const& sap)
+{
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> result;
+  for (auto const& p : sap.pairs())
+  {
+    CHECK(p.a < p.b);
+    result.emplace_back(p.a, p.b);
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+std::vector<std::pair<std::uint32_t, std::uint32_t>> sap_test_brute_force(std::vector<vml::aabb_t> const& boxes)
+{
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> result;
+  for (std::uint32_t i = 0; i < boxes.size(); ++i)
+  {
+    for (std::uint32_t j = i + 1; j < boxes.size(); ++j)
+    {
+      if (!vml::vec3a::greater_any(boxes[i].r[0], boxes[j].r[1]) &&
+          !vml::vec3a::greater_any(boxes[j].r[0], boxes[i].r[1]))
+        result.emplace_back(i, j);
+    }
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("Validate sweep_and_prune", "[sweep_and_prune]")
+{
+  vml_test::rng            rng{5};
+  std::vector<vml::aabb_t> boxes(800);
+  for (auto& b : boxes)
+  {
+    vml::vec3a_t c = vml::vec3a::set(rng.next() * 50.0f - 25.0f, rng.next() * 200.0f, rng.next() * 50.0f);
+    b              = vml::aabb::set(c, vml::vec3a::set(rng.next() + 0.5f, rng.next() + 0.5f, rng.next() + 0.5f));
+  }
+
+  vml::sweep_and_prune sap;
+  CHECK(sap.axis() == 3);
+  sap.update(boxes);
+  // Centers spread the most along y
+  CHECK(sap.axis() == 1);
+  auto expected = sap_test_brute_force(boxes);
+  CHECK(!expected.empty());
+  CHECK(sap_test_pairs(sap) == expected);
+
+  // Small motions keep the order nearly sorted
+  for (std::uint32_t frame = 0; frame < 4; ++frame)
+  {
+    for (auto& b : boxes)
+    {
+      vml::vec3a_t d = vml::vec3a::set(rng.next() - 0.5f, rng.next() - 0.5f, rng.next() - 0.5f);
+      b              = vml::aabb::set_min_max(vml::vec3a::add(b.r[0], d), vml::vec3a::add(b.r[1], d));
+    }
+    sap.update(boxes);
+    CHECK(sap_test_pairs(sap) == sap_test_brute_force(boxes));
+  }
+
+  // Reversing the boxes is too many moves for the insertion sort
+  std::reverse(boxes.begin(), boxes.end());
+  sap.update(boxes);
+  CHECK(sap_test_pairs(sap) == sap_test_brute_force(boxes));
+
+  // Spreading along x switches the axis
+  for (std::uint32_t i = 0; i < boxes.size(); ++i)
+  {
+    vml::vec3a_t d = vml::vec3a::set(static_cast<float>(i) * 2.0f, 0.0f, 0.0f);
+    boxes[i]       = vml::aabb::set_min_max(vml::vec3a::add(boxes[i].r[0], d), vml::vec3a::add(boxes[i].r[1], d));
+  }
+  boxes.resize(500);
+  sap.update(boxes);
+  CHECK(sap.axis() == 0);
+  CHECK(sap_test_pairs(sap) == sap_test_brute_force(boxes));
+
+  sap.update(std::span<vml::aabb_t const>());
+  CHECK(sap.pairs().empty());
+}
+
+TEST_CASE("Validate sweep_and_prune axis far from the origin", "[sweep_and_prune]")
+{
+  // The spread of the centers is small next to their distance from the origin
+  vml_test::rng            rng{17};
+  std::vector<vml::aabb_t> boxes(200);
+  for (auto& b : boxes)
+  {
+    vml::vec3a_t c = vml::vec3a::set(20000.0f + rng.next() * 2.0f, 20000.0f + rng.next() * 8.0f,
+                                     20000.0f + rng.next() * 2.0f);
+    b              = vml::aabb::set(c, vml::vec3a::set(0.1f, 0.1f, 0.1f));
+  }
+
+  vml::sweep_and_prune sap;
+  sap.update(boxes);
+  CHECK(sap.axis() == 1);
+  CHECK(sap_test_pairs(sap) == sap_test_brute_force(boxes));
+}
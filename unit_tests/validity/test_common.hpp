@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <vml.hpp>
+
+//! Helpers shared by the validity tests
+namespace vml_test
+{
+//! Linear congruential generator, tests seed it so their inputs are the same on every run
+struct rng
+{
+  std::uint32_t seed = 1;
+
+  //! Uniform in [0, 1)
+  inline float next()
+  {
+    seed = seed * 1664525u + 1013904223u;
+    return static_cast<float>(seed >> 8) / static_cast<float>(1u << 24);
+  }
+
+  //! Uniform in the cube of side scale centered at the origin
+  inline vml::vec3a_t point(float scale)
+  {
+    return vml::vec3a::set((next() - 0.5f) * scale, (next() - 0.5f) * scale, (next() - 0.5f) * scale);
+  }
+};
+
+/**
+ * @remarks Growable array of quad_t values, for the vec3a_t, sphere_t and plane_t inputs of the
+ * tests. std::vector and std::span of these SSE types drop their alignment attribute and warn
+ * (-Wignored-attributes), so values are kept wrapped in an aligned struct. Contiguous, it converts
+ * to the std::span arguments of the library.
+ */
+class quad_vector
+{
+public:
+  quad_vector() = default;
+  explicit quad_vector(std::size_t count, vml::quad_t const& value = vml::quad::zero()) : items(count, {value}) {}
+  quad_vector(vml::quad_t const* first, vml::quad_t const* last)
+  {
+    for (; first != last; ++first)
+      push_back(*first);
+  }
+
+  inline vml::quad_t* data() noexcept
+  {
+    return reinterpret_cast<vml::quad_t*>(items.data());
+  }
+
+  inline vml::quad_t const* data() const noexcept
+  {
+    return reinterpret_cast<vml::quad_t const*>(items.data());
+  }
+
+  inline std::size_t size() const noexcept
+  {
+    return items.size();
+  }
+
+  inline bool empty() const noexcept
+  {
+    return items.empty();
+  }
+
+  inline vml::quad_t* begin() noexcept
+  {
+    return data();
+  }
+
+  inline vml::quad_t* end() noexcept
+  {
+    return data() + size();
+  }
+
+  inline vml::quad_t const* begin() const noexcept
+  {
+    return data();
+  }
+
+  inline vml::quad_t const* end() const noexcept
+  {
+    return data() + size();
+  }
+
+  inline vml::quad_t& operator[](std::size_t i) noexcept
+  {
+    return items[i].value;
+  }
+
+  inline vml::quad_t const& operator[](std::size_t i) const noexcept
+  {
+    return items[i].value;
+  }
+
+  inline void push_back(vml::quad_t const& value)
+  {
+    items.push_back({value});
+  }
+
+private:
+  struct alignas(16) item
+  {
+    vml::quad_t value;
+  };
+
+  std::vector<item> items;
+};
+
+//! Slab test with divisions, the reference for ray and box queries. Distance of entry within [0, t_max], -1 on a miss
+inline float ray_box_entry(vml::aabb_t const& box, vml::vec3a_t const& origin, vml::vec3a_t const& direction,
+                           float t_max)
+{
+  float enter = 0.0f;
+  float exit  = t_max;
+  for (std::uint32_t a = 0; a < 3; ++a)
+  {
+    float o  = vml::quad::get(origin, a);
+    float d  = vml::quad::get(direction, a);
+    float lo = vml::quad::get(box.r[0], a);
+    float hi = vml::quad::get(box.r[1], a);
+    if (d == 0.0f)
+    {
+      if (o < lo || o > hi)
+        return -1.0f;
+      continue;
+    }
+    enter = std::max(enter, std::min((lo - o) / d, (hi - o) / d));
+    exit  = std::min(exit, std::max((lo - o) / d, (hi - o) / d));
+  }
+  return enter <= exit ? enter : -1.0f;
+}
+} // namespace vml_test
@@ -0,0 +1,109 @@
+#include <catch2/catch.hpp>
+#include <vml.hpp>
+
+namespace
+{
+vml::transform_t make_local(std::uint32_t i)
+{
+  float            f = static_cast<float>(i);
+  vml::transform_t t;
+  vml::transform::set_rotation(
+    t, vml::quat::from_axis_angle(vml::vec3_t{0.0f, 1.0f, 0.0f}, vml::to_radians(static_cast<float>(i % 7) * 10.0f)));
+  t.translation_and_scale = vml::vec4::set(0.5f * f, 1.0f, -0.25f * f, 1.0f + static_cast<float>(i % 3) * 0.1f);
+  return t;
+}
+
+//! Walk up the parents and combine, the reference for transform_hierarchy::world
+vml::transform_t expected_world(vml::transform_hierarchy const& h, vml::transform_hierarchy::index_type n)
+{
+  vml::transform_hierarchy::index_type p = h.parent(n);
+  if (p == vml::transform_hierarchy::k_null)
+    return h.local(n);
+  return vml::transform::combine(expected_world(h, p), h.local(n));
+}
+
+void check(vml::transform_hierarchy const& h, std::vector<vml::transform_hierarchy::index_type> const& nodes)
+{
+  for (auto n : nodes)
+  {
+    if (!h.contains(n))
+      continue;
+    vml::transform_t r = h.world(n);
+    vml::transform_t e = expected_world(h, n);
+    for (std::uint32_t c = 0; c < 4; ++c)
+    {
+      CHECK(vml::quad::get(r.rotation, c) == Approx(vml::quad::get(e.rotation, c)).margin(1e-4f));
+      CHECK(vml::quad::get(r.translation_and_scale, c) ==
+            Approx(vml::quad::get(e.translation_and_scale, c)).epsilon(1e-4f).margin(1e-4f));
+    }
+  }
+}
+} // namespace
+
+TEST_CASE("Validate transform::combine batch", "[transform::combine batch]")
+{
+  constexpr std::uint32_t       k_count = 19;
+  std::vector<vml::transform_t> parents(k_count);
+  std::vector<vml::transform_t> locals(k_count);
+  std::vector<vml::transform_t> result(k_count);
+  for (std::uint32_t i = 0; i < k_count; ++i)
+  {
+    parents[i] = make_local(i + 3);
+    locals[i]  = make_local(i * 5);
+  }
+  vml::transform::combine(parents, locals, result);
+  for (std::uint32_t i = 0; i < k_count; ++i)
+  {
+    vml::transform_t e = vml::transform::combine(parents[i], locals[i]);
+    for (std::uint32_t c = 0; c < 4; ++c)
+    {
+      CHECK(vml::quad::get(result[i].rotation, c) == Approx(vml::quad::get(e.rotation, c)).margin(1e-5f));
+      CHECK(vml::quad::get(result[i].translation_and_scale, c) ==
+            Approx(vml::quad::get(e.translation_and_scale, c)).margin(1e-4f));
+    }
+  }
+}
+
+TEST_CASE("Validate transform_hierarchy", "[transform_hierarchy]")
+{
+  vml::transform_hierarchy                          h;
+  std::vector<vml::transform_hierarchy::index_type> nodes;
+  // Parents are picked among earlier nodes, every 10th node is a root
+  for (std::uint32_t i = 0; i < 200; ++i)
+    nodes.push_back(h.insert(make_local(i), i % 10 == 0 ? vml::transform_hierarchy::k_null : nodes[(i * 3) / 4]));
+  h.update();
+  CHECK(h.size() == 200);
+  CHECK(h.depth() > 2);
+  check(h, nodes);
+
+  // Only the subtree of the changed node is recomputed, but every world must be right
+  h.set_local(nodes[1], make_local(77));
+  h.set_local(nodes[55], make_local(78));
+  h.update();
+  check(h, nodes);
+
+  // Reparent a subtree, erase a leaf, insert into the freed index
+  h.set_parent(nodes[1], nodes[150]);
+  auto leaf = nodes[199];
+  h.erase(leaf);
+  CHECK(!h.contains(leaf));
+  nodes[199] = h.insert(make_local(5), nodes[3]);
+  CHECK(nodes[199] == leaf);
+  h.update();
+  check(h, nodes);
+
+  // A level wide enough to be split into tasks, run out of order by the executor
+  auto root = h.insert(make_local(1));
+  for (std::uint32_t i = 0; i < vml::transform_hierarchy::k_parallel_task_size + 100; ++i)
+    nodes.push_back(h.insert(make_local(i), root));
+  std::uint32_t tasks = 0;
+  h.update(
+    [&tasks](std::uint32_t task_count, auto const& task)
+    {
+      tasks += task_count;
+      for (std::uint32_t t = task_count; t > 0; --t)
+        task(t - 1);
+    });
+  CHECK(tasks == 2);
+  check(h, nodes);
+}
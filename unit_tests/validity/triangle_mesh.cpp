@@ -0,0 +1,178 @@
+#include "test_common.hpp"
+#include <catch2/catch.hpp>
+#include <vector>
+#include <vml.hpp>
+
+namespace
+{
+//! Vertex with other attributes after the position, as meshes are usually laid out
+struct triangle_mesh_test_vertex
+{
+  vml::vec3_t position;
+  float       uv[2];
+};
+
+//! Scalar Möller–Trumbore, t or negative on a miss
+float triangle_mesh_test_hit(vml::ray_t const& r, vml::vec3a_t const* v, float t_max, float& o_u, float& o_v)
+{
+  vml::vec3a_t const e1   = vml::vec3a::sub(v[1], v[0]);
+  vml::vec3a_t const e2   = vml::vec3a::sub(v[2], v[0]);
+  vml::vec3a_t const pvec = vml::vec3a::cross(r.direction, e2);
+  float const        det  = vml::vec3a::dot(e1, pvec);
+  if (std::abs(det) <= std::numeric_limits<float>::min())
+    return -1.0f;
+  vml::vec3a_t const tvec = vml::vec3a::sub(r.origin, v[0]);
+  vml::vec3a_t const qvec = vml::vec3a::cross(tvec, e1);
+  o_u                     = vml::vec3a::dot(tvec, pvec) / det;
+  o_v                     = vml::vec3a::dot(r.direction, qvec) / det;
+  float const t           = vml::vec3a::dot(e2, qvec) / det;
+  return o_u >= 0.0f && o_v >= 0.0f && o_u + o_v <= 1.0f && t >= 0.0f && t <= t_max ? t : -1.0f;
+}
+
+template <typename lane>
+void triangle_mesh_test_kernel(vml::ray_t const& r, vml_test::quad_vector const& vertices)
+{
+  using rayxn                   = vml::rayxn<lane>;
+  constexpr std::uint32_t    n  = rayxn::element_count;
+  typename rayxn::type const rl = rayxn::set(r);
+  for (std::uint32_t i = 0; i + n * 3 <= vertices.size(); i += n * 3)
+  {
+    typename lane::type t, u, v;
+    std::uint32_t const hits = rayxn::intersect_triangles(rl, &vertices[i], 50.0f, t, u, v);
+    for (std::uint32_t k = 0; k < n; ++k)
+    {
+      float       eu, ev;
+      float const expected = triangle_mesh_test_hit(r, &vertices[i + k * 3], 50.0f, eu, ev);
+      CHECK(((hits >> k) & 1) == (expected >= 0.0f ? 1u : 0u));
+      if (expected < 0.0f)
+        continue;
+      CHECK(lane::get(t, k) == Approx(expected).margin(1e-4f));
+      CHECK(lane::get(u, k) == Approx(eu).margin(1e-4f));
+      CHECK(lane::get(v, k) == Approx(ev).margin(1e-4f));
+    }
+  }
+}
+
+template <typename mesh_t>
+void triangle_mesh_test_raycast(std::vector<triangle_mesh_test_vertex> const& vertices,
+                                std::vector<std::uint32_t> const& indices, std::uint32_t seed)
+{
+  mesh_t mesh;
+  mesh.build(&vertices[0].position, sizeof(triangle_mesh_test_vertex), indices);
+  REQUIRE(mesh.size() == indices.size() / 3);
+
+  vml_test::quad_vector corners(indices.size());
+  for (std::uint32_t i = 0; i < indices.size(); ++i)
+  {
+    vml::vec3_t const& p = vertices[indices[i]].position;
+    corners[i]           = vml::vec3a::set(p[0], p[1], p[2]);
+  }
+
+  vml_test::rng rng{seed};
+  std::uint32_t hits = 0;
+  for (std::uint32_t q = 0; q < 200; ++q)
+  {
+    vml::ray_t const r       = vml::ray::from_points(rng.point(80.0f), rng.point(20.0f));
+    float            nearest = 2.0f;
+    std::uint32_t    index   = mesh_t::k_no_hit;
+    for (std::uint32_t i = 0; i < corners.size() / 3; ++i)
+    {
+      float       u, v;
+      float const t = triangle_mesh_test_hit(r, &corners[i * 3], nearest, u, v);
+      if (t >= 0.0f)
+      {
+        nearest = t;
+        index   = i;
+      }
+    }
+
+    typename mesh_t::hit_type hit{-1.0f, 0.0f, 0.0f, mesh_t::k_no_hit};
+    bool const                found = mesh.raycast(r, 2.0f, hit);
+    CHECK(found == (index != mesh_t::k_no_hit));
+    if (!found)
+    {
+      CHECK(hit.t == -1.0f);
+      continue;
+    }
+    hits++;
+    CHECK(hit.t == Approx(nearest).margin(1e-4f));
+    // Triangles sharing the hit point may come in any order, compare the point
+    vml::vec3a_t const* v     = &corners[hit.triangle * 3];
+    vml::vec3a_t const  point = vml::vec3a::madd(vml::vec3a::sub(v[1], v[0]), vml::vec3a::set(hit.u),
+                                                 vml::vec3a::madd(vml::vec3a::sub(v[2], v[0]), vml::vec3a::set(hit.v),
+                                                                  v[0]));
+    CHECK(vml::vec3a::distance(point, vml::ray::at(r, hit.t)) == Approx(0.0f).margin(1e-3f));
+  }
+  CHECK(hits > 0);
+}
+} // namespace
+
+TEST_CASE("Validate rayxn triangles", "[triangle_mesh]")
+{
+  vml_test::rng         rng{71};
+  vml_test::quad_vector vertices(8 * 3 * 40);
+  for (std::uint32_t i = 0; i < vertices.size(); i += 3)
+  {
+    vml::vec3a_t const c = rng.point(20.0f);
+    for (std::uint32_t v = 0; v < 3; ++v)
+      vertices[i + v] = vml::vec3a::add(c, rng.point(12.0f));
+  }
+  // Degenerate triangles never hit
+  vertices[3] = vertices[4] = vertices[5];
+
+  for (std::uint32_t i = 0; i < 64; ++i)
+  {
+    vml::ray_t const r = vml::ray::set(rng.point(40.0f), rng.point(2.0f));
+    triangle_mesh_test_kernel<vml::quad>(r, vertices);
+    triangle_mesh_test_kernel<vml::quad8>(r, vertices);
+  }
+}
+
+TEST_CASE("Validate triangle_mesh", "[triangle_mesh]")
+{
+  // A height field of 40 x 40 quads, indexed
+  constexpr std::uint32_t                side = 41;
+  std::vector<triangle_mesh_test_vertex> grid(side * side);
+  for (std::uint32_t z = 0; z < side; ++z)
+  {
+    for (std::uint32_t x = 0; x < side; ++x)
+    {
+      float const h      = std::sin(x * 0.4f) * std::cos(z * 0.3f) * 4.0f;
+      grid[z * side + x] = {vml::vec3::set(x - 20.0f, h, z - 20.0f), {0.0f, 0.0f}};
+    }
+  }
+  std::vector<std::uint32_t> grid_indices;
+  for (std::uint32_t z = 0; z + 1 < side; ++z)
+  {
+    for (std::uint32_t x = 0; x + 1 < side; ++x)
+    {
+      std::uint32_t const i = z * side + x;
+      grid_indices.insert(grid_indices.end(), {i, i + side, i + 1, i + 1, i + side, i + side + 1});
+    }
+  }
+  triangle_mesh_test_raycast<vml::triangle_mesh4>(grid, grid_indices, 3);
+  triangle_mesh_test_raycast<vml::triangle_mesh8>(grid, grid_indices, 3);
+
+  // Triangle soup, with a count that leaves a partial block
+  vml_test::rng                          rng{71};
+  std::vector<triangle_mesh_test_vertex> soup(3 * 501);
+  std::vector<std::uint32_t>             soup_indices(soup.size());
+  vml::vec3a_t                           center = vml::vec3a::zero();
+  for (std::uint32_t i = 0; i < soup.size(); ++i)
+  {
+    if (i % 3 == 0)
+      center = rng.point(50.0f);
+    vml::vec3a_t const p = vml::vec3a::add(center, rng.point(10.0f));
+    soup[i]              = {vml::vec3::set(vml::vec3a::x(p), vml::vec3a::y(p), vml::vec3a::z(p)), {0.0f, 0.0f}};
+    // Reverse the vertex order so indices do not follow the stream
+    soup_indices[i] = static_cast<std::uint32_t>(soup.size() - 1 - i);
+  }
+  triangle_mesh_test_raycast<vml::triangle_mesh4>(soup, soup_indices, 9);
+  triangle_mesh_test_raycast<vml::triangle_mesh8>(soup, soup_indices, 9);
+
+  vml::triangle_mesh mesh;
+  mesh.build(&soup[0].position, sizeof(triangle_mesh_test_vertex), std::span<std::uint32_t const>());
+  CHECK(mesh.empty());
+  vml::triangle_mesh::hit_type hit;
+  CHECK(!mesh.raycast(vml::ray::set(vml::vec3a::zero(), vml::vec3a::set(1.0f, 0.0f, 0.0f)), 10.0f, hit));
+}
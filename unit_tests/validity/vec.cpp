@@ -17,7 +17,13 @@ TEST_CASE("Validate vec3a::compare", "[vec3a::compare]")
   auto         copy = p;
   vml::vec3a_t q    = vml::vec3a::set(441.3f, 5.0f, 51.0f);
   vml::vec3a_t r    = vml::vec3a::set(445.3f, 15.0f, 151.0f);
+#if VML_USE_SSE_AVX && !defined(_MSC_VER)
+  // No operator== for the builtin __m128 of GCC and Clang
+  CHECK(!vml::vec3a::greater_any(p, copy));
+  CHECK(!vml::vec3a::lesser_any(p, copy));
+#else
   CHECK(p == copy);
+#endif
   CHECK(vml::vec3a::greater_any(p, q));
   CHECK(vml::vec3a::greater_all(p, q) == false);
   CHECK(vml::vec3a::lesser_any(p, q));
@@ -0,0 +1,75 @@
+#include <catch2/catch.hpp>
+#include <vml.hpp>
+
+TEMPLATE_TEST_CASE("Validate vec3xn::load", "[vec3xn::load]", vml::vec3x4, vml::vec3x8)
+{
+  using vec3xn = TestType;
+  vml::vec3a_t src[vec3xn::element_count];
+  vml::vec3_t  src3[vec3xn::element_count];
+  for (std::uint32_t i = 0; i < vec3xn::element_count; ++i)
+  {
+    float f = static_cast<float>(i);
+    src[i]  = vml::vec3a::set(f, f * 2.0f, -f);
+    src3[i] = {f + 1.0f, f * 3.0f, 4.0f};
+  }
+
+  typename vec3xn::type v  = vec3xn::load(src);
+  typename vec3xn::type v3 = vec3xn::load(src3);
+  vml::vec3a_t          dst[vec3xn::element_count];
+  vml::vec3_t           dst3[vec3xn::element_count];
+  vec3xn::store(dst, v);
+  vec3xn::store(dst3, v3);
+  for (std::uint32_t i = 0; i < vec3xn::element_count; ++i)
+  {
+    CHECK(vml::vec3a::equals(vec3xn::get(v, i), src[i]));
+    CHECK(vml::vec3a::equals(dst[i], src[i]));
+    CHECK(vml::vec3a::w(dst[i]) == 0.0f);
+    CHECK(dst3[i][0] == Approx(src3[i][0]));
+    CHECK(dst3[i][1] == Approx(src3[i][1]));
+    CHECK(dst3[i][2] == Approx(src3[i][2]));
+  }
+
+  v = vec3xn::set(vml::vec3a::set(1.0f, 2.0f, 3.0f));
+  for (std::uint32_t i = 0; i < vec3xn::element_count; ++i)
+    CHECK(vml::vec3a::equals(vec3xn::get(v, i), vml::vec3a::set(1.0f, 2.0f, 3.0f)));
+}
+
+TEMPLATE_TEST_CASE("Validate vec3xn::math", "[vec3xn::math]", vml::vec3x4, vml::vec3x8)
+{
+  using vec3xn = TestType;
+  using lane   = std::conditional_t<vec3xn::element_count == 4, vml::quad, vml::quad8>;
+  vml::vec3a_t a[vec3xn::element_count];
+  vml::vec3a_t b[vec3xn::element_count];
+  for (std::uint32_t i = 0; i < vec3xn::element_count; ++i)
+  {
+    float f = static_cast<float>(i) + 1.0f;
+    a[i]    = vml::vec3a::set(f, -2.0f * f, 0.5f);
+    b[i]    = vml::vec3a::set(3.0f, f, f * f);
+  }
+  typename vec3xn::type va = vec3xn::load(a);
+  typename vec3xn::type vb = vec3xn::load(b);
+
+  auto dot    = vec3xn::dot(va, vb);
+  auto len    = vec3xn::length(vb);
+  auto cross  = vec3xn::cross(va, vb);
+  auto norm   = vec3xn::normalize(vb);
+  auto sum    = vec3xn::add(va, vb);
+  auto diff   = vec3xn::sub(va, vb);
+  auto lerp   = vec3xn::lerp(va, vb, lane::set(0.25f));
+  auto mn     = vec3xn::min(va, vb);
+  auto mx     = vec3xn::max(va, vb);
+  auto madded = vec3xn::madd(va, vb, va);
+  for (std::uint32_t i = 0; i < vec3xn::element_count; ++i)
+  {
+    CHECK(lane::get(dot, i) == Approx(vml::vec3a::dot(a[i], b[i])));
+    CHECK(lane::get(len, i) == Approx(vml::vec3a::length(b[i])));
+    CHECK(vml::vec3a::equals(vec3xn::get(cross, i), vml::vec3a::cross(a[i], b[i])));
+    CHECK(vml::vec3a::equals(vec3xn::get(norm, i), vml::vec3a::normalize(b[i])));
+    CHECK(vml::vec3a::equals(vec3xn::get(sum, i), vml::vec3a::add(a[i], b[i])));
+    CHECK(vml::vec3a::equals(vec3xn::get(diff, i), vml::vec3a::sub(a[i], b[i])));
+    CHECK(vml::vec3a::equals(vec3xn::get(mn, i), vml::vec3a::min(a[i], b[i])));
+    CHECK(vml::vec3a::equals(vec3xn::get(mx, i), vml::vec3a::max(a[i], b[i])));
+    CHECK(vml::vec3a::equals(vec3xn::get(madded, i), vml::vec3a::madd(a[i], b[i], a[i])));
+    CHECK(vml::vec3a::equals(vec3xn::get(lerp, i), vml::vec3a::lerp(a[i], b[i], 0.25f)));
+  }
+}